@@ -29,6 +29,15 @@ NAMESPACE_BEGIN(nanogui)
  * application. The implementation uses scissoring to ensure that rendered
  * objects don't spill into neighboring widgets.
  *
+ * By default, the canvas flushes the pending NanoVG commands before running
+ * its render pass, which splits the widgets into several batches. A
+ *  deferred canvas instead renders into a texture right away and draws it
+ * as a NanoVG image, so that the whole frame is submitted in one batch.
+ *
+ * A \a retained canvas that renders into a texture only runs its render
+ * pass when its content was marked as changed via \ref set_content_dirty()
+ * (or when it was resized), and otherwise reuses the previous image.
+ *
  * \rst
  * **Usage**
  *     Override :func:`nanogui::GLCanvas::draw_contents` in subclasses to provide
@@ -57,18 +66,46 @@ public:
      *
      * \param clear
      *     Should the widget clear its color/depth/stencil buffer?
+     *
+     * \param deferred
+     *     Render into a texture that NanoVG draws along with the other
+     *     widgets, instead of flushing NanoVG before the render pass?
      */
     Canvas(
         Widget *parent,
         uint8_t samples = 4,
         bool has_depth_buffer = true,
         bool has_stencil_buffer = false,
-        bool clear = true
+        bool clear = true,
+        bool deferred = false
     );
 
     /// Return the render pass associated with the canvas object
     RenderPass *render_pass() { return m_render_pass; }
 
+    /// Is the canvas drawn as a NanoVG image (without flushing NanoVG)?
+    bool deferred() const { return m_deferred; }
+
+    /**
+     * \brief Only re-render the contents when they were marked as changed?
+     *
+     * The output of \ref draw_contents() must then be invalidated via
+     * \ref set_content_dirty() whenever it changes, which the built-in
+     * subclasses (\ref ImageView, \ref ScatterPlot, \ref Spectrogram) do
+     * themselves. This has no effect on canvases that render directly into
+     * the screen framebuffer, whose contents do not persist across frames.
+     */
+    void set_retained(bool retained) { m_retained = retained; }
+
+    /// Return whether the contents are only re-rendered when marked as changed
+    bool retained() const { return m_retained; }
+
+    /// Mark the contents as changed, so that a retained canvas re-renders them
+    void set_content_dirty() { m_content_dirty = true; }
+
+    /// Will a retained canvas re-render its contents in the next frame?
+    bool content_dirty() const { return m_content_dirty; }
+
     /// Specify whether to draw the widget border
     void set_draw_border(const bool draw_border) {
         m_draw_border = draw_border;
@@ -99,12 +136,14 @@ public:
 
 protected:
     ref<RenderPass> m_render_pass;
-#if defined(NANOGUI_USE_METAL)
     ref<RenderPass> m_render_pass_resolved;
-#endif
     bool m_draw_border;
     Color m_border_color;
     bool m_render_to_texture;
+    bool m_deferred;
+    bool m_retained = false;
+    bool m_content_dirty = true;
+    Vector2i m_content_size = Vector2i(0);
 };
 
 NAMESPACE_END(nanogui)
@@ -140,6 +140,7 @@ enum class Cursor {
 /* Forward declarations */
 template <typename T> class ref;
 class AdvancedGridLayout;
+class AsyncTexture;
 class BoxLayout;
 class Button;
 class CheckBox;
@@ -148,9 +149,12 @@ class ColorWheel;
 class ColorPicker;
 class ComboBox;
 class GLFramebuffer;
+class GLState;
+class GPUTimer;
 class GLShader;
 class GridLayout;
 class GroupLayout;
+class Histogram;
 class ImagePanel;
 class ImageView;
 class Label;
@@ -161,17 +165,27 @@ class Popup;
 class PopupButton;
 class ProgressBar;
 class RenderPass;
+class ScatterPlot;
 class Shader;
 class Screen;
+class SDFFont;
+class SDFText;
 class Serializer;
 class Slider;
+class Spectrogram;
 class TabWidgetBase;
 class TabWidget;
 class TextBox;
 class TextArea;
 class Texture;
+class TextureDownload;
+class TextureLoader;
+class TextureStream;
+class TileCache;
+class TileSource;
 class Theme;
 class ToolButton;
+class UniformRing;
 class VScrollPanel;
 class Widget;
 class Window;
@@ -304,7 +318,16 @@ extern NANOGUI_EXPORT void chdir_to_bundle_parent();
  */
 extern NANOGUI_EXPORT std::string utf8(uint32_t c);
 
-/// Load a directory of PNG images and upload them to the GPU (suitable for use with ImagePanel)
+/// Return the full paths of the PNG images in a directory
+extern NANOGUI_EXPORT std::vector<std::string> image_directory_files(const std::string &path);
+
+/**
+ * \brief Load a directory of PNG images and upload them to the GPU (suitable
+ * for use with ImagePanel)
+ *
+ * The images are decoded on the calling thread. See
+ * \ref TextureLoader::load_image_directory() for an asynchronous version.
+ */
 extern NANOGUI_EXPORT std::vector<std::pair<int, std::string>>
     load_image_directory(NVGcontext *ctx, const std::string &path);
 
@@ -0,0 +1,194 @@
+/*
+    nanogui/glstate.h -- Client-side cache of the OpenGL state that is
+    modified by render passes, shaders, and textures
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/vector.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+/**
+ * \class GLState glstate.h nanogui/glstate.h
+ *
+ * \brief Shadow copy of the OpenGL state that NanoGUI modifies
+ *
+ * \ref RenderPass, \ref Shader, \ref Texture, and \ref Screen route their
+ * state changes through this class, which skips calls that would not change
+ * anything, and which never queries the driver. Values that are unknown
+ * (after \ref invalidate()) are always sent to OpenGL.
+ *
+ * A single tracker is shared by all contexts. Screens invalidate it when
+ * they make their context current and after NanoVG has rendered, since
+ * NanoVG changes the state directly. Code that changes the tracked state via
+ * raw OpenGL calls (e.g. in \ref Canvas::draw_contents()) must do the same.
+ */
+class NANOGUI_EXPORT GLState {
+public:
+    /// Fixed-function state that a \ref RenderPass saves and restores
+    struct State {
+        enum Field : uint32_t {
+            Viewport       = 1 << 0,
+            Scissor        = 1 << 1,
+            DepthTest      = 1 << 2,
+            DepthFunc      = 1 << 3,
+            DepthMask      = 1 << 4,
+            ScissorTest    = 1 << 5,
+            CullFace       = 1 << 6,
+            CullFaceMode   = 1 << 7,
+            Blend          = 1 << 8,
+            BlendFunc      = 1 << 9,
+            ProgramPointSize = 1 << 10
+        };
+
+        Vector4i viewport = Vector4i(0);
+        Vector4i scissor = Vector4i(0);
+        uint32_t depth_func = 0;
+        uint32_t cull_face_mode = 0;
+        uint32_t blend_src = 0, blend_dst = 0;
+        bool depth_test = false;
+        bool depth_mask = false;
+        bool scissor_test = false;
+        bool cull_face = false;
+        bool blend = false;
+        bool program_point_size = false;
+
+        /// Bit mask of the fields whose value is known
+        uint32_t valid = 0;
+    };
+
+    /// Return the tracker
+    static GLState &current();
+
+    /// Forget all cached values, so that the next change of each is sent to OpenGL
+    void invalidate();
+
+    /// Forget the active texture unit and texture bindings only
+    void invalidate_textures();
+
+    /// Set the viewport (x, y, width, height)
+    void set_viewport(const Vector4i &viewport);
+    /// Set the scissor box (x, y, width, height)
+    void set_scissor(const Vector4i &scissor);
+    /// Enable or disable \c GL_DEPTH_TEST
+    void set_depth_test(bool enabled);
+    /// Set the depth comparison function (e.g. \c GL_LESS)
+    void set_depth_func(uint32_t func);
+    /// Enable or disable writes to the depth buffer
+    void set_depth_mask(bool enabled);
+    /// Enable or disable \c GL_SCISSOR_TEST
+    void set_scissor_test(bool enabled);
+    /// Enable or disable \c GL_CULL_FACE
+    void set_cull_face(bool enabled);
+    /// Set the faces that are culled (\c GL_FRONT or \c GL_BACK)
+    void set_cull_face_mode(uint32_t mode);
+    /// Enable or disable \c GL_BLEND
+    void set_blend(bool enabled);
+    /// Set the blend factors
+    void set_blend_func(uint32_t src, uint32_t dst);
+#if defined(NANOGUI_USE_OPENGL)
+    /// Enable or disable \c GL_PROGRAM_POINT_SIZE
+    void set_program_point_size(bool enabled);
+#endif
+
+    /// Return the fixed-function state
+    const State &state() const { return m_state; }
+
+    /// Restore the known fields of a state returned by \ref state()
+    void restore(const State &state);
+
+    /// Bind a program
+    void use_program(uint32_t program);
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /// Bind a vertex array object
+    void bind_vertex_array(uint32_t vertex_array);
+#endif
+
+    /**
+     * \brief Bind a framebuffer to \c GL_FRAMEBUFFER (i.e. for reading and
+     * drawing), \c GL_READ_FRAMEBUFFER, or \c GL_DRAW_FRAMEBUFFER
+     */
+    void bind_framebuffer(uint32_t target, uint32_t framebuffer);
+
+    /// Return the framebuffer that is bound for drawing (0 if unknown)
+    uint32_t framebuffer() const { return m_draw_framebuffer.valid ? m_draw_framebuffer.value : 0; }
+
+    /// Make \c unit the active texture unit and bind a texture to it
+    void bind_texture(uint32_t unit, uint32_t target, uint32_t texture);
+
+    /* Deleting an object reverts the bindings that refer to it to zero */
+    /// Must be called when a texture is deleted
+    void texture_deleted(uint32_t texture);
+    /// Must be called when a program is deleted
+    void program_deleted(uint32_t program);
+    /// Must be called when a framebuffer is deleted
+    void framebuffer_deleted(uint32_t framebuffer);
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /// Must be called when a vertex array object is deleted
+    void vertex_array_deleted(uint32_t vertex_array);
+#endif
+
+    /// Return the number of calls that were skipped because they would not have changed the state
+    size_t redundant_calls() const { return m_redundant_calls; }
+
+    /// Reset the counter of skipped calls
+    void reset_redundant_calls() { m_redundant_calls = 0; }
+
+protected:
+    GLState() = default;
+    GLState(const GLState &) = delete;
+    GLState &operator=(const GLState &) = delete;
+
+    /// Return \c true if the field must be updated (counting skipped calls)
+    template <typename T> bool update(T &field, const T &value, uint32_t flag) {
+        if ((m_state.valid & flag) && field == value) {
+            m_redundant_calls++;
+            return false;
+        }
+        field = value;
+        m_state.valid |= flag;
+        return true;
+    }
+
+    struct Binding {
+        uint32_t value = 0;
+        bool valid = false;
+    };
+
+    /// Return \c true if the binding must be updated (counting skipped calls)
+    bool update(Binding &binding, uint32_t value) {
+        if (binding.valid && binding.value == value) {
+            m_redundant_calls++;
+            return false;
+        }
+        binding.value = value;
+        binding.valid = true;
+        return true;
+    }
+
+    static const uint32_t TextureUnits = 32;
+
+protected:
+    State m_state;
+    Binding m_program;
+    Binding m_vertex_array;
+    Binding m_read_framebuffer;
+    Binding m_draw_framebuffer;
+    Binding m_active_texture;
+    Binding m_textures[TextureUnits];
+    size_t m_redundant_calls = 0;
+};
+#endif
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,92 @@
+/*
+    nanogui/gputimer.h -- Asynchronous measurement of the GPU time spent
+    by render passes and NanoVG
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class GPUTimer gputimer.h nanogui/gputimer.h
+ *
+ * \brief Measures the GPU time of intervals of rendering commands
+ *
+ * On OpenGL, each interval between \ref begin() and \ref end() is measured
+ * with a \c GL_TIME_ELAPSED query. The results become available a few frames
+ * later and are collected without stalling by subsequent calls to
+ * \ref begin() or \ref collect(). Intervals of different timers cannot be
+ * nested; the inner one is not measured. Timer queries require OpenGL 3.3 (or
+ * \c ARB_timer_query), or GLES 3 with \c EXT_disjoint_timer_query.
+ *
+ * On Metal, \ref begin() and \ref end() do nothing. Render passes instead
+ * report the execution time of their command buffers via \ref add_sample().
+ */
+class NANOGUI_EXPORT GPUTimer : public Object {
+public:
+    /// Statistics of the measured intervals (in milliseconds)
+    struct Stats {
+        /// Most recent measurement
+        double last = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        /// Number of measurements
+        size_t samples = 0;
+    };
+
+    /// Create a timer
+    GPUTimer();
+
+    /// Can GPU time be measured with the current context?
+    static bool supported();
+
+    /// Start measuring an interval
+    void begin();
+
+    /// Stop measuring an interval
+    void end();
+
+    /// Collect the results that have become available (never blocks)
+    void collect();
+
+    /// Record a measurement in milliseconds (may be called from any thread)
+    void add_sample(double milliseconds);
+
+    /// Return the statistics of the measurements collected so far
+    Stats stats() const;
+
+    /// Discard all measurements
+    void reset();
+
+protected:
+    /// Release the queries
+    virtual ~GPUTimer();
+
+    /// Maximum number of intervals whose results are outstanding
+    static const size_t MaxPending = 8;
+
+protected:
+    mutable std::mutex m_mutex;
+    Stats m_stats;
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    std::vector<uint32_t> m_free;
+    std::deque<uint32_t> m_pending;
+    uint32_t m_query = 0;
+#endif
+};
+
+NAMESPACE_END(nanogui)
@@ -13,16 +13,196 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <atomic>
+#include <memory>
 
 NAMESPACE_BEGIN(nanogui)
 
+/**
+ * \class TimeSeries graph.h nanogui/graph.h
+ *
+ * \brief Fixed-capacity ring buffer of samples with a min/max pyramid
+ *
+ * Besides the raw samples, the ring buffer maintains the minimum and maximum
+ * over aligned blocks of 4, 16, 64, ... samples, which are updated
+ * incrementally as samples are pushed. This makes it possible to compute
+ * the value range of an arbitrary interval in logarithmic time, and to
+ * decimate the series for display at a cost that only depends on the number
+ * of output points---not on the number of stored samples.
+ *
+ * Samples are addressed using absolute indices that count all samples ever
+ * pushed. Only the last \ref capacity() of them are retained.
+ */
+class NANOGUI_EXPORT TimeSeries {
+public:
+    /// Decimation strategy used to reduce a series to the available screen space
+    enum class Decimation {
+        /// Preserve the minimum and maximum within each pixel column (exact envelope)
+        MinMax,
+        /// Largest-Triangle-Three-Buckets: picks visually representative samples
+        LTTB
+    };
+
+    /// Create a ring buffer holding up to \c capacity samples
+    TimeSeries(size_t capacity = 0);
+
+    /// Return the maximum number of retained samples
+    size_t capacity() const { return m_capacity; }
+
+    /// Change the maximum number of retained samples (discards the contents)
+    void set_capacity(size_t capacity);
+
+    /// Return the number of currently retained samples
+    size_t size() const { return (size_t) std::min<uint64_t>(m_total, m_capacity); }
+
+    /// Return the total number of samples pushed since the last \ref clear()
+    uint64_t total() const { return m_total; }
+
+    /// Return the absolute index of the oldest retained sample
+    uint64_t first() const { return m_total - size(); }
+
+    /// Remove all samples
+    void clear();
+
+    /// Append a sample (evicting the oldest one if the buffer is full)
+    void push(float value);
+
+    /// Append several samples
+    void push(const float *values, size_t count);
+
+    /// Return the retained sample with the given absolute index
+    float at(uint64_t index) const { return m_samples[index % m_capacity]; }
+
+    /// Return the \c i-th retained sample, where 0 refers to the oldest one
+    float operator[](size_t i) const { return at(first() + i); }
+
+    /// Return the ring storage, where the sample with absolute index \c i is at <tt>i % capacity()</tt>
+    const float *data() const { return m_samples.data(); }
+
+    /**
+     * \brief Compute the minimum and maximum over the absolute index range
+     * <tt>[begin, end)</tt>, which must lie within the retained samples
+     */
+    void min_max(uint64_t begin, uint64_t end, float &min, float &max) const;
+
+    /**
+     * \brief Reduce the retained samples to at most <tt>2 * columns</tt> points
+     *
+     * The X coordinates of the resulting points are normalized so that the
+     * oldest and newest samples map to 0 and 1, respectively. The output is
+     * the series itself when it is already short enough.
+     */
+    void decimate(size_t columns, Decimation decimation,
+                  std::vector<Vector2f> &out) const;
+
+protected:
+    struct Range { float min, max; };
+
+    size_t m_capacity = 0;
+    uint64_t m_total = 0;
+    std::vector<float> m_samples;
+    /// Pyramid level 'l' (starting at 1) stores ranges of aligned blocks of 4^l samples
+    std::vector<std::vector<Range>> m_levels;
+};
+
+/**
+ * \class SampleChannel graph.h nanogui/graph.h
+ *
+ * \brief Lock-free single-producer/single-consumer queue of samples
+ *
+ * Allows an acquisition thread to feed a \ref Graph without locks, memory
+ * allocation, or calls to \ref async(). The producer thread calls
+ * \ref push(), and the graph drains the channel once per frame (see
+ * \ref Graph::set_channel()). Samples that do not fit into the queue are
+ * dropped and counted (see \ref dropped()).
+ *
+ * To avoid waking up the UI thread for every sample, only the first push
+ * after each drain requests a redraw of the associated screen.
+ */
+class NANOGUI_EXPORT SampleChannel : public Object {
+public:
+    /// Create a queue holding up to \c capacity samples (rounded up to a power of two)
+    SampleChannel(size_t capacity = 1 << 16);
+
+    /// Return the maximum number of queued samples
+    size_t capacity() const { return m_mask + 1; }
+
+    /// Return the number of queued samples (approximate if called concurrently)
+    size_t size() const {
+        return (size_t) (m_head.load(std::memory_order_acquire) -
+                         m_tail.load(std::memory_order_acquire));
+    }
+
+    /// Return the number of samples that were dropped because the queue was full
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Append samples to the queue (producer thread only)
+     *
+     * Returns the number of samples that were queued, which is less than
+     * \c count if the queue is full.
+     */
+    size_t push(const float *values, size_t count);
+
+    /// Append a single sample (producer thread only)
+    bool push(float value) { return push(&value, 1) == 1; }
+
+    /// Remove up to \c count samples from the queue (consumer thread only)
+    size_t pop(float *values, size_t count);
+
+    /**
+     * \brief Request that the next push calls \ref Screen::redraw() on the
+     * given screen (consumer thread only)
+     *
+     * Should be called before draining the queue, so that samples which
+     * arrive in the meantime are guaranteed to trigger another redraw.
+     * Specify \c nullptr to disable notifications. The request is posted
+     * via \ref Screen::redraw_async(), so it is harmless if the screen has
+     * been destroyed in the meantime.
+     */
+    void request_notification(Screen *screen) {
+        m_screen.store(screen, std::memory_order_relaxed);
+        m_armed.store(screen != nullptr, std::memory_order_release);
+    }
+
+protected:
+    /// Release all resources
+    virtual ~SampleChannel() = default;
+
+protected:
+    std::unique_ptr<float[]> m_samples;
+    size_t m_mask;
+
+    /* Producer and consumer state are kept on separate cache lines */
+    alignas(64) std::atomic<uint64_t> m_head { 0 };
+    uint64_t m_tail_cached = 0;
+    std::atomic<uint64_t> m_dropped { 0 };
+    std::atomic<bool> m_armed { false };
+    std::atomic<Screen *> m_screen { nullptr };
+
+    alignas(64) std::atomic<uint64_t> m_tail { 0 };
+    uint64_t m_head_cached = 0;
+};
+
 /**
  * \class Graph graph.h nanogui/graph.h
  *
  * \brief Simple graph widget for showing a function plot.
+ *
+ * The plotted values (which should lie in the interval [0, 1]) either come
+ * from a plain array (\ref values()) or, when a stream capacity has been
+ * set, from a \ref TimeSeries ring buffer that is fed incrementally via
+ * \ref push_sample() or a \ref SampleChannel. In both cases, long series
+ * are decimated to at most two vertices per horizontal pixel before drawing.
+ *
+ * In streaming mode, the curve can optionally be rendered by the GPU (see
+ * \ref set_gpu_rendering()), in which case the per-frame CPU cost no longer
+ * depends on the number of samples.
  */
 class NANOGUI_EXPORT Graph : public Widget {
 public:
+    using Decimation = TimeSeries::Decimation;
+
     Graph(Widget *parent, const std::string &caption = "Untitled");
 
     const std::string &caption() const { return m_caption; }
@@ -50,12 +230,162 @@ public:
     std::vector<float> &values() { return m_values; }
     void set_values(const std::vector<float> &values) { m_values = values; }
 
+    /**
+     * \brief Add a series that is drawn on top of the main one, sharing its
+     * background, value range and labels
+     *
+     * The samples are not copied: \c data must remain valid while the graph
+     * exists (or until it is replaced via \ref set_series_data()), and it is
+     * re-read whenever the graph is drawn. The \c stride (in elements)
+     * allows plotting e.g. one channel of an interleaved buffer. Each series
+     * spans the full width of the graph. Returns the index of the new series.
+     */
+    size_t add_series(const float *data, size_t size, ptrdiff_t stride = 1,
+                      const Color &stroke_color = Color(100, 255),
+                      const Color &fill_color = Color(0, 0));
+
+    /// Point an existing series to different sample storage
+    void set_series_data(size_t index, const float *data, size_t size,
+                         ptrdiff_t stride = 1);
+
+    /// Return the number of series added via \ref add_series()
+    size_t series_count() const { return m_series.size(); }
+
+    /// Remove all series added via \ref add_series()
+    void clear_series() { m_series.clear(); }
+
+    bool series_visible(size_t index) const { return m_series.at(index).visible; }
+    void set_series_visible(size_t index, bool visible) { m_series.at(index).visible = visible; }
+
+    const Color &series_stroke_color(size_t index) const { return m_series.at(index).stroke_color; }
+    void set_series_stroke_color(size_t index, const Color &color) { m_series.at(index).stroke_color = color; }
+
+    const Color &series_fill_color(size_t index) const { return m_series.at(index).fill_color; }
+    void set_series_fill_color(size_t index, const Color &color) { m_series.at(index).fill_color = color; }
+
+    /// Return the decimation strategy used for long series
+    Decimation decimation() const { return m_decimation; }
+    /// Set the decimation strategy used for long series
+    void set_decimation(Decimation decimation) {
+        m_decimation = decimation;
+        m_stream_dirty = true;
+    }
+
+    /**
+     * \brief Switch to streaming mode with a ring buffer of the given capacity
+     *
+     * In streaming mode, the graph shows the most recent \c capacity samples
+     * pushed via \ref push_sample() / \ref push_samples() instead of
+     * \ref values(). Specify zero to return to the array-based mode.
+     * Discards previously streamed samples.
+     */
+    void set_stream_capacity(size_t capacity) {
+        m_stream.set_capacity(capacity);
+        m_stream_dirty = true;
+        m_gpu_reset = true;
+    }
+    /// Return the capacity of the streaming ring buffer (zero if not streaming)
+    size_t stream_capacity() const { return m_stream.capacity(); }
+
+    /// Return the underlying ring buffer used in streaming mode
+    const TimeSeries &stream() const { return m_stream; }
+
+    /// Append a sample to the stream (requires \ref set_stream_capacity())
+    void push_sample(float value) { push_samples(&value, 1); }
+    /// Append several samples to the stream (requires \ref set_stream_capacity())
+    void push_samples(const float *values, size_t count);
+    /// Remove all streamed samples
+    void clear_stream() {
+        m_stream.clear();
+        m_stream_dirty = true;
+        m_gpu_reset = true;
+    }
+
+    /// Return the channel that is drained into the stream (if any)
+    SampleChannel *channel() { return m_channel; }
+
+    /**
+     * \brief Attach a channel that feeds the stream from another thread
+     *
+     * Queued samples are appended to the stream once per frame, before the
+     * graph is drawn, and pushing to an idle channel requests a redraw of
+     * the screen. Requires \ref set_stream_capacity(). Specify \c nullptr
+     * to detach the current channel.
+     */
+    void set_channel(SampleChannel *channel);
+
+    /// Is the stream rendered using a shader instead of NanoVG?
+    bool gpu_rendering() const { return m_gpu_rendering; }
+
+    /**
+     * \brief Render the stream using a shader instead of NanoVG
+     *
+     * Rather than building a NanoVG path with one vertex per (decimated)
+     * sample in every frame, new samples are appended to a texture holding
+     * one value per ring slot, and the vertex shader draws one quad per
+     * pixel column spanning the minimum and maximum of the curve within
+     * it. The CPU cost per frame is then proportional to the number of
+     * samples pushed since the previous frame, and the geometry to the
+     * widget width. GPU memory amounts to 4 bytes per sample of capacity.
+     *
+     * Only has an effect in streaming mode (\ref set_stream_capacity()).
+     * Not supported on OpenGL ES 2, where NanoVG is always used.
+     */
+    void set_gpu_rendering(bool gpu_rendering) { m_gpu_rendering = gpu_rendering; }
+
     virtual Vector2i preferred_size(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext *ctx) override;
+protected:
+    /// Detaches the channel (if any)
+    virtual ~Graph();
+
+    /// Compute the (decimated) polyline in normalized coordinates
+    const std::vector<Vector2f> &plot_points(size_t columns);
+
+    /**
+     * \brief Stroke and fill a polyline in normalized coordinates, whose X
+     * range <tt>[0, 1]</tt> maps to the horizontal interval starting at \c x0
+     */
+    void draw_polyline(NVGcontext *ctx, const std::vector<Vector2f> &points, float x0,
+                       const Color &stroke_color, const Color &fill_color);
+
+    /// Append the contents of \ref m_channel to the stream
+    void drain_channel();
+
+    /// Draw the stream using \ref m_shader (see \ref set_gpu_rendering())
+    void draw_stream_gpu(NVGcontext *ctx);
+
 protected:
     std::string m_caption, m_header, m_footer;
     Color m_background_color, m_fill_color, m_stroke_color, m_text_color;
     std::vector<float> m_values;
+
+    /// Additional series referencing external (strided) sample storage
+    struct Series {
+        const float *data;
+        size_t size;
+        ptrdiff_t stride;
+        Color stroke_color, fill_color;
+        bool visible;
+    };
+    std::vector<Series> m_series;
+    std::vector<Vector2f> m_series_points;
+
+    TimeSeries m_stream;
+    Decimation m_decimation = Decimation::MinMax;
+    std::vector<Vector2f> m_points;
+    size_t m_points_columns = 0;
+    bool m_stream_dirty = true;
+    ref<SampleChannel> m_channel;
+
+    /* GPU rendering state: a copy of the ring buffer in a texture, and the
+       absolute index up to which samples have been uploaded */
+    bool m_gpu_rendering = false;
+    bool m_gpu_reset = true;
+    uint64_t m_gpu_uploaded = 0;
+    ref<RenderPass> m_render_pass;
+    ref<Shader> m_shader;
+    ref<Texture> m_gpu_samples;
 };
 
 NAMESPACE_END(nanogui)
@@ -0,0 +1,116 @@
+/*
+    nanogui/histogram.h -- Histogram widget that bins large arrays of
+    samples directly
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Histogram histogram.h nanogui/histogram.h
+ *
+ * \brief Bar chart of the distribution of a (potentially very large) array
+ * of samples.
+ *
+ * The samples are not copied: the widget references the array passed to
+ * \ref set_data() and bins it when it is next drawn. Large arrays are split
+ * into chunks that are binned by several threads into private histograms,
+ * which are merged afterwards. When \ref set_data() is called again with the
+ * same pointer and a larger size (i.e. samples were appended), only the new
+ * samples are binned.
+ *
+ * Samples are mapped to \ref bin_count() equally sized bins covering
+ * \ref range(). Samples outside of the range (and NaNs) are not shown, but
+ * counted by \ref outlier_count().
+ */
+class NANOGUI_EXPORT Histogram : public Widget {
+public:
+    Histogram(Widget *parent, const std::string &caption = "Untitled");
+
+    const std::string &caption() const { return m_caption; }
+    void set_caption(const std::string &caption) { m_caption = caption; }
+
+    const Color &background_color() const { return m_background_color; }
+    void set_background_color(const Color &background_color) { m_background_color = background_color; }
+
+    const Color &bar_color() const { return m_bar_color; }
+    void set_bar_color(const Color &bar_color) { m_bar_color = bar_color; }
+
+    const Color &text_color() const { return m_text_color; }
+    void set_text_color(const Color &text_color) { m_text_color = text_color; }
+
+    /**
+     * \brief Set the binned samples
+     *
+     * \c data must remain valid until it is replaced or the widget is
+     * destroyed. If \c data equals the current pointer and \c size is at
+     * least as large as the current size, the existing counts are kept and
+     * only the samples at index <tt>size()</tt> and above are binned later
+     * on. Call \ref invalidate() when previously binned samples were
+     * modified in place.
+     */
+    void set_data(const float *data, size_t size);
+
+    /// Return the binned samples
+    const float *data() const { return m_data; }
+
+    /// Return the number of binned samples
+    size_t size() const { return m_size_data; }
+
+    /// Discard the counts, so that all samples are binned again
+    void invalidate() { m_binned = 0; }
+
+    /// Return the number of bins
+    size_t bin_count() const { return m_bin_count; }
+    /// Set the number of bins (triggers a full re-binning)
+    void set_bin_count(size_t bin_count);
+
+    /// Return the range of values covered by the bins
+    std::pair<float, float> range() const { return { m_range_min, m_range_max }; }
+    /// Set the range of values covered by the bins (triggers a full re-binning)
+    void set_range(float min, float max);
+
+    /// Return the maximum number of threads used for binning (0: automatic)
+    size_t thread_count() const { return m_thread_count; }
+    /// Set the maximum number of threads used for binning (0: automatic)
+    void set_thread_count(size_t thread_count) { m_thread_count = thread_count; }
+
+    /// Bring the counts up to date with the data (called automatically by \ref draw())
+    void update();
+
+    /// Return the number of samples per bin (call \ref update() first)
+    const std::vector<uint64_t> &counts() const { return m_counts; }
+
+    /// Return the number of samples outside of the range (call \ref update() first)
+    uint64_t outlier_count() const { return m_outliers; }
+
+    virtual Vector2i preferred_size(NVGcontext *ctx) const override;
+    virtual void draw(NVGcontext *ctx) override;
+
+protected:
+    std::string m_caption;
+    Color m_background_color, m_bar_color, m_text_color;
+
+    const float *m_data = nullptr;
+    size_t m_size_data = 0;
+    size_t m_binned = 0;
+    size_t m_bin_count = 64;
+    size_t m_thread_count = 0;
+    float m_range_min = 0.f, m_range_max = 1.f;
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_outliers = 0;
+};
+
+NAMESPACE_END(nanogui)
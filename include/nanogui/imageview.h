@@ -13,6 +13,7 @@
 #pragma once
 
 #include <nanogui/canvas.h>
+#include <nanogui/sdftext.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -21,6 +22,11 @@ NAMESPACE_BEGIN(nanogui)
  *
  * \brief A widget for displaying, panning, and zooming images. Numerical RGBA
  * pixel information is shown at large magnifications.
+ *
+ * Since the size of these pixel labels grows with the magnification, they are
+ * rendered using signed distance field text (\ref SDFText) by default, which
+ * avoids rasterizing a new set of glyphs into the NanoVG font atlas at every
+ * zoom level.
  */
 class NANOGUI_EXPORT ImageView : public Canvas {
 public:
@@ -36,6 +42,33 @@ public:
     /// Set the currently active image
     void set_image(Texture *image);
 
+    /// Return the stream that feeds the image (if any)
+    TextureStream *stream() { return m_stream; }
+    /**
+     * \brief Display frames from a \ref TextureStream
+     *
+     * Sets the image to the stream's texture, and copies the newest
+     * committed frame into it whenever the widget is drawn. Committing a
+     * frame triggers a redraw.
+     */
+    void set_stream(TextureStream *stream);
+
+    /// Return the cache that provides the tiles of the image (if any)
+    TileCache *tile_cache() { return m_tile_cache; }
+    /**
+     * \brief Display a tiled multi-resolution image
+     *
+     * Replaces the current image. At every frame, only the tiles of the
+     * pyramid level matching the current magnification that overlap the
+     * widget are drawn (and requested from the cache). Tiles that are still
+     * being decoded are substituted by the closest coarser tile that is
+     * resident.
+     */
+    void set_tile_cache(TileCache *tile_cache);
+
+    /// Return the size of the image in pixels (zero if there is no image)
+    Vector2i image_size() const;
+
     /// Center the image on the screen
     void center();
 
@@ -45,6 +78,7 @@ public:
     /// Set the callback that is used to acquire information about pixel components
     void set_pixel_callback(const PixelCallback &pixel_callback) {
         m_pixel_callback = pixel_callback;
+        set_content_dirty();
     }
     /// Return the callback that is used to acquire information about pixel components
     const PixelCallback &pixel_callback() const { return m_pixel_callback; }
@@ -52,13 +86,24 @@ public:
     /// Return the pixel offset of the zoomed image rectangle
     Vector2f offset() const { return m_offset; }
     /// Set the pixel offset of the zoomed image rectangle
-    void set_offset(const Vector2f &offset) { m_offset = offset; }
+    void set_offset(const Vector2f &offset) {
+        m_offset = offset;
+        set_content_dirty();
+    }
 
     /// Return the current magnification of the image
     float scale() const;
     /// Set the current magnification of the image
     void set_scale(float scale);
 
+    /// Specify whether pixel labels are drawn using signed distance field text (instead of NanoVG)
+    void set_sdf_text(bool sdf_text) {
+        m_sdf_text = sdf_text;
+        set_content_dirty();
+    }
+    /// Return whether pixel labels are drawn using signed distance field text
+    bool sdf_text() const { return m_sdf_text; }
+
     /// Convert a position within the widget to a pixel position in the image
     Vector2f pos_to_pixel(const Vector2f &p) const;
     /// Convert a pixel position in the image to a position within the widget
@@ -71,15 +116,26 @@ public:
     virtual void draw(NVGcontext *ctx) override;
     virtual void draw_contents() override;
 
+protected:
+    /// Detaches the stream and tile cache (if any)
+    virtual ~ImageView();
+
+    /// Draw the visible tiles of the tile cache
+    void draw_tiles(const Matrix4f &projection, float scale);
+
 protected:
     nanogui::ref<Shader> m_image_shader;
     nanogui::ref<Texture> m_image;
+    nanogui::ref<TextureStream> m_stream;
+    nanogui::ref<TileCache> m_tile_cache;
     float m_scale = 0;
     Vector2f m_offset = 0;
     bool m_draw_image_border;
     Color m_image_border_color;
     Color m_image_background_color;
     PixelCallback m_pixel_callback;
+    bool m_sdf_text = true;
+    nanogui::ref<SDFText> m_label_text;
 };
 
 NAMESPACE_END(nanogui)
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <nanogui/common.h>
+#include <nanogui/resources.h>
 #include <nanogui/metal.h>
 #include <nanogui/widget.h>
 #include <nanogui/screen.h>
@@ -35,10 +36,18 @@
 #include <nanogui/vscrollpanel.h>
 #include <nanogui/colorwheel.h>
 #include <nanogui/graph.h>
+#include <nanogui/histogram.h>
 #include <nanogui/formhelper.h>
 #include <nanogui/tabwidget.h>
 #include <nanogui/texture.h>
+#include <nanogui/textureloader.h>
+#include <nanogui/tilecache.h>
 #include <nanogui/shader.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
 #include <nanogui/renderpass.h>
 #include <nanogui/canvas.h>
 #include <nanogui/imageview.h>
+#include <nanogui/spectrogram.h>
+#include <nanogui/scatterplot.h>
+#include <nanogui/sdftext.h>
@@ -18,6 +18,8 @@
 
 #include <nanogui/object.h>
 #include <nanogui/vector.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
 #include <unordered_map>
 
 NAMESPACE_BEGIN(nanogui)
@@ -133,6 +135,22 @@ public:
     /// Return the culling mode associated with the render pass
     CullMode cull_mode() const { return m_cull_mode; }
 
+    /**
+     * \brief Measure the GPU time of each execution of the render pass
+     * (including the blit that \ref end() performs, if any)
+     *
+     * The results are available a few frames later via \ref gpu_timer().
+     */
+    void set_gpu_timing(bool enabled) {
+        if (!enabled)
+            m_gpu_timer = nullptr;
+        else if (!m_gpu_timer)
+            m_gpu_timer = new GPUTimer();
+    }
+
+    /// Return the timer of the render pass (\c nullptr if timing is disabled)
+    GPUTimer *gpu_timer() { return m_gpu_timer; }
+
     /**
      * \brief Return the set of all render targets (including depth + stencil)
      * associated with this render pass
@@ -176,15 +194,11 @@ protected:
     bool m_depth_write;
     CullMode m_cull_mode;
     ref<Object> m_blit_target;
+    ref<GPUTimer> m_gpu_timer;
     bool m_active;
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     uint32_t m_framebuffer_handle;
-    int m_viewport_backup[4], m_scissor_backup[4];
-    bool m_depth_test_backup;
-    bool m_depth_write_backup;
-    bool m_scissor_test_backup;
-    bool m_cull_face_backup;
-    bool m_blend_backup;
+    GLState::State m_state_backup;
 #elif defined(NANOGUI_USE_METAL)
     void *m_command_buffer;
     void *m_command_encoder;
@@ -0,0 +1,46 @@
+/*
+    nanogui/resources.h -- Access to files embedded into the library
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/**
+ * \file nanogui/resources.h
+ *
+ * \brief Lookup of fonts, shaders, and other files that were embedded into
+ * the NanoGUI library at build time (see ``resources/bundle.cmake``).
+ */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <string_view>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \brief Return the contents of a resource that was embedded into NanoGUI
+ *
+ * Resources are identified by their original file name, e.g.
+ * ``"Roboto-Regular.ttf"`` or ``"imageview_vertex.gl"``. When the library
+ * was built with ``NANOGUI_COMPRESS_RESOURCES``, a resource is inflated on
+ * first access and cached for the remainder of the program's lifetime.
+ * The returned view therefore never dangles, and the data is always
+ * followed by a terminating zero byte (not included in the view's size).
+ *
+ * This function is thread-safe. It throws ``std::runtime_error`` when no
+ * resource of the given name exists.
+ */
+extern NANOGUI_EXPORT std::string_view resource(std::string_view name);
+
+/// Return the names of all embedded resources in lexicographic order
+extern NANOGUI_EXPORT std::vector<std::string> resource_names();
+
+/// Copy a resource embedded into the library (see \ref resource()) into a string
+#define NANOGUI_RESOURCE_STRING(name) std::string(nanogui::resource(name))
+
+NAMESPACE_END(nanogui)
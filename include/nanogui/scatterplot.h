@@ -0,0 +1,140 @@
+/*
+    nanogui/scatterplot.h -- Widget for interactively exploring large
+    two-dimensional point sets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/canvas.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ScatterPlot scatterplot.h nanogui/scatterplot.h
+ *
+ * \brief Scatter plot that scales to millions of points
+ *
+ * Positions and colors are uploaded to the GPU once (in \ref set_points())
+ * and rendered as point primitives, so panning (dragging) and zooming (mouse
+ * wheel) only change a pair of shader uniforms. A uniform grid over the
+ * point positions is built on the CPU to find the point underneath the
+ * mouse cursor, which is highlighted and reported via the hover callback.
+ */
+class NANOGUI_EXPORT ScatterPlot : public Canvas {
+public:
+    /// Initialize the widget
+    ScatterPlot(Widget *parent);
+
+    /**
+     * \brief Set the plotted points
+     *
+     * \param positions
+     *     Array of <tt>2 * count</tt> values with interleaved X and Y
+     *     coordinates (in arbitrary units)
+     *
+     * \param count
+     *     Number of points
+     *
+     * \param colors
+     *     Optional array of <tt>4 * count</tt> RGBA values in <tt>[0, 1]</tt>
+     *     with per-point colors, which are multiplied by \ref point_color()
+     *
+     * Also resets the view so that it encloses all points. Neither array is
+     * referenced after this call, but a CPU copy of the positions is kept
+     * for picking.
+     */
+    void set_points(const float *positions, size_t count,
+                    const float *colors = nullptr);
+
+    /// Return the number of plotted points
+    size_t point_count() const { return m_positions.size() / 2; }
+
+    /// Return the position of the point with the given index
+    Vector2f point(size_t index) const {
+        return Vector2f(m_positions[2 * index], m_positions[2 * index + 1]);
+    }
+
+    /// Return the diameter of the points in (logical) pixels
+    float point_size() const { return m_point_size; }
+    /// Set the diameter of the points in (logical) pixels
+    void set_point_size(float point_size) {
+        m_point_size = point_size;
+        set_content_dirty();
+    }
+
+    /// Return the color that all points are multiplied by
+    const Color &point_color() const { return m_point_color; }
+    /// Set the color that all points are multiplied by
+    void set_point_color(const Color &point_color) {
+        m_point_color = point_color;
+        set_content_dirty();
+    }
+
+    /// Return the lower left corner of the visible region
+    const Vector2f &view_min() const { return m_view_min; }
+    /// Return the upper right corner of the visible region
+    const Vector2f &view_max() const { return m_view_max; }
+    /// Set the visible region
+    void set_view(const Vector2f &view_min, const Vector2f &view_max);
+    /// Fit the visible region to the bounding box of the points
+    void reset_view();
+
+    /// Convert a position relative to the widget into plot coordinates
+    Vector2f pos_to_point(const Vector2f &pos) const;
+    /// Convert plot coordinates into a position relative to the widget
+    Vector2f point_to_pos(const Vector2f &point) const;
+
+    /**
+     * \brief Return the index of the point closest to a position relative to
+     * the widget, or -1 if there is no point within \c radius pixels
+     */
+    int pick(const Vector2f &pos, float radius) const;
+
+    /// Return the index of the point underneath the mouse cursor (or -1)
+    int hovered_point() const { return m_hovered; }
+
+    /// Set a callback that is invoked when the point underneath the mouse cursor changes
+    void set_hover_callback(const std::function<void(int)> &callback) { m_hover_callback = callback; }
+    /// Return the callback that is invoked when the point underneath the mouse cursor changes
+    const std::function<void(int)> &hover_callback() const { return m_hover_callback; }
+
+    virtual bool keyboard_event(int key, int scancode, int action, int modifiers) override;
+    virtual bool mouse_drag_event(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool mouse_motion_event(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool mouse_enter_event(const Vector2i &p, bool enter) override;
+    virtual bool scroll_event(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void draw_contents() override;
+
+protected:
+    /// Update the hovered point, invoking the callback if it changed
+    void set_hovered(int index);
+
+protected:
+    ref<Shader> m_shader;
+    /// Does \ref m_shader read per-point colors?
+    bool m_point_colors = false;
+    std::vector<float> m_positions;
+    float m_point_size = 3.f;
+    Color m_point_color;
+    Vector2f m_bbox_min, m_bbox_max;
+    Vector2f m_view_min, m_view_max;
+    int m_hovered = -1;
+    std::function<void(int)> m_hover_callback;
+
+    /* Uniform grid over the bounding box: the points in cell 'i' are
+       m_grid_points[m_grid_start[i]] ... m_grid_points[m_grid_start[i+1] - 1] */
+    Vector2i m_grid_res;
+    std::vector<uint32_t> m_grid_start;
+    std::vector<uint32_t> m_grid_points;
+};
+
+NAMESPACE_END(nanogui)
@@ -16,6 +16,9 @@
 
 #include <nanogui/widget.h>
 #include <nanogui/texture.h>
+#include <nanogui/gputimer.h>
+#include <unordered_map>
+#include <atomic>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -113,6 +116,15 @@ public:
     /// Send an event that will cause the screen to be redrawn at the next event loop iteration
     void redraw();
 
+    /**
+     * \brief Thread-safe variant of \ref redraw() for producer threads
+     *
+     * Does nothing if \c screen is null or has already been destroyed, so
+     * that background threads holding a plain pointer to a screen cannot
+     * touch a dangling object.
+     */
+    static void redraw_async(Screen *screen);
+
     /**
      * \brief Redraw the screen if the redraw flag is set
      *
@@ -218,6 +230,49 @@ public:
     /// Flush all queued up NanoVG rendering commands
     void nvg_flush();
 
+    /**
+     * \brief Return a NanoVG image that refers to a texture, for drawing it
+     * via \c nvgImagePattern() during the current frame
+     *
+     * The image (along with a reference to the texture) is kept until the
+     * end of the first frame that does not request it. Render targets are
+     * flipped vertically on OpenGL, so that they appear upright.
+     */
+    int nvg_texture_image(Texture *texture);
+
+    /**
+     * \brief Measure the GPU time of NanoVG's rendering, i.e. of
+     * \ref nvg_flush() and of the end of each frame (OpenGL only)
+     *
+     * Each flush is measured separately. Use \ref RenderPass::set_gpu_timing()
+     * to measure the render passes of canvases.
+     */
+    void set_nvg_gpu_timing(bool enabled) {
+        if (!enabled)
+            m_nvg_gpu_timer = nullptr;
+        else if (!m_nvg_gpu_timer)
+            m_nvg_gpu_timer = new GPUTimer();
+    }
+
+    /// Return the timer of NanoVG's rendering (\c nullptr if timing is disabled)
+    GPUTimer *nvg_gpu_timer() { return m_nvg_gpu_timer; }
+
+    /**
+     * \brief Return the loader that decodes images for this screen on worker
+     * threads (created on first use)
+     *
+     * Decoded images are uploaded at the beginning of each frame.
+     */
+    TextureLoader *texture_loader();
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Return the ring buffer that streams the uniform blocks of all
+     * shaders drawing into this screen (created on first use)
+     */
+    UniformRing *uniform_ring();
+#endif
+
     /// Shut down GLFW when the window is closed?
     void set_shutdown_glfw(bool v) { m_shutdown_glfw = v; }
     bool shutdown_glfw() { return m_shutdown_glfw; }
@@ -267,6 +322,7 @@ public:
     void center_window(Window *window);
     void move_window_to_front(Window *window);
     void draw_widgets();
+    void nvg_state_changed();
 
 protected:
     GLFWwindow *m_glfw_window = nullptr;
@@ -289,8 +345,22 @@ protected:
     bool m_depth_buffer;
     bool m_stencil_buffer;
     bool m_float_buffer;
-    bool m_redraw;
+    std::atomic<bool> m_redraw;
     std::function<void(Vector2i)> m_resize_callback;
+    ref<TextureLoader> m_texture_loader;
+    ref<GPUTimer> m_nvg_gpu_timer;
+
+    struct TextureImage {
+        ref<Texture> texture;
+        uintptr_t handle = 0;
+        Vector2i size = Vector2i(0);
+        int image = 0;
+        bool used = false;
+    };
+    std::unordered_map<const Texture *, TextureImage> m_texture_images;
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    ref<UniformRing> m_uniform_ring;
+#endif
 #if defined(NANOGUI_USE_METAL)
     void *m_metal_texture = nullptr;
     void *m_metal_drawable = nullptr;
@@ -0,0 +1,189 @@
+/*
+    nanogui/sdftext.h -- Resolution-independent text rendering using
+    signed distance fields
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/**
+ * \file nanogui/sdftext.h
+ *
+ * \brief Text rendering path for very large or continuously changing font
+ * sizes, which would otherwise flood the NanoVG glyph atlas.
+ */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <nanogui/vector.h>
+#include <unordered_map>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class SDFFont sdftext.h nanogui/sdftext.h
+ *
+ * \brief Glyph atlas storing signed distance fields instead of coverage
+ *
+ * Every glyph is rasterized exactly once at a fixed reference size (with
+ * 4x supersampling) and converted into a distance field, where the glyph
+ * outline corresponds to the value 0.5. Sampling the atlas bilinearly and
+ * thresholding the result then produces crisp outlines at any magnification,
+ * so the atlas size is independent of the sizes at which text is drawn.
+ *
+ * Printable ASCII characters are rasterized up front; other code points are
+ * added on first use.
+ */
+class NANOGUI_EXPORT SDFFont : public Object {
+public:
+    /// Metrics and atlas location of a single glyph
+    struct Glyph {
+        /// Glyph index within the font
+        int index;
+        /// Atlas position in texels
+        Vector2i atlas_pos;
+        /// Size of the glyph quad in texels (reference pixels)
+        Vector2i size;
+        /// Offset of the quad's top left corner relative to the pen position
+        Vector2f offset;
+        /// Horizontal advance in reference pixels
+        float advance;
+    };
+
+    /**
+     * \brief Create a distance field atlas for the given font
+     *
+     * \param font_name
+     *     Name of a TrueType font embedded into the library (see \ref resource())
+     *
+     * \param reference_size
+     *     Pixel height at which glyphs are rasterized
+     *
+     * \param spread
+     *     Range (in reference pixels) covered by the distance field on either
+     *     side of the outline. This bounds the amount of blur that can be applied.
+     */
+    SDFFont(const std::string &font_name = "Roboto-Bold.ttf",
+            float reference_size = 32.f, int spread = 4);
+
+    /// Return the glyph associated with a code point (rasterizing it if needed)
+    const Glyph &glyph(uint32_t codepoint);
+
+    /// Return the kerning adjustment between two glyphs in reference pixels
+    float kerning(const Glyph &g1, const Glyph &g2) const;
+
+    /// Return the pixel height at which glyphs are rasterized
+    float reference_size() const { return m_reference_size; }
+
+    /// Return the spread of the distance field in reference pixels
+    int spread() const { return m_spread; }
+
+    /// Return the font ascender (distance from the baseline to the top) in reference pixels
+    float ascender() const { return m_ascender; }
+
+    /// Return the font descender (negative distance from the baseline to the bottom) in reference pixels
+    float descender() const { return m_descender; }
+
+    /// Return the size of the atlas in texels
+    const Vector2i &atlas_size() const { return m_atlas_size; }
+
+    /// Return the CPU copy of the atlas
+    const uint8_t *atlas_data() const { return m_atlas.data(); }
+
+    /// Return a counter that is incremented whenever the atlas changes
+    uint32_t atlas_version() const { return m_atlas_version; }
+
+    /// Compute the width of a string at the given font size
+    float text_width(const std::string &text, float size);
+
+protected:
+    /// Release all resources
+    virtual ~SDFFont();
+
+    /// Rasterize a glyph into the atlas
+    Glyph &add_glyph(uint32_t codepoint);
+
+protected:
+    struct FontInfo;
+    std::unique_ptr<FontInfo> m_font;
+    float m_reference_size;
+    int m_spread;
+    float m_ascender, m_descender;
+    std::unordered_map<uint32_t, Glyph> m_glyphs;
+
+    /* Atlas storage (filled using a simple shelf packer) */
+    std::vector<uint8_t> m_atlas;
+    Vector2i m_atlas_size;
+    Vector2i m_shelf_pos = 0;
+    int m_shelf_height = 0;
+    uint32_t m_atlas_version = 0;
+};
+
+/**
+ * \class SDFText sdftext.h nanogui/sdftext.h
+ *
+ * \brief Batches strings into a single draw call using an \ref SDFFont
+ *
+ * Use \ref add() to queue up text (typically from within
+ * \ref Canvas::draw_contents()) and \ref draw() to render it within an
+ * active render pass. Queued strings persist until \ref clear() is called.
+ */
+class NANOGUI_EXPORT SDFText : public Object {
+public:
+    /// Create a text batch that renders into the given render pass
+    SDFText(RenderPass *render_pass, SDFFont *font = nullptr);
+
+    /// Return the font used by this batch
+    SDFFont *font() { return m_font; }
+
+    /// Remove all queued strings
+    void clear();
+
+    /**
+     * \brief Queue a string for rendering
+     *
+     * \param text
+     *     UTF-8 encoded string
+     *
+     * \param pos
+     *     Anchor position in the coordinate system defined by the matrix
+     *     passed to \ref draw(), which is assumed to measure framebuffer pixels
+     *
+     * \param size
+     *     Font size (pixel height)
+     *
+     * \param color
+     *     Text color
+     *
+     * \param align
+     *     Combination of NanoVG alignment flags (\c NVG_ALIGN_LEFT,
+     *     \c NVG_ALIGN_MIDDLE, ...)
+     *
+     * \param blur
+     *     Amount of blur in pixels (useful to render drop shadows). Limited
+     *     by the spread of the underlying font.
+     */
+    void add(const std::string &text, const Vector2f &pos, float size,
+             const Color &color, int align, float blur = 0.f);
+
+    /// Return the number of queued glyphs
+    size_t glyph_count() const { return m_positions.size() / 12; }
+
+    /// Draw all queued strings (must be called within an active render pass)
+    void draw(const Matrix4f &mvp);
+
+protected:
+    ref<SDFFont> m_font;
+    ref<Shader> m_shader;
+    ref<Texture> m_atlas;
+    uint32_t m_atlas_version = (uint32_t) -1;
+    std::vector<float> m_positions, m_uvs, m_colors, m_params;
+    bool m_dirty = false;
+};
+
+NAMESPACE_END(nanogui)
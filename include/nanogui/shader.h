@@ -18,7 +18,10 @@
 
 #include <nanogui/object.h>
 #include <nanogui/traits.h>
+#include <nanogui/resources.h>
+#include <nanogui/texture.h>
 #include <unordered_map>
+#include <vector>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -39,6 +42,37 @@ public:
         AlphaBlend // alpha * new_color + (1 - alpha) * old_color
     };
 
+    /// Update frequency of a vertex or index buffer (see \ref set_buffer_usage())
+    enum class BufferUsage : uint8_t {
+        /// Uploaded once and drawn many times
+        Static,
+
+        /// Modified occasionally (the default)
+        Dynamic,
+
+        /// Respecified at every frame: \ref set_buffer() orphans the
+        /// previous storage instead of waiting for draw calls that use it
+        Stream,
+
+        /// Persistently mapped ring of three copies of the buffer, which
+        /// \ref set_buffer() and \ref update_buffer_range() write into
+        /// directly (OpenGL 4.4 or ARB_buffer_storage, otherwise the same
+        /// as \c Stream)
+        Persistent
+    };
+
+    /**
+     * \brief Handle to a named shader parameter
+     *
+     * Resolving a name once via \ref binding() and passing the handle to
+     * \ref set_buffer(), \ref set_uniform(), or \ref set_texture() avoids
+     * a string lookup per call, which matters when many small draws update
+     * their parameters in a loop.
+     */
+    struct BindingHandle {
+        uint32_t index = (uint32_t) -1;
+    };
+
     /**
      * \brief Initialize the shader using the specified source strings.
      *
@@ -70,6 +104,14 @@ public:
     /// Return the blending mode of this shader
     BlendMode blend_mode() const { return m_blend_mode; }
 
+    /// Return a handle to the named shader parameter (throws if there is none)
+    BindingHandle binding(const std::string &name) const;
+
+    /// Does the shader have a parameter with the given name?
+    bool has_binding(const std::string &name) const {
+        return m_binding_index.find(name) != m_binding_index.end();
+    }
+
     /**
      * \brief Upload a buffer (e.g. vertex positions) that will be associated
      * with a named shader parameter.
@@ -78,14 +120,80 @@ public:
      * data---the implementation takes care of routing the data to the right
      * endpoint. Matrices should be specified in column-major order.
      *
-     * The buffer will be replaced if it is already present.
+     * If the buffer is already present and its size is unchanged, its
+     * storage is updated in place (or orphaned, depending on the usage hint
+     * set via \ref set_buffer_usage()); otherwise, it is reallocated.
      */
-    void set_buffer(const std::string &name, VariableType type, size_t ndim,
+    void set_buffer(BindingHandle binding, VariableType type, size_t ndim,
                     const size_t *shape, const void *data);
 
+    void set_buffer(BindingHandle binding, VariableType type,
+                    std::initializer_list<size_t> shape, const void *data) {
+        set_buffer(binding, type, shape.end() - shape.begin(), shape.begin(), data);
+    }
+
+    void set_buffer(const std::string &name, VariableType type, size_t ndim,
+                    const size_t *shape, const void *data) {
+        set_buffer(binding(name), type, ndim, shape, data);
+    }
+
     void set_buffer(const std::string &name, VariableType type,
                     std::initializer_list<size_t> shape, const void *data) {
-        set_buffer(name, type, shape.end() - shape.begin(), shape.begin(), data);
+        set_buffer(binding(name), type, shape.end() - shape.begin(), shape.begin(), data);
+    }
+
+    /**
+     * \brief Overwrite part of a vertex or index buffer that was previously
+     * uploaded using \ref set_buffer().
+     *
+     * \c offset and \c count refer to entries along the first dimension of
+     * the buffer (e.g. vertices), and \c data must contain \c count such
+     * entries with the same type and trailing shape as the original upload.
+     * This avoids re-transferring the entire buffer when only a small part
+     * of it changes, e.g. when appending to a ring buffer of samples.
+     */
+    void update_buffer_range(BindingHandle binding, size_t offset,
+                             size_t count, const void *data);
+
+    void update_buffer_range(const std::string &name, size_t offset,
+                             size_t count, const void *data) {
+        update_buffer_range(binding(name), offset, count, data);
+    }
+
+    /**
+     * \brief Specify how often a vertex or index buffer is going to be
+     * modified
+     *
+     * The hint takes effect at the next call to \ref set_buffer(). With
+     * \ref BufferUsage::Persistent, every \ref set_buffer() call advances
+     * to the next copy of the ring (waiting only if the GPU still reads
+     * from it), while \ref update_buffer_range() writes into the current
+     * copy without synchronization. The latter is intended for appending
+     * data, e.g. points of a cloud that grows at every frame, which
+     * pending draw calls do not read.
+     */
+    void set_buffer_usage(BindingHandle binding, BufferUsage usage);
+
+    void set_buffer_usage(const std::string &name, BufferUsage usage) {
+        set_buffer_usage(binding(name), usage);
+    }
+
+    /**
+     * \brief Turn a vertex buffer into a per-instance attribute
+     *
+     * With a nonzero \c divisor, the attribute advances once every
+     * \c divisor instances of \ref draw_array_instanced() instead of once
+     * per vertex, and the first dimension of the buffer counts instances.
+     * Should be called before \ref set_buffer(). On GLES 2, per-instance
+     * buffers are kept in CPU memory (only \c float components are
+     * supported), and their values are set as constant attributes before
+     * each instance is drawn. On Metal, the shader indexes per-instance
+     * buffers via <tt>[[instance_id]]</tt>, hence the divisor has no effect.
+     */
+    void set_buffer_divisor(BindingHandle binding, uint32_t divisor);
+
+    void set_buffer_divisor(const std::string &name, uint32_t divisor) {
+        set_buffer_divisor(binding(name), divisor);
     }
 
     /**
@@ -94,6 +202,12 @@ public:
      */
     template <typename Array> void set_uniform(const std::string &name,
                                                const Array &value) {
+        set_uniform(binding(name), value);
+    }
+
+    /// Upload a uniform variable (handle version)
+    template <typename Array> void set_uniform(BindingHandle binding,
+                                               const Array &value) {
         size_t shape[3] = { 1, 1, 1 };
         size_t ndim = (size_t) -1;
         const void *data;
@@ -135,7 +249,7 @@ public:
         if (ndim == (size_t) -1)
             throw std::runtime_error("Shader::set_uniform(): invalid input array dimension!");
 
-        set_buffer(name, vtype, ndim, shape, data);
+        set_buffer(binding, vtype, ndim, shape, data);
     }
 
     /**
@@ -143,13 +257,36 @@ public:
      *
      * The association will be replaced if it is already present.
      */
-    void set_texture(const std::string &name, Texture *texture);
+    void set_texture(BindingHandle binding, Texture *texture);
+
+    void set_texture(const std::string &name, Texture *texture) {
+        set_texture(binding(name), texture);
+    }
+
+    /**
+     * \brief Overwrite the entire contents of a uniform block
+     *
+     * On OpenGL and GLES 3, \c data must follow the std140 layout of the
+     * block named in the shader code, and \c size must match its size.
+     * The members of a block can also be set individually via
+     * \ref set_uniform(). Modified blocks are streamed into a
+     * \ref UniformRing that is shared by all shaders of the screen, hence
+     * updating a block costs a single mapped write instead of one call per
+     * uniform. On Metal, blocks are ordinary buffer arguments.
+     */
+    void set_uniform_block(BindingHandle binding, const void *data, size_t size);
+
+    void set_uniform_block(const std::string &name, const void *data, size_t size) {
+        set_uniform_block(binding(name), data, size);
+    }
 
     /**
      * \brief Begin drawing using this shader
      *
      * Note that any updates to 'uniform' and 'varying' shader parameters
-     * *must* occur prior to this method call.
+     * *must* occur prior to this method call. Only parameters that were
+     * modified since the previous call are sent to the GPU, along with
+     * state that other shaders may have overwritten (e.g. texture units).
      *
      * The Python bindings also include extra \c __enter__ and \c __exit__
      * aliases so that the shader can be activated via Pythons 'with'
@@ -182,15 +319,65 @@ public:
      */
     void draw_array(PrimitiveType primitive_type,
                     size_t offset, size_t count,
-                    bool indexed = false);
+                    bool indexed = false) {
+        draw_array_instanced(primitive_type, offset, count, 1, indexed);
+    }
+
+    /**
+     * \brief Render \c instance_count instances of the geometry with a
+     * single draw call
+     *
+     * The arguments are otherwise the same as in \ref draw_array().
+     * Per-instance data is provided by vertex buffers with a divisor (see
+     * \ref set_buffer_divisor()), and the shader can access the index of
+     * the instance via \c gl_InstanceID (or <tt>[[instance_id]]</tt> on
+     * Metal). GLES 2 lacks instancing, hence there the instances are drawn
+     * one by one.
+     */
+    void draw_array_instanced(PrimitiveType primitive_type,
+                              size_t offset, size_t count,
+                              size_t instance_count,
+                              bool indexed = false);
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /// Counters of the program binary cache (see \ref set_program_cache_directory())
+    struct ProgramCacheStats {
+        /// Programs that were loaded from the cache
+        size_t hits = 0;
+        /// Programs that were compiled from source
+        size_t misses = 0;
+        /// Cache entries that the driver refused to load (e.g. after an update)
+        size_t rejected = 0;
+        /// Programs that were written to the cache
+        size_t stored = 0;
+    };
+
+    /**
+     * \brief Set the directory of the program binary cache
+     *
+     * Linked programs are stored there (via \c glGetProgramBinary()) under
+     * a hash of their source code and of the vendor, renderer, and version
+     * strings of the driver, so that shaders with unchanged source code are
+     * not compiled again when the application is restarted. Entries that
+     * don't match the driver are ignored, and the program is compiled from
+     * source. By default, the cache is located in the user's cache
+     * directory (e.g. <tt>~/.cache/nanogui/shaders</tt>). Pass an empty
+     * string to disable it. Requires OpenGL 4.1 or GLES 3.
+     */
+    static void set_program_cache_directory(const std::string &path);
+
+    /// Return the directory of the program binary cache (empty if disabled)
+    static const std::string &program_cache_directory();
+
+    /// Return the counters of the program binary cache
+    static const ProgramCacheStats &program_cache_stats();
+
     uint32_t shader_handle() const { return m_shader_handle; }
 #elif defined(NANOGUI_USE_METAL)
     void *pipeline_state() const { return m_pipeline_state; }
 #endif
 
-#if defined(NANOGUI_USE_OPENGL)
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
     uint32_t vertex_array_handle() const { return m_vertex_array_handle; }
 #endif
 
@@ -205,9 +392,33 @@ protected:
         FragmentSampler,
         UniformBuffer,
         IndexBuffer,
+        UniformBlock,
+        UniformBlockMember
     };
 
+    /// Contents of a uniform block (OpenGL/GLES 3)
+    struct Block {
+        uint32_t binding = 0;
+        std::vector<uint8_t> data;
+        size_t offset = 0;
+        uint64_t generation = 0;
+        bool dirty = true;
+    };
+
+#if defined(NANOGUI_USE_OPENGL)
+    /// Persistently mapped ring of copies of a vertex or index buffer
+    struct Mapping {
+        uint32_t buffer = 0;
+        uint8_t *data = nullptr;
+        size_t region_size = 0;
+        uint32_t region = 0;
+        /// Fences that signal when the GPU has finished reading each copy
+        void *fences[3] { nullptr, nullptr, nullptr };
+    };
+#endif
+
     struct Buffer {
+        std::string name;
         void *buffer = nullptr;
         BufferType type = Unknown;
         VariableType dtype = VariableType::Invalid;
@@ -216,6 +427,22 @@ protected:
         size_t shape[3] { 0, 0, 0 };
         size_t size = 0;
         bool dirty = false;
+        /// Must be reapplied by every begin() call (see \ref m_persistent)
+        bool persistent = false;
+        /// Bound texture (made resident when the shader is used)
+        ref<Texture> texture;
+        /// Index of the sampler that belongs to a texture (Metal)
+        uint32_t sampler = (uint32_t) -1;
+        /// Location of a uniform block member (index into m_blocks, offset, and matrix column stride)
+        uint32_t block = (uint32_t) -1;
+        uint32_t block_offset = 0;
+        uint32_t matrix_stride = 0;
+        /// Usage hint of a vertex or index buffer
+        BufferUsage usage = BufferUsage::Dynamic;
+        /// Index into m_mappings of a persistently mapped buffer (OpenGL)
+        uint32_t mapping = (uint32_t) -1;
+        /// Number of instances per attribute value (0: per-vertex attribute)
+        uint32_t divisor = 0;
 
         std::string to_string() const;
     };
@@ -223,33 +450,161 @@ protected:
     /// Release all resources
     virtual ~Shader();
 
+    /// Append a parameter to the binding table (used by the constructor)
+    Buffer &add_binding(const std::string &name);
+
+    /// Look up the parameter referenced by a handle
+    Buffer &buffer(BindingHandle binding, const char *caller);
+
+    /// Queue a modified parameter for the next begin() call
+    void mark_dirty(Buffer &buf) {
+        if (buf.dirty || buf.persistent)
+            return;
+        buf.dirty = true;
+        m_dirty.push_back((uint32_t) (&buf - m_buffers.data()));
+    }
+
+    /// Partition the binding table into persistent and on-demand parameters
+    void finalize_bindings();
+
+    /// Warn about parameters that were never set (until all of them are)
+    void check_bindings();
+
+    /**
+     * Make all textures resident and pin them until \ref unpin_textures()
+     * (called by begin() before any texture unit is bound)
+     */
+    void pin_textures();
+
+    /// Release the pins acquired by \ref pin_textures() (called by end())
+    void unpin_textures();
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /// Send a parameter to the GPU (called by begin())
+    void apply_binding(Buffer &buf, int texture_unit = 0);
+
+    /// Stream modified uniform blocks into the uniform ring
+    void upload_blocks();
+
+    /// Byte offset of the current copy of a persistently mapped buffer
+    size_t buffer_offset(const Buffer &buf) const;
+#endif
+
+#if defined(NANOGUI_USE_OPENGL)
+    /// Write a buffer into the next copy of its persistently mapped ring
+    void upload_mapped(Buffer &buf, size_t size, const void *data);
+#endif
+
 protected:
     RenderPass* m_render_pass;
     std::string m_name;
-    std::unordered_map<std::string, Buffer> m_buffers;
     BlendMode m_blend_mode;
 
+    /// Binding table (indexed by BindingHandle::index), built once at construction
+    std::vector<Buffer> m_buffers;
+    std::unordered_map<std::string, uint32_t> m_binding_index;
+    uint32_t m_indices = 0;
+
+    /* Parameters that begin() must reapply every time, since the state they
+       set is not retained by the program (e.g. texture units, or vertex
+       attributes without vertex array objects), followed by parameters
+       that were modified since the previous call */
+    std::vector<uint32_t> m_persistent;
+    std::vector<uint32_t> m_dirty;
+    bool m_bindings_complete = false;
+
+    /// Textures pinned between begin() and end()
+    std::vector<ref<Texture>> m_pinned;
+
     #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         uint32_t m_shader_handle = 0;
-    #  if defined(NANOGUI_USE_OPENGL)
+        std::vector<Block> m_blocks;
+        ref<UniformRing> m_uniform_ring;
+    #  if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
         uint32_t m_vertex_array_handle = 0;
+    #  endif
+    #  if defined(NANOGUI_USE_OPENGL)
         bool m_uses_point_size = false;
+        std::vector<Mapping> m_mappings;
     #  endif
     #elif defined(NANOGUI_USE_METAL)
         void *m_pipeline_state;
     #endif
 };
 
-/// Access binary data stored in nanogui_resources.cpp
-#define NANOGUI_RESOURCE_STRING(name) std::string(name, name + name##_size)
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+/**
+ * \class UniformRing shader.h nanogui/shader.h
+ *
+ * \brief Ring buffer that streams the contents of uniform blocks to the GPU
+ *
+ * Each update is copied into the next free (suitably aligned) range of a
+ * single uniform buffer, which the shader then binds by offset.
+ *
+ * When \c glBufferStorage() is available (OpenGL 4.4), the buffer is mapped
+ * persistently and updates are written straight into it. The ring is split
+ * into thirds, and a fence guards each third from being overwritten before
+ * the GPU has finished reading it. Otherwise, updates are staged in memory
+ * and copied by \ref flush() using a single map operation. Once the buffer
+ * is full, its storage is orphaned, so that the driver can hand out fresh
+ * memory without waiting for pending draw calls. Either way, moving on to
+ * memory that previous updates may occupy increments \ref generation(),
+ * which tells the shaders to re-upload their blocks.
+ *
+ * Every screen owns a ring (see \ref Screen::uniform_ring()) that is shared
+ * by the shaders created while its context is current. Requires OpenGL or
+ * GLES 3.
+ */
+class NANOGUI_EXPORT UniformRing : public Object {
+public:
+    /// Allocate a ring of \c size bytes
+    UniformRing(size_t size = 1024 * 1024);
+
+    /// Copy \c size bytes into the ring and return their offset (see \ref flush())
+    size_t push(const void *data, size_t size);
+
+    /// Make the data of preceding \ref push() calls visible to draw calls
+    void flush();
+
+    /// Return the size of the ring in bytes
+    size_t size() const { return m_size; }
+
+    /// Return the number of times that previously returned offsets were invalidated
+    uint64_t generation() const { return m_generation; }
+
+    /// Return the handle of the uniform buffer
+    uint32_t buffer_handle() const { return m_buffer_handle; }
+
+protected:
+    /// Release the uniform buffer
+    virtual ~UniformRing();
+
+protected:
+    size_t m_size;
+    size_t m_offset = 0;
+    size_t m_alignment = 256;
+    uint64_t m_generation = 0;
+    uint32_t m_buffer_handle = 0;
+
+    /// Persistently mapped storage, and the third of it that is being filled
+    uint8_t *m_data = nullptr;
+    uint32_t m_region = 0;
+    /// Fences that signal when the GPU has finished reading each third
+    void *m_fences[3] { nullptr, nullptr, nullptr };
+
+    /// Data pushed since the last \ref flush(), starting at \c m_flush_offset
+    std::vector<uint8_t> m_staging;
+    size_t m_flush_offset = 0;
+};
+#endif
 
-/// Access a shader stored in nanogui_resources.cpp
+/// Access a shader embedded into the library for the active backend (see \ref resource())
 #if defined(NANOGUI_USE_OPENGL)
-#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(name##_gl)
+#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(#name ".gl")
 #elif defined(NANOGUI_USE_GLES)
-#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(name##_gles)
+#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(#name ".gles")
 #elif defined(NANOGUI_USE_METAL)
-#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(name##_metallib)
+#  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(#name ".metallib")
 #endif
 
 
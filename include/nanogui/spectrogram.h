@@ -0,0 +1,110 @@
+/*
+    nanogui/spectrogram.h -- Scrolling heat map for displaying a stream of
+    spectra or other one-dimensional signals over time
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/canvas.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Spectrogram spectrogram.h nanogui/spectrogram.h
+ *
+ * \brief Waterfall display of a stream of columns (e.g. spectra)
+ *
+ * Every column consists of \ref bins() values, which are drawn from bottom to
+ * top, while time advances from left to right with the most recent column at
+ * the right edge. The last \ref history() columns are kept in a texture that
+ * is used as a ring buffer: each frame only uploads the columns that were
+ * pushed since the previous one, and scrolling is realized by wrapping the
+ * texture coordinates in the fragment shader, which also maps values to
+ * colors using a lookup table.
+ *
+ * Values are mapped from \ref range() to <tt>[0, 1]</tt> and quantized to 8
+ * bits when they are pushed, hence changing the range only affects
+ * subsequently pushed columns.
+ */
+class NANOGUI_EXPORT Spectrogram : public Canvas {
+public:
+    /// Predefined color maps
+    enum class Colormap {
+        Grayscale,
+        Viridis,
+        Inferno
+    };
+
+    /// Create a spectrogram displaying \c history columns with \c bins values each
+    Spectrogram(Widget *parent, size_t bins = 256, size_t history = 512);
+
+    /// Return the number of values per column
+    size_t bins() const { return m_bins; }
+
+    /// Return the number of displayed columns
+    size_t history() const { return m_history; }
+
+    /// Change the number of values per column and displayed columns (discards the contents)
+    void set_shape(size_t bins, size_t history);
+
+    /// Return the value range that is mapped onto the color map
+    std::pair<float, float> range() const { return { m_range_min, m_range_max }; }
+
+    /// Set the value range that is mapped onto the color map
+    void set_range(float min, float max) {
+        m_range_min = min;
+        m_range_max = max;
+    }
+
+    /// Append a column of \ref bins() values
+    void push_column(const float *values) { push_columns(values, 1); }
+
+    /// Append \c count consecutive columns of \ref bins() values each
+    void push_columns(const float *values, size_t count);
+
+    /// Return the total number of columns pushed since the last \ref clear()
+    uint64_t column_count() const { return m_total; }
+
+    /// Remove all columns
+    void clear();
+
+    /// Select one of the predefined color maps
+    void set_colormap(Colormap colormap);
+
+    /**
+     * \brief Specify a custom color map
+     *
+     * The colors are evenly spaced over the value range and linearly
+     * interpolated. At least two colors must be given.
+     */
+    void set_colormap(const std::vector<Color> &colors);
+
+    /// Draw the widget contents
+    virtual void draw_contents() override;
+
+protected:
+    /// (Re)allocate the ring buffer texture
+    void init_texture();
+
+protected:
+    ref<Shader> m_shader;
+    ref<Texture> m_texture;
+    ref<Texture> m_colormap;
+    size_t m_bins, m_history;
+    float m_range_min = 0.f, m_range_max = 1.f;
+
+    /// CPU copy of the ring buffer (one row of 'm_bins' bytes per column)
+    std::vector<uint8_t> m_data;
+    uint64_t m_total = 0;
+    uint64_t m_uploaded = 0;
+};
+
+NAMESPACE_END(nanogui)
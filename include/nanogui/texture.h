@@ -19,6 +19,10 @@
 #include <nanogui/object.h>
 #include <nanogui/vector.h>
 #include <nanogui/traits.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -90,6 +94,33 @@ public:
         MirrorRepeat,
     };
 
+    /// Block compression scheme (all of them operate on blocks of 4x4 pixels)
+    enum class Compression : uint8_t {
+        /// Uncompressed texture
+        None,
+
+        /// BC1 (DXT1): RGB + 1 bit alpha, 8 bytes per block
+        BC1,
+
+        /// BC3 (DXT5): RGBA, 16 bytes per block
+        BC3,
+
+        /// BC4 (RGTC1): single channel, 8 bytes per block
+        BC4,
+
+        /// BC5 (RGTC2): two channels, 16 bytes per block
+        BC5,
+
+        /// BC7 (BPTC): high quality RGBA, 16 bytes per block
+        BC7,
+
+        /// ETC2: RGB, 8 bytes per block
+        ETC2_RGB,
+
+        /// ETC2 + EAC: RGBA, 16 bytes per block
+        ETC2_RGBA
+    };
+
     /// How will the texture be used? (Must specify at least one)
     enum TextureFlags {
         /// Texture to be read in shaders
@@ -119,7 +150,29 @@ public:
             uint8_t samples = 1,
             uint8_t flags = (uint8_t) TextureFlags::ShaderRead);
 
-    /// Load an image from the given file using stb-image
+    /**
+     * \brief Allocate a block-compressed texture with \c mip_levels levels
+     *
+     * The contents must be provided level by level via
+     * \ref upload_compressed(). The reported pixel and component format
+     * describe the decompressed data (e.g. \c RGBA and \c UInt8 for BC7).
+     * Use \ref compression_supported() to check whether the hardware can
+     * sample the format.
+     */
+    Texture(Compression compression,
+            const Vector2i &size,
+            uint32_t mip_levels = 1,
+            InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
+            InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear,
+            WrapMode wrap_mode = WrapMode::ClampToEdge);
+
+    /**
+     * \brief Load an image from the given file
+     *
+     * KTX (version 1) containers with a block-compressed internal format
+     * are uploaded as-is including their mip chain, which skips decoding on
+     * the CPU. Other files are decoded using stb-image.
+     */
     Texture(const std::string &filename,
             InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
             InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear,
@@ -155,15 +208,143 @@ public:
     /// Return the number of channels of this texture
     size_t channels() const;
 
-    /// Upload packed pixel data from the CPU to the GPU
+    /// Return the block compression scheme (or \ref Compression::None)
+    Compression compression() const { return m_compression; }
+
+    /// Return the number of MIP levels of a compressed texture (1 otherwise)
+    uint32_t mip_levels() const { return m_mip_levels; }
+
+    /// Return the number of bytes of the given MIP level of a compressed texture
+    size_t compressed_size(uint32_t level = 0) const;
+
+    /// Check whether the hardware supports a block compression scheme
+    static bool compression_supported(Compression compression);
+
+    /**
+     * \brief Upload packed pixel data from the CPU to the GPU
+     *
+     * The texture storage is only (re)allocated by the first upload and
+     * following a \ref resize(); subsequent uploads overwrite the existing
+     * storage in place.
+     */
     void upload(const uint8_t *data);
 
-    /// Download packed pixel data from the GPU to the CPU
+    /**
+     * \brief Upload pixel data to a rectangular region of the texture
+     *
+     * \c data contains <tt>size.y()</tt> rows of <tt>size.x()</tt> pixels
+     * each, which are written to the texture starting at \c origin. The
+     * remainder of the texture is left untouched, which makes this much
+     * cheaper than \ref upload() when only a small part of a large texture
+     * changes (e.g. one line of a ring buffer).
+     *
+     * Consecutive rows of \c data are \c row_stride pixels apart, which
+     * makes it possible to upload a region straight out of a larger image
+     * (pass a pointer to its first pixel). The default value of zero
+     * refers to tightly packed rows.
+     */
+    void upload_sub_region(const uint8_t *data, const Vector2i &origin,
+                           const Vector2i &size, size_t row_stride = 0);
+
+    /**
+     * \brief Upload one MIP level of a compressed texture
+     *
+     * \c data holds rows of 4x4 blocks as produced by the compressor, and
+     * \c size must equal \ref compressed_size() of the level.
+     */
+    void upload_compressed(const uint8_t *data, size_t size, uint32_t level = 0);
+
+    /**
+     * \brief Download packed pixel data from the GPU to the CPU
+     *
+     * Waits for the transfer to finish. Use \ref download_async() to avoid
+     * stalling the pipeline.
+     */
     void download(uint8_t *data);
 
+    /**
+     * \brief Start copying the texture contents into a staging buffer
+     * without waiting for the transfer to finish
+     *
+     * Equivalent to creating a \ref TextureDownload and calling its
+     * \ref TextureDownload::start() method. To read back every frame, it is
+     * more efficient to keep a few \ref TextureDownload instances around and
+     * to reuse them.
+     */
+    ref<TextureDownload> download_async();
+
     /// Resize the texture (discards the current contents)
     void resize(const Vector2i &size);
 
+    /**
+     * \brief Return the number of bytes of GPU memory that the texture
+     * occupies (including MIP levels and multisampling)
+     *
+     * Evicted textures (see \ref set_evictable()) are not counted by
+     * \ref total_memory_usage().
+     */
+    size_t memory_usage() const;
+
+    /// Return the label under which the texture's memory is reported
+    const std::string &owner() const { return m_owner; }
+    /// Set the label under which the texture's memory is reported
+    void set_owner(const std::string &owner);
+
+    /// Can the texture storage be released when the memory budget is exceeded?
+    bool evictable() const { return m_evictable; }
+
+    /**
+     * \brief Specify whether the texture storage can be released when the
+     * memory budget is exceeded
+     *
+     * Evicted textures are recreated when they are next bound by a
+     * \ref Shader, which invokes \c restore to upload the contents
+     * again. For textures that were loaded from an image file, \c restore
+     * may be omitted to reload the file. Only supported for textures that
+     * are exclusively read by shaders.
+     */
+    void set_evictable(bool evictable,
+                       const std::function<void(Texture *)> &restore = { });
+
+    /// Return whether the texture storage is currently allocated
+    bool resident() const { return !m_evicted; }
+
+    /**
+     * \brief Recreate the storage of an evicted texture, and mark the
+     * texture as most recently used
+     */
+    void make_resident();
+
+    /**
+     * \brief Make the texture resident and exempt it from eviction until
+     * the matching \ref unpin() call
+     *
+     * \ref Shader::begin() pins all of its textures before binding any
+     * texture unit, so that restoring one texture cannot evict another
+     * that is about to be used by the same draw call.
+     */
+    void pin();
+
+    /// Release a pin acquired by \ref pin() and enforce the memory budget
+    void unpin();
+
+    /// Return the number of bytes occupied by all textures that are resident
+    static size_t total_memory_usage();
+
+    /// Return the memory occupied by resident textures, grouped by \ref owner()
+    static std::map<std::string, size_t> memory_usage_by_owner();
+
+    /// Return the texture memory budget in bytes (0: unlimited)
+    static size_t memory_budget();
+
+    /**
+     * \brief Set the texture memory budget in bytes (0: unlimited)
+     *
+     * Whenever textures are allocated beyond the budget, evictable textures
+     * are released in least recently used order until the total fits again.
+     */
+    static void set_memory_budget(size_t budget);
+
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     uint32_t texture_handle() const { return m_texture_handle; }
     uint32_t renderbuffer_handle() const { return m_renderbuffer_handle; }
@@ -173,9 +354,46 @@ public:
 #endif
 
 protected:
+    friend class TextureStream;
+    friend class TextureDownload;
+    friend class TextureLoader;
+
+    /// Set the sampling parameters of an 8-bit texture whose contents are loaded later
+    Texture(InterpolationMode min_interpolation_mode,
+            InterpolationMode mag_interpolation_mode,
+            WrapMode wrap_mode);
+
     /// Initialize the texture handle
     void init();
 
+    /// Check whether a file starts with the identifier of a KTX container
+    static bool is_ktx(const uint8_t *data, size_t size);
+
+    /// Parse a KTX container and upload its contents
+    void load_ktx(const std::string &filename, const std::vector<uint8_t> &data);
+
+    /// Allocate the texture and upload decoded 8-bit pixels with 1-4 channels
+    void load_image(const std::string &filename, const uint8_t *data,
+                    const Vector2i &size, int channels);
+
+    /// Number of MIP levels that are allocated for this texture
+    uint32_t allocated_mip_levels() const;
+
+    /// Update the memory registry after the storage was (re)allocated
+    void track_memory();
+
+    /// Remove the texture from the memory registry
+    void untrack_memory();
+
+    /// Evict least recently used textures (other than \c keep) until the budget is met
+    static void enforce_memory_budget(Texture *keep);
+
+    /// Release the texture storage (keeping the handle valid, if possible)
+    void release_storage();
+
+    /// Reallocate the texture storage after \ref release_storage()
+    void restore_storage();
+
     /// Release all resources
     virtual ~Texture();
 
@@ -188,14 +406,247 @@ protected:
     uint8_t m_samples;
     uint8_t m_flags;
     Vector2i m_size;
+    Compression m_compression = Compression::None;
+    uint32_t m_mip_levels = 1;
+
+    /* Memory accounting and eviction */
+    std::string m_owner;
+    std::string m_filename;
+    std::function<void(Texture *)> m_restore;
+    bool m_evictable = false;
+    bool m_evicted = false;
+    size_t m_tracked_bytes = 0;
+    uint64_t m_last_use = 0;
+    uint32_t m_pins = 0;
 
     #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         uint32_t m_texture_handle = 0;
         uint32_t m_renderbuffer_handle = 0;
+        Vector2i m_storage_size = Vector2i(0);
     #elif defined(NANOGUI_USE_METAL)
         void *m_texture_handle = nullptr;
         void *m_sampler_state_handle = nullptr;
     #endif
 };
 
+/**
+ * \class TextureStream texture.h nanogui/texture.h
+ *
+ * \brief Ring of staging buffers for streaming frames (e.g. video) into a
+ * texture without stalling the render thread.
+ *
+ * A producer thread (e.g. a video decoder) obtains a buffer via
+ * \ref map_next(), writes a tightly packed frame directly into it, and hands
+ * it back via \ref commit(). The render thread periodically calls
+ * \ref update(), which copies the most recently committed frame into the
+ * texture on the GPU and recycles buffers once the GPU is done with them.
+ * If several frames were committed in the meantime, only the newest one is
+ * uploaded and the others are counted as dropped.
+ *
+ * On OpenGL and GLES 3, the buffers are pixel unpack buffers that stay
+ * mapped while they are owned by the producer, and fences track when their
+ * copies complete. On Metal, they are shared-memory buffers that are copied
+ * using a blit encoder. GLES 2 lacks pixel buffer objects, hence the frames
+ * are staged in CPU memory and uploaded synchronously by \ref update().
+ */
+class NANOGUI_EXPORT TextureStream : public Object {
+public:
+    /**
+     * \brief Create a stream targeting the given texture
+     *
+     * The texture must be single-sampled and readable by shaders. At least
+     * two buffers are needed so that the producer can write one frame while
+     * the previous one is copied.
+     */
+    TextureStream(Texture *texture, size_t buffer_count = 3);
+
+    /// Return the target texture
+    Texture *texture() { return m_texture; }
+
+    /// Return the number of staging buffers
+    size_t buffer_count() const { return m_slots.size(); }
+
+    /// Return the size of a frame (and hence of each buffer) in bytes
+    size_t frame_size() const { return m_frame_size; }
+
+    /**
+     * \brief Acquire a buffer for writing the next frame (thread-safe)
+     *
+     * Returns \c nullptr when all buffers are currently in use, in which
+     * case the producer should retry later or skip the frame. The returned
+     * pointer remains valid until it is passed to \ref commit() or
+     * \ref discard().
+     */
+    uint8_t *map_next();
+
+    /// Queue a buffer obtained from \ref map_next() for upload (thread-safe)
+    void commit(uint8_t *data);
+
+    /// Return a buffer obtained from \ref map_next() without uploading it (thread-safe)
+    void discard(uint8_t *data);
+
+    /**
+     * \brief Copy the newest committed frame into the texture and recycle
+     * buffers (render thread only)
+     *
+     * Never waits for the GPU. Returns \c true if the texture was updated.
+     */
+    bool update();
+
+    /// Return the number of frames that were copied into the texture
+    uint64_t frames_uploaded() const { return m_frames_uploaded; }
+
+    /// Return the number of committed frames that were superseded before being uploaded
+    uint64_t frames_dropped() const { return m_frames_dropped; }
+
+    /**
+     * \brief Request that the next \ref commit() calls \ref Screen::redraw()
+     * on the given screen (render thread only)
+     *
+     * Should be called before \ref update(), so that frames which arrive in
+     * the meantime are guaranteed to trigger another redraw. Specify
+     * \c nullptr to disable notifications. The request is posted via
+     * \ref Screen::redraw_async(), so it is harmless if the screen has been
+     * destroyed in the meantime.
+     */
+    void request_notification(Screen *screen) {
+        m_screen.store(screen, std::memory_order_relaxed);
+        m_armed.store(screen != nullptr, std::memory_order_release);
+    }
+
+protected:
+    /// Release all resources (the producer must no longer access any buffers)
+    virtual ~TextureStream();
+
+    /// Return the index of the slot whose buffer starts at \c data
+    size_t slot_index(const uint8_t *data) const;
+
+    /// Backend-specific: allocate the buffers and make them available to the producer
+    void init();
+
+    /// Backend-specific: copy a committed buffer into the texture
+    void upload(size_t index);
+
+    /// Backend-specific: return a buffer to the producer once the GPU is done with it
+    bool recycle(size_t index);
+
+protected:
+    enum class SlotState : uint8_t {
+        /// Available to the producer
+        Free,
+        /// Handed out by map_next()
+        Writing,
+        /// Committed, waiting for update()
+        Ready,
+        /// Being copied into the texture by the GPU
+        InFlight
+    };
+
+    struct Slot {
+        SlotState state = SlotState::Free;
+        uint8_t *data = nullptr;
+        uint64_t frame = 0;
+    #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        uint32_t buffer = 0;
+        void *fence = nullptr;
+        std::unique_ptr<uint8_t[]> storage;
+    #elif defined(NANOGUI_USE_METAL)
+        void *buffer = nullptr;
+        void *command_buffer = nullptr;
+    #endif
+    };
+
+    ref<Texture> m_texture;
+    std::vector<Slot> m_slots;
+    size_t m_frame_size;
+
+    /// Protects the slot states and frame counters
+    std::mutex m_mutex;
+    uint64_t m_frames_committed = 0;
+    uint64_t m_frames_uploaded = 0;
+    uint64_t m_frames_dropped = 0;
+
+    std::atomic<bool> m_armed { false };
+    std::atomic<Screen *> m_screen { nullptr };
+};
+
+/**
+ * \class TextureDownload texture.h nanogui/texture.h
+ *
+ * \brief Handle of an asynchronous readback of a texture's contents.
+ *
+ * \ref start() enqueues a copy of the texture into a staging buffer (a
+ * pixel pack buffer on OpenGL and GLES 3, a shared-memory buffer on Metal)
+ * and returns immediately. \ref ready() polls whether the copy has
+ * completed, and \ref data() provides access to the pixels, waiting if
+ * necessary. A handle can be restarted once its data has been consumed,
+ * which avoids reallocating the staging buffer.
+ *
+ * OpenGL stores render targets upside down. Instead of flipping the rows,
+ * \ref data() then points to the last row of the buffer and
+ * \ref row_stride() is negative, so that rows can always be traversed from
+ * top to bottom. \ref read() produces a conventional top-down copy.
+ *
+ * All methods must be called from the render thread. Not supported on
+ * GLES 2. On GLES 3, the texture is read through a framebuffer, hence
+ * R, RA and depth textures cannot be downloaded.
+ */
+class NANOGUI_EXPORT TextureDownload : public Object {
+public:
+    /// Create a readback handle for the given (single-sampled) texture
+    TextureDownload(Texture *texture);
+
+    /// Return the texture that is read back
+    Texture *texture() { return m_texture; }
+
+    /// Return the size of the image captured by the last call to \ref start()
+    const Vector2i &size() const { return m_size; }
+
+    /// Enqueue a copy of the current texture contents (does not wait)
+    void start();
+
+    /// Check whether the copy has completed (does not wait)
+    bool ready();
+
+    /// Wait for the copy to complete
+    void wait();
+
+    /**
+     * \brief Return a pointer to the top row of the downloaded image
+     *
+     * Waits for the copy to complete. The pointer remains valid until the
+     * next call to \ref start() or until the handle is destroyed.
+     */
+    const uint8_t *data();
+
+    /// Return the offset in bytes from one row to the next (negative if flipped)
+    ptrdiff_t row_stride() const {
+        ptrdiff_t stride = (ptrdiff_t) (m_texture->bytes_per_pixel() * (size_t) m_size.x());
+        return m_flipped ? -stride : stride;
+    }
+
+    /// Copy the image into \c out as tightly packed rows from top to bottom (waits)
+    void read(uint8_t *out);
+
+protected:
+    /// Release all resources
+    virtual ~TextureDownload();
+
+protected:
+    ref<Texture> m_texture;
+    Vector2i m_size = Vector2i(0);
+    size_t m_buffer_size = 0;
+    bool m_flipped = false;
+    bool m_started = false;
+
+    #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        uint32_t m_buffer = 0;
+        void *m_fence = nullptr;
+        uint8_t *m_mapped = nullptr;
+    #elif defined(NANOGUI_USE_METAL)
+        void *m_buffer = nullptr;
+        void *m_command_buffer = nullptr;
+    #endif
+};
+
 NAMESPACE_END(nanogui)
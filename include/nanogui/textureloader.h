@@ -0,0 +1,209 @@
+/*
+    nanogui/textureloader.h -- Asynchronous loading of textures and
+    NanoVG images on worker threads
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class AsyncTexture textureloader.h nanogui/textureloader.h
+ *
+ * \brief Handle to an image that is being loaded by a \ref TextureLoader
+ *
+ * Until the image has been decoded and uploaded, \ref texture() returns a
+ * placeholder texture, so that the handle can be used right away.
+ */
+class NANOGUI_EXPORT AsyncTexture : public Object {
+public:
+    enum class State : uint8_t {
+        /// The image is being decoded or waiting to be uploaded
+        Pending,
+
+        /// The image was uploaded to the GPU
+        Ready,
+
+        /// The image could not be loaded (see \ref error())
+        Failed
+    };
+
+    /// Return the name of the loaded file
+    const std::string &filename() const { return m_filename; }
+
+    /// Return the loading state
+    State state() const { return m_state; }
+
+    /// Has the image been uploaded to the GPU?
+    bool ready() const { return m_state == State::Ready; }
+
+    /**
+     * \brief Return the texture (for requests made via
+     * \ref TextureLoader::load()), or the loader's placeholder while the
+     * image is pending or if it failed to load
+     */
+    Texture *texture() { return m_texture ? m_texture.get() : m_placeholder.get(); }
+
+    /**
+     * \brief Return the NanoVG image handle (for requests made via
+     * \ref TextureLoader::load_nvg_image()), or 0 while the image is pending
+     *
+     * As with \c nvgCreateImage(), the caller is responsible for deleting the
+     * image.
+     */
+    int nvg_image() const { return m_nvg_image; }
+
+    /// Return the reason why loading failed
+    const std::string &error() const { return m_error; }
+
+    /**
+     * \brief Set a function that is called on the rendering thread once the
+     * image is ready or failed to load (immediately, if that is already the
+     * case)
+     */
+    void set_callback(const std::function<void(AsyncTexture *)> &callback);
+
+protected:
+    friend class TextureLoader;
+
+    AsyncTexture(const std::string &filename, Texture *placeholder)
+        : m_filename(filename), m_placeholder(placeholder) { }
+
+protected:
+    std::string m_filename;
+    State m_state = State::Pending;
+    ref<Texture> m_texture;
+    ref<Texture> m_placeholder;
+    int m_nvg_image = 0;
+    std::string m_error;
+    std::function<void(AsyncTexture *)> m_callback;
+
+    /* Parameters of the request */
+    NVGcontext *m_nvg_context = nullptr;
+    int m_nvg_image_flags = 0;
+    Texture::InterpolationMode m_min_interpolation_mode;
+    Texture::InterpolationMode m_mag_interpolation_mode;
+    Texture::WrapMode m_wrap_mode;
+};
+
+/**
+ * \class TextureLoader textureloader.h nanogui/textureloader.h
+ *
+ * \brief Loads images without blocking the rendering thread
+ *
+ * Files are read and decoded by a pool of worker threads. The decoded images
+ * are queued and uploaded to the GPU by \ref update(), which stops once a
+ * per-frame time budget is exhausted and continues at the next frame.
+ *
+ * Each screen owns a loader (see \ref Screen::texture_loader()), which it
+ * updates at the beginning of every frame and which schedules a redraw
+ * whenever there are images to upload.
+ */
+class NANOGUI_EXPORT TextureLoader : public Object {
+public:
+    using InterpolationMode = Texture::InterpolationMode;
+    using WrapMode          = Texture::WrapMode;
+
+    /**
+     * \brief Create a loader whose uploads are drawn by \c screen
+     *
+     * \param thread_count
+     *     Number of worker threads (0: one per hardware thread)
+     *
+     * \param upload_budget
+     *     Time in milliseconds that \ref update() may spend on uploads
+     */
+    TextureLoader(Screen *screen, size_t thread_count = 0, double upload_budget = 2.0);
+
+    /**
+     * \brief Load a texture from an image file (see the corresponding
+     * \ref Texture constructor for the supported formats)
+     */
+    ref<AsyncTexture> load(const std::string &filename,
+                           InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
+                           InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear,
+                           WrapMode wrap_mode                       = WrapMode::ClampToEdge);
+
+    /// Load a NanoVG image (asynchronous version of \c nvgCreateImage())
+    ref<AsyncTexture> load_nvg_image(NVGcontext *ctx, const std::string &filename,
+                                     int image_flags = 0);
+
+    /**
+     * \brief Asynchronous version of \ref nanogui::load_image_directory()
+     *
+     * Returns the NanoVG image handles along with the file names (without
+     * extension) right away.
+     */
+    std::vector<std::pair<ref<AsyncTexture>, std::string>>
+    load_image_directory(NVGcontext *ctx, const std::string &path);
+
+    /**
+     * \brief Upload decoded images until the time budget is exhausted
+     *
+     * Must be called on the rendering thread. Returns \c true if any image
+     * was finished (i.e. ready or failed).
+     */
+    bool update();
+
+    /// Return the number of images that are being loaded
+    size_t pending_count() const;
+
+    /// Return the time in milliseconds that \ref update() may spend on uploads
+    double upload_budget() const { return m_upload_budget; }
+    /// Set the time in milliseconds that \ref update() may spend on uploads
+    void set_upload_budget(double upload_budget) { m_upload_budget = upload_budget; }
+
+    /// Return the 1x1 transparent texture that stands in for pending textures
+    Texture *placeholder() { return m_placeholder; }
+
+    /// Stop the worker threads and drop all pending requests
+    void shutdown();
+
+protected:
+    /// Calls \ref shutdown()
+    virtual ~TextureLoader();
+
+    void enqueue(AsyncTexture *handle);
+    void worker();
+
+protected:
+    struct Job {
+        ref<AsyncTexture> handle;
+        std::unique_ptr<uint8_t[], void(*)(void*)> pixels { nullptr, free };
+        Vector2i size = Vector2i(0);
+        int channels = 0;
+        std::vector<uint8_t> ktx;
+        std::string error;
+    };
+
+    Screen *m_screen;
+    double m_upload_budget;
+    ref<Texture> m_placeholder;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Job> m_queue;
+    std::deque<Job> m_decoded;
+    size_t m_in_progress = 0;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+};
+
+NAMESPACE_END(nanogui)
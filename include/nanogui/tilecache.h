@@ -0,0 +1,256 @@
+/*
+    nanogui/tilecache.h -- Multi-resolution tiled images that are decoded
+    on demand by worker threads and cached on the GPU
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TileSource tilecache.h nanogui/tilecache.h
+ *
+ * \brief Interface to an image that is too large to be loaded at once
+ *
+ * The image is organized as a pyramid of levels: level 0 has the full
+ * resolution \ref size(), and every following level halves the resolution
+ * (rounding up) until the whole image fits into a single tile. Each level is
+ * split into square tiles of \ref tile_size() pixels, which are produced on
+ * demand by \ref load_tile().
+ */
+class NANOGUI_EXPORT TileSource : public Object {
+public:
+    using PixelFormat     = Texture::PixelFormat;
+    using ComponentFormat = Texture::ComponentFormat;
+
+    /// Describe an image with the given full resolution and pixel format
+    TileSource(const Vector2i &size, uint32_t tile_size = 256,
+               PixelFormat pixel_format = PixelFormat::RGBA,
+               ComponentFormat component_format = ComponentFormat::UInt8);
+
+    /// Return the resolution of level 0
+    const Vector2i &size() const { return m_size; }
+
+    /// Return the width and height of a tile in pixels
+    uint32_t tile_size() const { return m_tile_size; }
+
+    /// Return the number of levels of the pyramid
+    uint32_t level_count() const { return m_level_count; }
+
+    /// Return the pixel format of the tiles
+    PixelFormat pixel_format() const { return m_pixel_format; }
+
+    /// Return the component format of the tiles
+    ComponentFormat component_format() const { return m_component_format; }
+
+    /// Return the number of channels per pixel
+    size_t channels() const;
+
+    /// Return the number of bytes per pixel
+    size_t bytes_per_pixel() const;
+
+    /// Return the resolution of the given level
+    Vector2i level_size(uint32_t level) const {
+        return (m_size + ((1 << level) - 1)) / (1 << level);
+    }
+
+    /// Return the number of tiles along each axis of the given level
+    Vector2i tile_count(uint32_t level) const {
+        return (level_size(level) + ((int) m_tile_size - 1)) / (int) m_tile_size;
+    }
+
+    /// Return the resolution of a tile (smaller than \ref tile_size() at the right and bottom edge)
+    Vector2i tile_extent(uint32_t level, const Vector2i &index) const {
+        return min(Vector2i((int) m_tile_size),
+                   level_size(level) - index * (int) m_tile_size);
+    }
+
+    /**
+     * \brief Decode a tile
+     *
+     * Writes the tightly packed pixels of the tile with the given index
+     * (<tt>tile_extent(level, index)</tt> pixels in row-major order) to
+     * \c data. This function is called by the worker threads of a
+     * \ref TileCache and must therefore be thread-safe.
+     */
+    virtual void load_tile(uint32_t level, const Vector2i &index, uint8_t *data) = 0;
+
+protected:
+    virtual ~TileSource() = default;
+
+protected:
+    Vector2i m_size;
+    uint32_t m_tile_size;
+    uint32_t m_level_count;
+    PixelFormat m_pixel_format;
+    ComponentFormat m_component_format;
+};
+
+/**
+ * \class TileCache tilecache.h nanogui/tilecache.h
+ *
+ * \brief Decodes the tiles of a \ref TileSource on worker threads and keeps
+ * them in GPU textures, evicting the least recently used ones when the
+ * memory budget is exceeded.
+ *
+ * Requested tiles are decoded in the order of the \ref request() calls.
+ * Requests that were not picked up by a worker yet can be withdrawn via
+ * \ref clear_requests(), which makes it possible to re-prioritize the queue
+ * at every frame (e.g. after the view has changed). Decoded tiles are
+ * uploaded on the rendering thread by \ref update().
+ */
+class NANOGUI_EXPORT TileCache : public Object {
+public:
+    /**
+     * \brief Create a cache of the tiles of \c source
+     *
+     * \param memory_budget
+     *     Maximum size of the cached tile textures in bytes
+     *
+     * \param thread_count
+     *     Number of worker threads (0: one per hardware thread)
+     */
+    TileCache(TileSource *source, size_t memory_budget = 256 * 1024 * 1024,
+              size_t thread_count = 0);
+
+    /// Return the tile source
+    TileSource *source() { return m_source; }
+    /// Return the tile source (const version)
+    const TileSource *source() const { return m_source.get(); }
+
+    /// Return the maximum size of the cached tile textures in bytes
+    size_t memory_budget() const { return m_memory_budget; }
+    /// Set the maximum size of the cached tile textures in bytes
+    void set_memory_budget(size_t memory_budget) { m_memory_budget = memory_budget; }
+
+    /// Return the size of the cached tile textures in bytes
+    size_t memory_usage() const { return m_memory_usage; }
+
+    /// Return the number of tiles that are currently resident on the GPU
+    size_t resident_count() const { return m_tiles.size(); }
+
+    /// Return the number of tiles that are waiting to be decoded or uploaded
+    size_t pending_count() const;
+
+    /**
+     * \brief Return the texture of a resident tile (or \c nullptr)
+     *
+     * Marks the tile as most recently used.
+     */
+    Texture *tile(uint32_t level, const Vector2i &index);
+
+    /**
+     * \brief Queue a tile for decoding unless it is resident, already
+     * pending, or failed to load before
+     */
+    void request(uint32_t level, const Vector2i &index);
+
+    /// Return the number of tiles whose \ref TileSource::load_tile() call threw an exception
+    size_t failed_count() const;
+
+    /// Forget about tiles that failed to load, so that they can be requested again
+    void clear_failures();
+
+    /// Withdraw all requests that were not picked up by a worker thread yet
+    void clear_requests();
+
+    /**
+     * \brief Upload decoded tiles to the GPU, evicting the least recently
+     * used ones to stay within the memory budget
+     *
+     * Tiles that were used since the previous call are never evicted, hence
+     * the budget is exceeded when the visible tiles alone don't fit. Returns
+     * \c true if any tile was uploaded.
+     */
+    bool update();
+
+    /**
+     * \brief Redraw \c screen once the next tile has been decoded
+     *
+     * The request is one-shot and must be renewed (typically at every
+     * frame). Pass \c nullptr to cancel it.
+     */
+    void request_notification(Screen *screen);
+
+    /**
+     * \brief Stop the worker threads and drop all pending requests
+     *
+     * Resident tiles remain usable, but further requests are ignored.
+     */
+    void shutdown();
+
+protected:
+    /// Calls \ref shutdown()
+    virtual ~TileCache();
+
+    static uint64_t key(uint32_t level, const Vector2i &index) {
+        return ((uint64_t) level << 56) | ((uint64_t) (uint32_t) index.y() << 28) |
+               (uint64_t) (uint32_t) index.x();
+    }
+
+    void worker();
+
+protected:
+    struct Tile {
+        ref<Texture> texture;
+        std::list<uint64_t>::iterator lru;
+        size_t frame;
+    };
+
+    struct Request {
+        uint64_t key;
+        uint32_t level;
+        Vector2i index;
+    };
+
+    struct Decoded {
+        Request request;
+        std::unique_ptr<uint8_t[]> data;
+    };
+
+    ref<TileSource> m_source;
+    size_t m_memory_budget;
+    size_t m_memory_usage = 0;
+    size_t m_frame = 0;
+
+    /* Resident tiles (only accessed by the rendering thread); the front of
+       'm_lru' is the most recently used tile */
+    std::unordered_map<uint64_t, Tile> m_tiles;
+    std::list<uint64_t> m_lru;
+
+    /* State shared with the worker threads. 'm_pending' contains the keys
+       of all queued, in-progress, and decoded (but not uploaded) tiles */
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_queue;
+    std::vector<Decoded> m_decoded;
+    std::unordered_set<uint64_t> m_pending;
+    /// Tiles that failed to load, which \ref request() ignores
+    std::unordered_set<uint64_t> m_failed;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+
+    std::atomic<bool> m_armed { false };
+    std::atomic<Screen *> m_screen { nullptr };
+};
+
+NAMESPACE_END(nanogui)
@@ -1,6 +1,7 @@
 #ifdef NANOGUI_PYTHON
 
 #include "python.h"
+#include <pybind11/numpy.h>
 
 class PyCanvas : public Canvas {
 public:
@@ -22,13 +23,38 @@ public:
     }
 };
 
+class PySpectrogram : public Spectrogram {
+public:
+    using Spectrogram::Spectrogram;
+    NANOGUI_WIDGET_OVERLOADS(Spectrogram);
+
+    void draw_contents() override {
+        PYBIND11_OVERLOAD(void, Spectrogram, draw_contents);
+    }
+};
+
+class PyScatterPlot : public ScatterPlot {
+public:
+    using ScatterPlot::ScatterPlot;
+    NANOGUI_WIDGET_OVERLOADS(ScatterPlot);
+
+    void draw_contents() override {
+        PYBIND11_OVERLOAD(void, ScatterPlot, draw_contents);
+    }
+};
+
 void register_canvas(py::module &m) {
     py::class_<Canvas, Widget, ref<Canvas>, PyCanvas>(m, "Canvas", D(Canvas))
-        .def(py::init<Widget *, uint8_t, bool, bool, bool>(),
+        .def(py::init<Widget *, uint8_t, bool, bool, bool, bool>(),
              "parent"_a, "samples"_a = 4, "has_depth_buffer"_a = true,
              "has_stencil_buffer"_a = false,
-             "clear"_a = true, D(Canvas, Canvas))
+             "clear"_a = true, "deferred"_a = false, D(Canvas, Canvas))
         .def("render_pass", &Canvas::render_pass, D(Canvas, render_pass))
+        .def("deferred", &Canvas::deferred, D(Canvas, deferred))
+        .def("retained", &Canvas::retained, D(Canvas, retained))
+        .def("set_retained", &Canvas::set_retained, D(Canvas, set_retained))
+        .def("content_dirty", &Canvas::content_dirty, D(Canvas, content_dirty))
+        .def("set_content_dirty", &Canvas::set_content_dirty, D(Canvas, set_content_dirty))
         .def("draw_border", &Canvas::draw_border, D(Canvas, draw_border))
         .def("set_draw_border", &Canvas::set_draw_border, D(Canvas, set_draw_border))
         .def("border_color", &Canvas::border_color, D(Canvas, border_color))
@@ -41,12 +67,19 @@ void register_canvas(py::module &m) {
         .def(py::init<Widget *>(), D(ImageView, ImageView))
         .def("image", py::overload_cast<>(&ImageView::image, py::const_), D(ImageView, image))
         .def("set_image", &ImageView::set_image, D(ImageView, set_image))
+        .def("stream", &ImageView::stream, D(ImageView, stream))
+        .def("set_stream", &ImageView::set_stream, D(ImageView, set_stream))
+        .def("tile_cache", &ImageView::tile_cache, D(ImageView, tile_cache))
+        .def("set_tile_cache", &ImageView::set_tile_cache, D(ImageView, set_tile_cache))
+        .def("image_size", &ImageView::image_size, D(ImageView, image_size))
         .def("reset", &ImageView::reset, D(ImageView, reset))
         .def("center", &ImageView::center, D(ImageView, center))
         .def("offset", &ImageView::offset, D(ImageView, offset))
         .def("set_offset", &ImageView::set_offset, D(ImageView, set_offset))
         .def("scale", &ImageView::scale, D(ImageView, scale))
         .def("set_scale", &ImageView::set_scale, D(ImageView, set_scale))
+        .def("sdf_text", &ImageView::sdf_text, D(ImageView, sdf_text))
+        .def("set_sdf_text", &ImageView::set_sdf_text, D(ImageView, set_sdf_text))
         .def("pos_to_pixel", &ImageView::pos_to_pixel, D(ImageView, pos_to_pixel))
         .def("pixel_to_pos", &ImageView::pixel_to_pos, D(ImageView, pixel_to_pos))
         .def("set_pixel_callback",
@@ -59,6 +92,75 @@ void register_canvas(py::module &m) {
                 });
              },
              D(ImageView, set_pixel_callback));
+
+    auto spectrogram =
+        py::class_<Spectrogram, Canvas, ref<Spectrogram>, PySpectrogram>(
+            m, "Spectrogram", D(Spectrogram));
+
+    py::enum_<Spectrogram::Colormap>(spectrogram, "Colormap", D(Spectrogram, Colormap))
+        .value("Grayscale", Spectrogram::Colormap::Grayscale)
+        .value("Viridis", Spectrogram::Colormap::Viridis)
+        .value("Inferno", Spectrogram::Colormap::Inferno);
+
+    spectrogram
+        .def(py::init<Widget *, size_t, size_t>(), "parent"_a, "bins"_a = 256,
+             "history"_a = 512, D(Spectrogram, Spectrogram))
+        .def("bins", &Spectrogram::bins, D(Spectrogram, bins))
+        .def("history", &Spectrogram::history, D(Spectrogram, history))
+        .def("set_shape", &Spectrogram::set_shape, D(Spectrogram, set_shape))
+        .def("range", &Spectrogram::range, D(Spectrogram, range))
+        .def("set_range", &Spectrogram::set_range, D(Spectrogram, set_range))
+        .def("push_columns",
+             [](Spectrogram &s, py::array_t<float, py::array::c_style |
+                                                   py::array::forcecast> values) {
+                 if (values.size() % s.bins() != 0)
+                     throw py::value_error("Spectrogram::push_columns(): array size "
+                                           "must be a multiple of the number of bins!");
+                 s.push_columns(values.data(), (size_t) values.size() / s.bins());
+             }, D(Spectrogram, push_columns))
+        .def("column_count", &Spectrogram::column_count, D(Spectrogram, column_count))
+        .def("clear", &Spectrogram::clear, D(Spectrogram, clear))
+        .def("set_colormap", py::overload_cast<Spectrogram::Colormap>(&Spectrogram::set_colormap),
+             D(Spectrogram, set_colormap))
+        .def("set_colormap", py::overload_cast<const std::vector<Color> &>(&Spectrogram::set_colormap),
+             D(Spectrogram, set_colormap, 2));
+
+    py::class_<ScatterPlot, Canvas, ref<ScatterPlot>, PyScatterPlot>(
+        m, "ScatterPlot", D(ScatterPlot))
+        .def(py::init<Widget *>(), "parent"_a, D(ScatterPlot, ScatterPlot))
+        .def("set_points",
+             [](ScatterPlot &plot,
+                py::array_t<float, py::array::c_style | py::array::forcecast> positions,
+                std::optional<py::array_t<float, py::array::c_style |
+                                                 py::array::forcecast>> colors) {
+                 if (positions.ndim() != 2 || positions.shape(1) != 2)
+                     throw py::value_error("ScatterPlot::set_points(): positions "
+                                           "must have shape (N, 2)!");
+                 size_t count = (size_t) positions.shape(0);
+                 if (colors && (colors->ndim() != 2 || (size_t) colors->shape(0) != count ||
+                                colors->shape(1) != 4))
+                     throw py::value_error("ScatterPlot::set_points(): colors "
+                                           "must have shape (N, 4)!");
+                 plot.set_points(positions.data(), count,
+                                 colors ? colors->data() : nullptr);
+             }, "positions"_a, "colors"_a = py::none(), D(ScatterPlot, set_points))
+        .def("point_count", &ScatterPlot::point_count, D(ScatterPlot, point_count))
+        .def("point", &ScatterPlot::point, D(ScatterPlot, point))
+        .def("point_size", &ScatterPlot::point_size, D(ScatterPlot, point_size))
+        .def("set_point_size", &ScatterPlot::set_point_size, D(ScatterPlot, set_point_size))
+        .def("point_color", &ScatterPlot::point_color, D(ScatterPlot, point_color))
+        .def("set_point_color", &ScatterPlot::set_point_color, D(ScatterPlot, set_point_color))
+        .def("view_min", &ScatterPlot::view_min, D(ScatterPlot, view_min))
+        .def("view_max", &ScatterPlot::view_max, D(ScatterPlot, view_max))
+        .def("set_view", &ScatterPlot::set_view, D(ScatterPlot, set_view))
+        .def("reset_view", &ScatterPlot::reset_view, D(ScatterPlot, reset_view))
+        .def("pos_to_point", &ScatterPlot::pos_to_point, D(ScatterPlot, pos_to_point))
+        .def("point_to_pos", &ScatterPlot::point_to_pos, D(ScatterPlot, point_to_pos))
+        .def("pick", &ScatterPlot::pick, "pos"_a, "radius"_a, D(ScatterPlot, pick))
+        .def("hovered_point", &ScatterPlot::hovered_point, D(ScatterPlot, hovered_point))
+        .def("hover_callback", &ScatterPlot::hover_callback, D(ScatterPlot, hover_callback))
+        .def("set_hover_callback", &ScatterPlot::set_hover_callback,
+             D(ScatterPlot, set_hover_callback));
 }
 
 #endif
@@ -229,6 +229,7 @@ PYBIND11_MODULE(nanogui, m) {
         m.def("chdir_to_bundle_parent", &nanogui::chdir_to_bundle_parent);
     #endif
     m.def("utf8", [](int c) { return std::string(utf8(c).data()); }, D(utf8));
+    m.def("image_directory_files", &nanogui::image_directory_files, D(image_directory_files));
     m.def("load_image_directory", &nanogui::load_image_directory, D(load_image_directory));
 
     py::enum_<Cursor>(m, "Cursor", D(Cursor))
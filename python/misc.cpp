@@ -1,12 +1,35 @@
 #ifdef NANOGUI_PYTHON
 
 #include "python.h"
+#include <pybind11/numpy.h>
 
 DECLARE_WIDGET(ColorWheel);
 DECLARE_WIDGET(ColorPicker);
 DECLARE_WIDGET(Graph);
+DECLARE_WIDGET(Histogram);
 DECLARE_WIDGET(ImagePanel);
 
+/// Borrow a 1D float32 array (possibly strided) without copying it
+static std::tuple<const float *, size_t, ptrdiff_t> graph_series_span(py::array array) {
+    if (array.ndim() != 1 || !array.dtype().is(py::dtype::of<float>()))
+        throw py::type_error("Graph: series must be 1D float32 arrays!");
+    if (array.strides(0) % (ssize_t) sizeof(float) != 0)
+        throw py::type_error("Graph: series stride must be a multiple of the element size!");
+    return { (const float *) array.data(), (size_t) array.shape(0),
+             (ptrdiff_t) (array.strides(0) / (ssize_t) sizeof(float)) };
+}
+
+/// Return the list that keeps the arrays of a graph's series alive (one entry per series)
+static py::list graph_series_arrays(py::object self) {
+    if (!py::hasattr(self, "_series"))
+        py::setattr(self, "_series", py::list());
+    py::list arrays = self.attr("_series");
+    size_t count = self.cast<Graph &>().series_count();
+    while (arrays.size() < count)
+        arrays.append(py::none());
+    return arrays;
+}
+
 void register_misc(py::module &m) {
     py::class_<ColorWheel, Widget, ref<ColorWheel>, PyColorWheel>(m, "ColorWheel", D(ColorWheel))
         .def(py::init<Widget *>(), "parent"_a, D(ColorWheel, ColorWheel))
@@ -26,7 +49,26 @@ void register_misc(py::module &m) {
         .def("final_callback", &ColorPicker::final_callback, D(ColorPicker, final_callback))
         .def("set_final_callback", &ColorPicker::set_final_callback, D(ColorPicker, set_final_callback));
 
-    py::class_<Graph, Widget, ref<Graph>, PyGraph>(m, "Graph", D(Graph))
+    py::class_<SampleChannel, Object, ref<SampleChannel>>(m, "SampleChannel", D(SampleChannel))
+        .def(py::init<size_t>(), "capacity"_a = 1 << 16, D(SampleChannel, SampleChannel))
+        .def("capacity", &SampleChannel::capacity, D(SampleChannel, capacity))
+        .def("size", &SampleChannel::size, D(SampleChannel, size))
+        .def("dropped", &SampleChannel::dropped, D(SampleChannel, dropped))
+        .def("push", [](SampleChannel &channel,
+                        py::array_t<float, py::array::c_style | py::array::forcecast> values) {
+                 return channel.push(values.data(), (size_t) values.size());
+             }, "values"_a, D(SampleChannel, push))
+        .def("push", py::overload_cast<float>(&SampleChannel::push),
+             "value"_a, D(SampleChannel, push, 2));
+
+    auto graph = py::class_<Graph, Widget, ref<Graph>, PyGraph>(m, "Graph", D(Graph),
+                                                                py::dynamic_attr());
+
+    py::enum_<Graph::Decimation>(graph, "Decimation", D(TimeSeries, Decimation))
+        .value("MinMax", Graph::Decimation::MinMax, D(TimeSeries, Decimation, MinMax))
+        .value("LTTB", Graph::Decimation::LTTB, D(TimeSeries, Decimation, LTTB));
+
+    graph
         .def(py::init<Widget *, const std::string &>(), "parent"_a,
              "caption"_a = std::string("Untitled"), D(Graph, Graph))
         .def("caption", &Graph::caption, D(Graph, caption))
@@ -44,7 +86,81 @@ void register_misc(py::module &m) {
         .def("text_color", &Graph::text_color, D(Graph, text_color))
         .def("set_text_color", &Graph::set_text_color, D(Graph, set_text_color))
         .def("values", (std::vector<float> &(Graph::*)(void)) &Graph::values, D(Graph, values))
-        .def("set_values", &Graph::set_values, D(Graph, set_values));
+        .def("set_values", &Graph::set_values, D(Graph, set_values))
+        .def("decimation", &Graph::decimation, D(Graph, decimation))
+        .def("set_decimation", &Graph::set_decimation, D(Graph, set_decimation))
+        .def("stream_capacity", &Graph::stream_capacity, D(Graph, stream_capacity))
+        .def("set_stream_capacity", &Graph::set_stream_capacity, D(Graph, set_stream_capacity))
+        .def("push_sample", &Graph::push_sample, D(Graph, push_sample))
+        .def("push_samples", [](Graph &graph, const std::vector<float> &values) {
+                 graph.push_samples(values.data(), values.size());
+             }, D(Graph, push_samples))
+        .def("clear_stream", &Graph::clear_stream, D(Graph, clear_stream))
+        .def("add_series", [](py::object self, py::array array, const Color &stroke_color,
+                              const Color &fill_color) {
+                 auto [data, size, stride] = graph_series_span(array);
+                 py::list arrays = graph_series_arrays(self);
+                 size_t index = self.cast<Graph &>().add_series(data, size, stride,
+                                                                stroke_color, fill_color);
+                 arrays.append(array);
+                 return index;
+             }, "array"_a, "stroke_color"_a = Color(100, 255), "fill_color"_a = Color(0, 0),
+             D(Graph, add_series))
+        .def("set_series_data", [](py::object self, size_t index, py::array array) {
+                 auto [data, size, stride] = graph_series_span(array);
+                 self.cast<Graph &>().set_series_data(index, data, size, stride);
+                 graph_series_arrays(self)[index] = array;
+             }, "index"_a, "array"_a, D(Graph, set_series_data))
+        .def("series_count", &Graph::series_count, D(Graph, series_count))
+        .def("clear_series", [](py::object self) {
+                 self.cast<Graph &>().clear_series();
+                 py::setattr(self, "_series", py::list());
+             }, D(Graph, clear_series))
+        .def("series_visible", &Graph::series_visible, D(Graph, series_visible))
+        .def("set_series_visible", &Graph::set_series_visible, D(Graph, set_series_visible))
+        .def("series_stroke_color", &Graph::series_stroke_color, D(Graph, series_stroke_color))
+        .def("set_series_stroke_color", &Graph::set_series_stroke_color, D(Graph, set_series_stroke_color))
+        .def("series_fill_color", &Graph::series_fill_color, D(Graph, series_fill_color))
+        .def("set_series_fill_color", &Graph::set_series_fill_color, D(Graph, set_series_fill_color))
+        .def("channel", &Graph::channel, D(Graph, channel))
+        .def("set_channel", &Graph::set_channel, D(Graph, set_channel))
+        .def("gpu_rendering", &Graph::gpu_rendering, D(Graph, gpu_rendering))
+        .def("set_gpu_rendering", &Graph::set_gpu_rendering, D(Graph, set_gpu_rendering));
+
+    py::class_<Histogram, Widget, ref<Histogram>, PyHistogram>(m, "Histogram", D(Histogram),
+                                                             py::dynamic_attr())
+        .def(py::init<Widget *, const std::string &>(), "parent"_a,
+             "caption"_a = std::string("Untitled"), D(Histogram, Histogram))
+        .def("caption", &Histogram::caption, D(Histogram, caption))
+        .def("set_caption", &Histogram::set_caption, D(Histogram, set_caption))
+        .def("background_color", &Histogram::background_color, D(Histogram, background_color))
+        .def("set_background_color", &Histogram::set_background_color, D(Histogram, set_background_color))
+        .def("bar_color", &Histogram::bar_color, D(Histogram, bar_color))
+        .def("set_bar_color", &Histogram::set_bar_color, D(Histogram, set_bar_color))
+        .def("text_color", &Histogram::text_color, D(Histogram, text_color))
+        .def("set_text_color", &Histogram::set_text_color, D(Histogram, set_text_color))
+        .def("set_data", [](py::object self, py::array array) {
+                 if (array.ndim() != 1 || !array.dtype().is(py::dtype::of<float>()) ||
+                     (array.shape(0) > 1 && array.strides(0) != (ssize_t) sizeof(float)))
+                     throw py::type_error("Histogram::set_data(): expected a contiguous "
+                                          "1D float32 array!");
+                 self.cast<Histogram &>().set_data((const float *) array.data(),
+                                                   (size_t) array.shape(0));
+                 /* Keep only the current array alive (keep_alive would
+                    accumulate every array ever passed) */
+                 py::setattr(self, "_data", array);
+             }, "array"_a, D(Histogram, set_data))
+        .def("size", &Histogram::size, D(Histogram, size))
+        .def("invalidate", &Histogram::invalidate, D(Histogram, invalidate))
+        .def("bin_count", &Histogram::bin_count, D(Histogram, bin_count))
+        .def("set_bin_count", &Histogram::set_bin_count, D(Histogram, set_bin_count))
+        .def("range", &Histogram::range, D(Histogram, range))
+        .def("set_range", &Histogram::set_range, D(Histogram, set_range))
+        .def("thread_count", &Histogram::thread_count, D(Histogram, thread_count))
+        .def("set_thread_count", &Histogram::set_thread_count, D(Histogram, set_thread_count))
+        .def("update", &Histogram::update, D(Histogram, update))
+        .def("counts", &Histogram::counts, D(Histogram, counts))
+        .def("outlier_count", &Histogram::outlier_count, D(Histogram, outlier_count));
 
     py::class_<ImagePanel, Widget, ref<ImagePanel>, PyImagePanel>(m, "ImagePanel", D(ImagePanel))
         .def(py::init<Widget *>(), "parent"_a, D(ImagePanel, ImagePanel))
@@ -194,6 +194,46 @@ static const char *__doc_nanogui_Array_z = R"doc()doc";
 
 static const char *__doc_nanogui_Array_z_2 = R"doc()doc";
 
+static const char *__doc_nanogui_AsyncTexture =
+R"doc(Handle to an image that is being loaded by a TextureLoader
+
+Until the image has been decoded and uploaded, texture() returns a
+placeholder texture, so that the handle can be used right away.)doc";
+
+static const char *__doc_nanogui_AsyncTexture_AsyncTexture = R"doc()doc";
+
+static const char *__doc_nanogui_AsyncTexture_State = R"doc()doc";
+
+static const char *__doc_nanogui_AsyncTexture_State_Failed = R"doc(The image could not be loaded (see error()))doc";
+
+static const char *__doc_nanogui_AsyncTexture_State_Pending = R"doc(The image is being decoded or waiting to be uploaded)doc";
+
+static const char *__doc_nanogui_AsyncTexture_State_Ready = R"doc(The image was uploaded to the GPU)doc";
+
+static const char *__doc_nanogui_AsyncTexture_error = R"doc(Return the reason why loading failed)doc";
+
+static const char *__doc_nanogui_AsyncTexture_filename = R"doc(Return the name of the loaded file)doc";
+
+static const char *__doc_nanogui_AsyncTexture_nvg_image =
+R"doc(Return the NanoVG image handle (for requests made via
+TextureLoader::load_nvg_image()), or 0 while the image is pending
+
+As with ``nvgCreateImage()``, the caller is responsible for deleting
+the image.)doc";
+
+static const char *__doc_nanogui_AsyncTexture_ready = R"doc(Has the image been uploaded to the GPU?)doc";
+
+static const char *__doc_nanogui_AsyncTexture_set_callback =
+R"doc(Set a function that is called on the rendering thread once the image
+is ready or failed to load (immediately, if that is already the case))doc";
+
+static const char *__doc_nanogui_AsyncTexture_state = R"doc(Return the loading state)doc";
+
+static const char *__doc_nanogui_AsyncTexture_texture =
+R"doc(Return the texture (for requests made via TextureLoader::load()), or
+the loader's placeholder while the image is pending or if it failed to
+load)doc";
+
 static const char *__doc_nanogui_BoxLayout = R"doc()doc";
 
 static const char *__doc_nanogui_BoxLayout_2 =
@@ -383,6 +423,16 @@ This is useful to display and manipulate 3D objects as part of an
 interactive application. The implementation uses scissoring to ensure
 that rendered objects don't spill into neighboring widgets.
 
+By default, the canvas flushes the pending NanoVG commands before
+running its render pass, which splits the widgets into several
+batches. A *deferred* canvas instead renders into a texture right away
+and draws it as a NanoVG image, so that the whole frame is submitted
+in one batch.
+
+A *retained* canvas that renders into a texture only runs its render
+pass when its content was marked as changed via set_content_dirty()
+(or when it was resized), and otherwise reuses the previous image.
+
 \rst **Usage** Override :func:`nanogui::GLCanvas::draw_contents` in
 subclasses to provide custom drawing code. See
 :ref:`nanogui_example_4`.
@@ -409,12 +459,20 @@ Parameter ``has_stencil_buffer``:
     render pass?
 
 Parameter ``clear``:
-    Should the widget clear its color/depth/stencil buffer?)doc";
+    Should the widget clear its color/depth/stencil buffer?
+
+Parameter ``deferred``:
+    Render into a texture that NanoVG draws along with the other
+    widgets, instead of flushing NanoVG before the render pass?)doc";
 
 static const char *__doc_nanogui_Canvas_background_color = R"doc(Return whether the widget border is drawn)doc";
 
 static const char *__doc_nanogui_Canvas_border_color = R"doc(Return whether the widget border is drawn)doc";
 
+static const char *__doc_nanogui_Canvas_content_dirty = R"doc(Will a retained canvas re-render its contents in the next frame?)doc";
+
+static const char *__doc_nanogui_Canvas_deferred = R"doc(Is the canvas drawn as a NanoVG image (without flushing NanoVG)?)doc";
+
 static const char *__doc_nanogui_Canvas_draw = R"doc(Draw the widget)doc";
 
 static const char *__doc_nanogui_Canvas_draw_border = R"doc(Return whether the widget border will be drawn)doc";
@@ -431,12 +489,29 @@ static const char *__doc_nanogui_Canvas_m_render_to_texture = R"doc()doc";
 
 static const char *__doc_nanogui_Canvas_render_pass = R"doc(Return the render pass associated with the canvas object)doc";
 
+static const char *__doc_nanogui_Canvas_retained =
+R"doc(Return whether the contents are only re-rendered when marked as
+changed)doc";
+
 static const char *__doc_nanogui_Canvas_set_background_color = R"doc(Specify the widget background color)doc";
 
 static const char *__doc_nanogui_Canvas_set_border_color = R"doc(Specify the widget border color)doc";
 
+static const char *__doc_nanogui_Canvas_set_content_dirty =
+R"doc(Mark the contents as changed, so that a retained canvas re-renders
+them)doc";
+
 static const char *__doc_nanogui_Canvas_set_draw_border = R"doc(Specify whether to draw the widget border)doc";
 
+static const char *__doc_nanogui_Canvas_set_retained =
+R"doc(Only re-render the contents when they were marked as changed?
+
+The output of draw_contents() must then be invalidated via
+set_content_dirty() whenever it changes, which the built-in subclasses
+(ImageView, ScatterPlot, Spectrogram) do themselves. This has no
+effect on canvases that render directly into the screen framebuffer,
+whose contents do not persist across frames.)doc";
+
 static const char *__doc_nanogui_CheckBox =
 R"doc(\class CheckBox checkbox.h nanogui/checkbox.h
 
@@ -1010,23 +1085,118 @@ static const char *__doc_nanogui_GLFramebuffer = R"doc()doc";
 
 static const char *__doc_nanogui_GLShader = R"doc()doc";
 
+static const char *__doc_nanogui_GLState =
+R"doc(Shadow copy of the OpenGL state that NanoGUI modifies
+
+RenderPass, Shader, Texture, and Screen route their state changes
+through this class, which skips calls that would not change anything,
+and which never queries the driver. Values that are unknown (after
+invalidate()) are always sent to OpenGL.
+
+A single tracker is shared by all contexts. Screens invalidate it when
+they make their context current and after NanoVG has rendered, since
+NanoVG changes the state directly. Code that changes the tracked state
+via raw OpenGL calls (e.g. in Canvas::draw_contents()) must do the
+same.)doc";
+
+static const char *__doc_nanogui_GLState_current = R"doc(Return the tracker)doc";
+
+static const char *__doc_nanogui_GLState_framebuffer = R"doc(Return the framebuffer that is bound for drawing (0 if unknown))doc";
+
+static const char *__doc_nanogui_GLState_invalidate =
+R"doc(Forget all cached values, so that the next change of each is sent to
+OpenGL)doc";
+
+static const char *__doc_nanogui_GLState_redundant_calls =
+R"doc(Return the number of calls that were skipped because they would not
+have changed the state)doc";
+
+static const char *__doc_nanogui_GLState_reset_redundant_calls = R"doc(Reset the counter of skipped calls)doc";
+
+static const char *__doc_nanogui_GPUTimer =
+R"doc(Measures the GPU time of intervals of rendering commands
+
+On OpenGL, each interval between begin() and end() is measured with a
+``GL_TIME_ELAPSED`` query. The results become available a few frames
+later and are collected without stalling by subsequent calls to
+begin() or collect(). Intervals of different timers cannot be nested;
+the inner one is not measured. Timer queries require OpenGL 3.3 (or
+``ARB_timer_query``), or GLES 3 with ``EXT_disjoint_timer_query``.
+
+On Metal, begin() and end() do nothing. Render passes instead report
+the execution time of their command buffers via add_sample().)doc";
+
+static const char *__doc_nanogui_GPUTimer_GPUTimer = R"doc(Create a timer)doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats = R"doc(Statistics of the measured intervals (in milliseconds))doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_last = R"doc(Most recent measurement)doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_samples = R"doc(Number of measurements)doc";
+
+static const char *__doc_nanogui_GPUTimer_add_sample = R"doc(Record a measurement in milliseconds (may be called from any thread))doc";
+
+static const char *__doc_nanogui_GPUTimer_begin = R"doc(Start measuring an interval)doc";
+
+static const char *__doc_nanogui_GPUTimer_collect = R"doc(Collect the results that have become available (never blocks))doc";
+
+static const char *__doc_nanogui_GPUTimer_end = R"doc(Stop measuring an interval)doc";
+
+static const char *__doc_nanogui_GPUTimer_reset = R"doc(Discard all measurements)doc";
+
+static const char *__doc_nanogui_GPUTimer_stats = R"doc(Return the statistics of the measurements collected so far)doc";
+
+static const char *__doc_nanogui_GPUTimer_supported = R"doc(Can GPU time be measured with the current context?)doc";
+
 static const char *__doc_nanogui_Graph =
 R"doc(\class Graph graph.h nanogui/graph.h
 
-Simple graph widget for showing a function plot.)doc";
+Simple graph widget for showing a function plot.
+
+The plotted values (which should lie in the interval [0, 1]) either
+come from a plain array (values()) or, when a stream capacity has been
+set, from a TimeSeries ring buffer that is fed incrementally via
+push_sample(). In both cases, long series are decimated to at most two
+vertices per horizontal pixel before drawing.)doc";
 
 static const char *__doc_nanogui_Graph_Graph = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_add_series =
+R"doc(Add a series that is drawn on top of the main one, sharing its
+background, value range and labels
+
+The samples are not copied: ``data`` must remain valid while the graph
+exists (or until it is replaced via set_series_data()), and it is re-
+read whenever the graph is drawn. The ``stride`` (in elements) allows
+plotting e.g. one channel of an interleaved buffer. Each series spans
+the full width of the graph. Returns the index of the new series.)doc";
+
 static const char *__doc_nanogui_Graph_background_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_caption = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_channel = R"doc(Return the channel that is drained into the stream (if any))doc";
+
+static const char *__doc_nanogui_Graph_clear_series = R"doc(Remove all series added via add_series())doc";
+
+static const char *__doc_nanogui_Graph_clear_stream = R"doc(Remove all streamed samples)doc";
+
+static const char *__doc_nanogui_Graph_decimation = R"doc(Return the decimation strategy used for long series)doc";
+
+static const char *__doc_nanogui_Graph_drain_channel = R"doc(Append the contents of m_channel to the stream)doc";
+
 static const char *__doc_nanogui_Graph_draw = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_draw_polyline =
+R"doc(Stroke and fill a polyline in normalized coordinates, whose X range
+``[0, 1]`` maps to the horizontal interval starting at ``x0``)doc";
+
 static const char *__doc_nanogui_Graph_fill_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_footer = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_gpu_rendering = R"doc(Is the stream rendered using a shader instead of NanoVG?)doc";
+
 static const char *__doc_nanogui_Graph_header = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_m_background_color = R"doc()doc";
@@ -1047,22 +1217,78 @@ static const char *__doc_nanogui_Graph_m_values = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_preferred_size = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_push_sample = R"doc(Append a sample to the stream (requires set_stream_capacity()))doc";
+
+static const char *__doc_nanogui_Graph_push_samples = R"doc(Append several samples to the stream (requires set_stream_capacity()))doc";
+
+static const char *__doc_nanogui_Graph_series_count = R"doc(Return the number of series added via add_series())doc";
+
+static const char *__doc_nanogui_Graph_series_fill_color = R"doc()doc";
+
+static const char *__doc_nanogui_Graph_series_stroke_color = R"doc()doc";
+
+static const char *__doc_nanogui_Graph_series_visible = R"doc()doc";
+
 static const char *__doc_nanogui_Graph_set_background_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_set_caption = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_set_channel =
+R"doc(Attach a channel that feeds the stream from another thread
+
+Queued samples are appended to the stream once per frame, before the
+graph is drawn, and pushing to an idle channel requests a redraw of
+the screen. Requires set_stream_capacity(). Specify ``nullptr`` to
+detach the current channel.)doc";
+
+static const char *__doc_nanogui_Graph_set_decimation = R"doc(Set the decimation strategy used for long series)doc";
+
 static const char *__doc_nanogui_Graph_set_fill_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_set_footer = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_set_gpu_rendering =
+R"doc(Render the stream using a shader instead of NanoVG
+
+Rather than building a NanoVG path with one vertex per (decimated)
+sample in every frame, new samples are appended to a texture holding
+one value per ring slot, and the vertex shader draws one quad per
+pixel column spanning the minimum and maximum of the curve within it.
+The CPU cost per frame is then proportional to the number of samples
+pushed since the previous frame, and the geometry to the widget width.
+GPU memory amounts to 4 bytes per sample of capacity.
+
+Only has an effect in streaming mode (set_stream_capacity()). Not
+supported on OpenGL ES 2, where NanoVG is always used.)doc";
+
 static const char *__doc_nanogui_Graph_set_header = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_set_series_data = R"doc(Point an existing series to different sample storage)doc";
+
+static const char *__doc_nanogui_Graph_set_series_fill_color = R"doc()doc";
+
+static const char *__doc_nanogui_Graph_set_series_stroke_color = R"doc()doc";
+
+static const char *__doc_nanogui_Graph_set_series_visible = R"doc()doc";
+
+static const char *__doc_nanogui_Graph_set_stream_capacity =
+R"doc(Switch to streaming mode with a ring buffer of the given capacity
+
+In streaming mode, the graph shows the most recent ``capacity``
+samples pushed via push_sample() / push_samples() instead of values().
+Specify zero to return to the array-based mode. Discards previously
+streamed samples.)doc";
+
 static const char *__doc_nanogui_Graph_set_stroke_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_set_text_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_set_values = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_stream_capacity =
+R"doc(Return the capacity of the streaming ring buffer (zero if not
+streaming))doc";
+
 static const char *__doc_nanogui_Graph_stroke_color = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_text_color = R"doc()doc";
@@ -1223,6 +1449,83 @@ static const char *__doc_nanogui_GroupLayout_set_spacing = R"doc(Sets the spacin
 
 static const char *__doc_nanogui_GroupLayout_spacing = R"doc(The spacing between widgets of this GroupLayout.)doc";
 
+static const char *__doc_nanogui_Histogram =
+R"doc(Bar chart of the distribution of a (potentially very large) array of
+samples.
+
+The samples are not copied: the widget references the array passed to
+set_data() and bins it when it is next drawn. Large arrays are split
+into chunks that are binned by several threads into private
+histograms, which are merged afterwards. When set_data() is called
+again with the same pointer and a larger size (i.e. samples were
+appended), only the new samples are binned.
+
+Samples are mapped to bin_count() equally sized bins covering range().
+Samples outside of the range (and NaNs) are not shown, but counted by
+outlier_count().)doc";
+
+static const char *__doc_nanogui_Histogram_Histogram = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_background_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_bar_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_bin_count = R"doc(Return the number of bins)doc";
+
+static const char *__doc_nanogui_Histogram_caption = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_counts = R"doc(Return the number of samples per bin (call update() first))doc";
+
+static const char *__doc_nanogui_Histogram_data = R"doc(Return the binned samples)doc";
+
+static const char *__doc_nanogui_Histogram_draw = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_invalidate = R"doc(Discard the counts, so that all samples are binned again)doc";
+
+static const char *__doc_nanogui_Histogram_outlier_count =
+R"doc(Return the number of samples outside of the range (call update()
+first))doc";
+
+static const char *__doc_nanogui_Histogram_preferred_size = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_range = R"doc(Return the range of values covered by the bins)doc";
+
+static const char *__doc_nanogui_Histogram_set_background_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_set_bar_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_set_bin_count = R"doc(Set the number of bins (triggers a full re-binning))doc";
+
+static const char *__doc_nanogui_Histogram_set_caption = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_set_data =
+R"doc(Set the binned samples
+
+``data`` must remain valid until it is replaced or the widget is
+destroyed. If ``data`` equals the current pointer and ``size`` is at
+least as large as the current size, the existing counts are kept and
+only the samples at index ``size()`` and above are binned later on.
+Call invalidate() when previously binned samples were modified in
+place.)doc";
+
+static const char *__doc_nanogui_Histogram_set_range =
+R"doc(Set the range of values covered by the bins (triggers a full re-
+binning))doc";
+
+static const char *__doc_nanogui_Histogram_set_text_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_set_thread_count = R"doc(Set the maximum number of threads used for binning (0: automatic))doc";
+
+static const char *__doc_nanogui_Histogram_size = R"doc(Return the number of binned samples)doc";
+
+static const char *__doc_nanogui_Histogram_text_color = R"doc()doc";
+
+static const char *__doc_nanogui_Histogram_thread_count = R"doc(Return the maximum number of threads used for binning (0: automatic))doc";
+
+static const char *__doc_nanogui_Histogram_update =
+R"doc(Bring the counts up to date with the data (called automatically by
+draw()))doc";
+
 static const char *__doc_nanogui_ImagePanel = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_2 =
@@ -1280,10 +1583,14 @@ static const char *__doc_nanogui_ImageView_draw = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_draw_contents = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_draw_tiles = R"doc(Draw the visible tiles of the tile cache)doc";
+
 static const char *__doc_nanogui_ImageView_image = R"doc(Return the currently active image)doc";
 
 static const char *__doc_nanogui_ImageView_image_2 = R"doc(Return the currently active image (const version))doc";
 
+static const char *__doc_nanogui_ImageView_image_size = R"doc(Return the size of the image in pixels (zero if there is no image))doc";
+
 static const char *__doc_nanogui_ImageView_keyboard_event = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_m_draw_image_border = R"doc()doc";
@@ -1320,6 +1627,8 @@ static const char *__doc_nanogui_ImageView_scale = R"doc(Return the current magn
 
 static const char *__doc_nanogui_ImageView_scroll_event = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_sdf_text = R"doc(Return whether pixel labels are drawn using signed distance field text)doc";
+
 static const char *__doc_nanogui_ImageView_set_image = R"doc(Set the currently active image)doc";
 
 static const char *__doc_nanogui_ImageView_set_offset = R"doc(Set the pixel offset of the zoomed image rectangle)doc";
@@ -1330,6 +1639,30 @@ components)doc";
 
 static const char *__doc_nanogui_ImageView_set_scale = R"doc(Set the current magnification of the image)doc";
 
+static const char *__doc_nanogui_ImageView_set_sdf_text =
+R"doc(Specify whether pixel labels are drawn using signed distance field
+text (instead of NanoVG))doc";
+
+static const char *__doc_nanogui_ImageView_set_stream =
+R"doc(Display frames from a TextureStream
+
+Sets the image to the stream's texture, and copies the newest
+committed frame into it whenever the widget is drawn. Committing a
+frame triggers a redraw.)doc";
+
+static const char *__doc_nanogui_ImageView_set_tile_cache =
+R"doc(Display a tiled multi-resolution image
+
+Replaces the current image. At every frame, only the tiles of the
+pyramid level matching the current magnification that overlap the
+widget are drawn (and requested from the cache). Tiles that are still
+being decoded are substituted by the closest coarser tile that is
+resident.)doc";
+
+static const char *__doc_nanogui_ImageView_stream = R"doc(Return the stream that feeds the image (if any))doc";
+
+static const char *__doc_nanogui_ImageView_tile_cache = R"doc(Return the cache that provides the tiles of the image (if any))doc";
+
 static const char *__doc_nanogui_IntBox =
 R"doc(\class IntBox textbox.h nanogui/textbox.h
 
@@ -1726,6 +2059,10 @@ static const char *__doc_nanogui_RenderPass_end = R"doc(Finish the render pass)d
 
 static const char *__doc_nanogui_RenderPass_framebuffer_handle = R"doc()doc";
 
+static const char *__doc_nanogui_RenderPass_gpu_timer =
+R"doc(Return the timer of the render pass (``nullptr`` if timing is
+disabled))doc";
+
 static const char *__doc_nanogui_RenderPass_m_active = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_m_blend_backup = R"doc()doc";
@@ -1780,6 +2117,12 @@ static const char *__doc_nanogui_RenderPass_set_cull_mode = R"doc(Specify the cu
 
 static const char *__doc_nanogui_RenderPass_set_depth_test = R"doc(Specify the depth test and depth write mask of this render pass)doc";
 
+static const char *__doc_nanogui_RenderPass_set_gpu_timing =
+R"doc(Measure the GPU time of each execution of the render pass (including
+the blit that end() performs, if any)
+
+The results are available a few frames later via gpu_timer().)doc";
+
 static const char *__doc_nanogui_RenderPass_set_viewport = R"doc(Set the pixel offset and size of the viewport region)doc";
 
 static const char *__doc_nanogui_RenderPass_targets =
@@ -1788,6 +2131,134 @@ associated with this render pass)doc";
 
 static const char *__doc_nanogui_RenderPass_viewport = R"doc(Return the pixel offset and size of the viewport region)doc";
 
+static const char *__doc_nanogui_SampleChannel =
+R"doc(Lock-free single-producer/single-consumer queue of samples
+
+Allows an acquisition thread to feed a Graph without locks, memory
+allocation, or calls to async(). The producer thread calls push(), and
+the graph drains the channel once per frame (see
+Graph::set_channel()). Samples that do not fit into the queue are
+dropped and counted (see dropped()).
+
+To avoid waking up the UI thread for every sample, only the first push
+after each drain requests a redraw of the associated screen.)doc";
+
+static const char *__doc_nanogui_SampleChannel_SampleChannel =
+R"doc(Create a queue holding up to ``capacity`` samples (rounded up to a
+power of two))doc";
+
+static const char *__doc_nanogui_SampleChannel_capacity = R"doc(Return the maximum number of queued samples)doc";
+
+static const char *__doc_nanogui_SampleChannel_dropped =
+R"doc(Return the number of samples that were dropped because the queue was
+full)doc";
+
+static const char *__doc_nanogui_SampleChannel_pop = R"doc(Remove up to ``count`` samples from the queue (consumer thread only))doc";
+
+static const char *__doc_nanogui_SampleChannel_push =
+R"doc(Append samples to the queue (producer thread only)
+
+Returns the number of samples that were queued, which is less than
+``count`` if the queue is full.)doc";
+
+static const char *__doc_nanogui_SampleChannel_push_2 = R"doc(Append a single sample (producer thread only))doc";
+
+static const char *__doc_nanogui_SampleChannel_request_notification =
+R"doc(Request that the next push calls Screen::redraw() on the given screen
+(consumer thread only)
+
+Should be called before draining the queue, so that samples which
+arrive in the meantime are guaranteed to trigger another redraw.
+Specify ``nullptr`` to disable notifications. The request is posted
+via Screen::redraw_async(), so it is harmless if the screen has been
+destroyed in the meantime.)doc";
+
+static const char *__doc_nanogui_SampleChannel_size =
+R"doc(Return the number of queued samples (approximate if called
+concurrently))doc";
+
+static const char *__doc_nanogui_ScatterPlot =
+R"doc(Scatter plot that scales to millions of points
+
+Positions and colors are uploaded to the GPU once (in set_points())
+and rendered as point primitives, so panning (dragging) and zooming
+(mouse wheel) only change a pair of shader uniforms. A uniform grid
+over the point positions is built on the CPU to find the point
+underneath the mouse cursor, which is highlighted and reported via the
+hover callback.)doc";
+
+static const char *__doc_nanogui_ScatterPlot_ScatterPlot = R"doc(Initialize the widget)doc";
+
+static const char *__doc_nanogui_ScatterPlot_draw = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_draw_contents = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_hover_callback =
+R"doc(Return the callback that is invoked when the point underneath the
+mouse cursor changes)doc";
+
+static const char *__doc_nanogui_ScatterPlot_hovered_point = R"doc(Return the index of the point underneath the mouse cursor (or -1))doc";
+
+static const char *__doc_nanogui_ScatterPlot_keyboard_event = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_mouse_drag_event = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_mouse_enter_event = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_mouse_motion_event = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_pick =
+R"doc(Return the index of the point closest to a position relative to the
+widget, or -1 if there is no point within ``radius`` pixels)doc";
+
+static const char *__doc_nanogui_ScatterPlot_point = R"doc(Return the position of the point with the given index)doc";
+
+static const char *__doc_nanogui_ScatterPlot_point_color = R"doc(Return the color that all points are multiplied by)doc";
+
+static const char *__doc_nanogui_ScatterPlot_point_count = R"doc(Return the number of plotted points)doc";
+
+static const char *__doc_nanogui_ScatterPlot_point_size = R"doc(Return the diameter of the points in (logical) pixels)doc";
+
+static const char *__doc_nanogui_ScatterPlot_point_to_pos = R"doc(Convert plot coordinates into a position relative to the widget)doc";
+
+static const char *__doc_nanogui_ScatterPlot_pos_to_point = R"doc(Convert a position relative to the widget into plot coordinates)doc";
+
+static const char *__doc_nanogui_ScatterPlot_reset_view = R"doc(Fit the visible region to the bounding box of the points)doc";
+
+static const char *__doc_nanogui_ScatterPlot_scroll_event = R"doc()doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_hover_callback =
+R"doc(Set a callback that is invoked when the point underneath the mouse
+cursor changes)doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_hovered = R"doc(Update the hovered point, invoking the callback if it changed)doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_point_color = R"doc(Set the color that all points are multiplied by)doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_point_size = R"doc(Set the diameter of the points in (logical) pixels)doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_points =
+R"doc(Set the plotted points
+
+Parameter ``positions``:     Array of ``2 * count`` values with
+interleaved X and Y     coordinates (in arbitrary units)
+
+Parameter ``count``:     Number of points
+
+Parameter ``colors``:     Optional array of ``4 * count`` RGBA values
+in ``[0, 1]`` with     per-point colors, which are multiplied by
+point_color()
+
+Also resets the view so that it encloses all points. Neither array is
+referenced after this call, but a CPU copy of the positions is kept
+for picking.)doc";
+
+static const char *__doc_nanogui_ScatterPlot_set_view = R"doc(Set the visible region)doc";
+
+static const char *__doc_nanogui_ScatterPlot_view_max = R"doc(Return the upper right corner of the visible region)doc";
+
+static const char *__doc_nanogui_ScatterPlot_view_min = R"doc(Return the lower left corner of the visible region)doc";
+
 static const char *__doc_nanogui_Screen = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_2 =
@@ -1988,6 +2459,18 @@ static const char *__doc_nanogui_Screen_nvg_context = R"doc(Return a pointer to
 
 static const char *__doc_nanogui_Screen_nvg_flush = R"doc(Flush all queued up NanoVG rendering commands)doc";
 
+static const char *__doc_nanogui_Screen_nvg_gpu_timer =
+R"doc(Return the timer of NanoVG's rendering (``nullptr`` if timing is
+disabled))doc";
+
+static const char *__doc_nanogui_Screen_nvg_texture_image =
+R"doc(Return a NanoVG image that refers to a texture, for drawing it via
+``nvgImagePattern()`` during the current frame
+
+The image (along with a reference to the texture) is kept until the
+end of the first frame that does not request it. Render targets are
+flipped vertically on OpenGL, so that they appear upright.)doc";
+
 static const char *__doc_nanogui_Screen_perform_layout = R"doc(Compute the layout of all widgets)doc";
 
 static const char *__doc_nanogui_Screen_pixel_format = R"doc(Return the pixel format underlying the screen)doc";
@@ -2000,6 +2483,13 @@ static const char *__doc_nanogui_Screen_redraw =
 R"doc(Send an event that will cause the screen to be redrawn at the next
 event loop iteration)doc";
 
+static const char *__doc_nanogui_Screen_redraw_async =
+R"doc(Thread-safe variant of redraw() for producer threads
+
+Does nothing if ``screen`` is null or has already been destroyed, so
+that background threads holding a plain pointer to a screen cannot
+touch a dangling object.)doc";
+
 static const char *__doc_nanogui_Screen_resize_callback = R"doc(Set the resize callback)doc";
 
 static const char *__doc_nanogui_Screen_resize_callback_event = R"doc()doc";
@@ -2012,6 +2502,13 @@ static const char *__doc_nanogui_Screen_set_background = R"doc(Set the screen's
 
 static const char *__doc_nanogui_Screen_set_caption = R"doc(Set the window title bar caption)doc";
 
+static const char *__doc_nanogui_Screen_set_nvg_gpu_timing =
+R"doc(Measure the GPU time of NanoVG's rendering, i.e. of nvg_flush() and of
+the end of each frame (OpenGL only)
+
+Each flush is measured separately. Use RenderPass::set_gpu_timing() to
+measure the render passes of canvases.)doc";
+
 static const char *__doc_nanogui_Screen_set_resize_callback = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_set_shutdown_glfw = R"doc(Shut down GLFW when the window is closed?)doc";
@@ -2022,8 +2519,18 @@ static const char *__doc_nanogui_Screen_set_visible = R"doc(Set the top-level wi
 
 static const char *__doc_nanogui_Screen_shutdown_glfw = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_texture_loader =
+R"doc(Return the loader that decodes images for this screen on worker
+threads (created on first use)
+
+Decoded images are uploaded at the beginning of each frame.)doc";
+
 static const char *__doc_nanogui_Screen_tooltip_fade_in_progress = R"doc(Is a tooltip currently fading in?)doc";
 
+static const char *__doc_nanogui_Screen_uniform_ring =
+R"doc(Return the ring buffer that streams the uniform blocks of all shaders
+drawing into this screen (created on first use))doc";
+
 static const char *__doc_nanogui_Screen_update_focus = R"doc()doc";
 
 static const char *__doc_nanogui_Serializer = R"doc()doc";
@@ -2032,6 +2539,14 @@ static const char *__doc_nanogui_Shader = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_2 = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_BindingHandle =
+R"doc(Handle to a named shader parameter
+
+Resolving a name once via binding() and passing the handle to
+set_buffer(), set_uniform(), or set_texture() avoids a string lookup
+per call, which matters when many small draws update their parameters
+in a loop.)doc";
+
 static const char *__doc_nanogui_Shader_BlendMode = R"doc(Alpha blending mode)doc";
 
 static const char *__doc_nanogui_Shader_BlendMode_AlphaBlend = R"doc()doc";
@@ -2060,6 +2575,21 @@ static const char *__doc_nanogui_Shader_BufferType_VertexSampler = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_BufferType_VertexTexture = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_BufferUsage = R"doc(Update frequency of a vertex or index buffer (see set_buffer_usage()))doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Dynamic = R"doc(Modified occasionally (the default))doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Persistent =
+R"doc(Persistently mapped ring of three copies of the buffer, which
+set_buffer() and update_buffer_range() write into directly (OpenGL 4.4
+or ARB_buffer_storage, otherwise the same as ``Stream``))doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Static = R"doc(Uploaded once and drawn many times)doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Stream =
+R"doc(Respecified at every frame: set_buffer() orphans the previous storage
+instead of waiting for draw calls that use it)doc";
+
 static const char *__doc_nanogui_Shader_Buffer_buffer = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_dirty = R"doc()doc";
@@ -2090,6 +2620,18 @@ static const char *__doc_nanogui_Shader_PrimitiveType_Triangle = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_PrimitiveType_TriangleStrip = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_ProgramCacheStats =
+R"doc(Counters of the program binary cache (see
+set_program_cache_directory()))doc";
+
+static const char *__doc_nanogui_Shader_ProgramCacheStats_hits = R"doc(Programs that were loaded from the cache)doc";
+
+static const char *__doc_nanogui_Shader_ProgramCacheStats_misses = R"doc(Programs that were compiled from source)doc";
+
+static const char *__doc_nanogui_Shader_ProgramCacheStats_rejected = R"doc(Cache entries that the driver refused to load (e.g. after an update))doc";
+
+static const char *__doc_nanogui_Shader_ProgramCacheStats_stored = R"doc(Programs that were written to the cache)doc";
+
 static const char *__doc_nanogui_Shader_Shader =
 R"doc(Initialize the shader using the specified source strings.
 
@@ -2110,12 +2652,18 @@ static const char *__doc_nanogui_Shader_begin =
 R"doc(Begin drawing using this shader
 
 Note that any updates to 'uniform' and 'varying' shader parameters
-*must* occur prior to this method call.
+*must* occur prior to this method call. Only parameters that were
+modified since the previous call are sent to the GPU, along with state
+that other shaders may have overwritten (e.g. texture units).
 
 The Python bindings also include extra ``__enter__`` and ``__exit__``
 aliases so that the shader can be activated via Pythons 'with'
 statement.)doc";
 
+static const char *__doc_nanogui_Shader_binding =
+R"doc(Return a handle to the named shader parameter (throws if there is
+none))doc";
+
 static const char *__doc_nanogui_Shader_blend_mode = R"doc(Return the blending mode of this shader)doc";
 
 static const char *__doc_nanogui_Shader_draw_array =
@@ -2136,8 +2684,20 @@ Parameter ``indexed``:
     Render indexed geometry? In this case, an ``uint32_t`` valued
     buffer with name ``indices`` must have been uploaded using set().)doc";
 
+static const char *__doc_nanogui_Shader_draw_array_instanced =
+R"doc(Render ``instance_count`` instances of the geometry with a single draw
+call
+
+The arguments are otherwise the same as in draw_array(). Per-instance
+data is provided by vertex buffers with a divisor (see
+set_buffer_divisor()), and the shader can access the index of the
+instance via ``gl_InstanceID`` (or ``[[instance_id]]`` on Metal). GLES
+2 lacks instancing, hence there the instances are drawn one by one.)doc";
+
 static const char *__doc_nanogui_Shader_end = R"doc(End drawing using this shader)doc";
 
+static const char *__doc_nanogui_Shader_has_binding = R"doc(Does the shader have a parameter with the given name?)doc";
+
 static const char *__doc_nanogui_Shader_m_blend_mode = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_m_buffers = R"doc()doc";
@@ -2154,6 +2714,14 @@ static const char *__doc_nanogui_Shader_m_vertex_array_handle = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_name = R"doc(Return the name of this shader)doc";
 
+static const char *__doc_nanogui_Shader_pin_textures =
+R"doc(Make all textures resident and pin them until unpin_textures() (called
+by begin() before any texture unit is bound))doc";
+
+static const char *__doc_nanogui_Shader_program_cache_directory = R"doc(Return the directory of the program binary cache (empty if disabled))doc";
+
+static const char *__doc_nanogui_Shader_program_cache_stats = R"doc(Return the counters of the program binary cache)doc";
+
 static const char *__doc_nanogui_Shader_render_pass = R"doc(Return the render pass associated with this shader)doc";
 
 static const char *__doc_nanogui_Shader_set_buffer =
@@ -2165,10 +2733,47 @@ Note that this function should be used both for 'varying' and
 the right endpoint. Matrices should be specified in column-major
 order.
 
-The buffer will be replaced if it is already present.)doc";
+If the buffer is already present and its size is unchanged, its
+storage is updated in place (or orphaned, depending on the usage hint
+set via set_buffer_usage()); otherwise, it is reallocated.)doc";
 
 static const char *__doc_nanogui_Shader_set_buffer_2 = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_set_buffer_divisor =
+R"doc(Turn a vertex buffer into a per-instance attribute
+
+With a nonzero ``divisor``, the attribute advances once every
+``divisor`` instances of draw_array_instanced() instead of once per
+vertex, and the first dimension of the buffer counts instances. Should
+be called before set_buffer(). On GLES 2, per-instance buffers are
+kept in CPU memory (only ``float`` components are supported), and
+their values are set as constant attributes before each instance is
+drawn. On Metal, the shader indexes per-instance buffers via
+``[[instance_id]]``, hence the divisor has no effect.)doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_usage =
+R"doc(Specify how often a vertex or index buffer is going to be modified
+
+The hint takes effect at the next call to set_buffer(). With
+BufferUsage::Persistent, every set_buffer() call advances to the next
+copy of the ring (waiting only if the GPU still reads from it), while
+update_buffer_range() writes into the current copy without
+synchronization. The latter is intended for appending data, e.g.
+points of a cloud that grows at every frame, which pending draw calls
+do not read.)doc";
+
+static const char *__doc_nanogui_Shader_set_program_cache_directory =
+R"doc(Set the directory of the program binary cache
+
+Linked programs are stored there (via ``glGetProgramBinary()``) under
+a hash of their source code and of the vendor, renderer, and version
+strings of the driver, so that shaders with unchanged source code are
+not compiled again when the application is restarted. Entries that
+don't match the driver are ignored, and the program is compiled from
+source. By default, the cache is located in the user's cache directory
+(e.g. ``~/.cache/nanogui/shaders``). Pass an empty string to disable
+it. Requires OpenGL 4.1 or GLES 3.)doc";
+
 static const char *__doc_nanogui_Shader_set_texture =
 R"doc(Associate a texture with a named shader parameter
 
@@ -2178,8 +2783,31 @@ static const char *__doc_nanogui_Shader_set_uniform =
 R"doc(Upload a uniform variable (e.g. a vector or matrix) that will be
 associated with a named shader parameter.)doc";
 
+static const char *__doc_nanogui_Shader_set_uniform_block =
+R"doc(Overwrite the entire contents of a uniform block
+
+On OpenGL and GLES 3, ``data`` must follow the std140 layout of the
+block named in the shader code, and ``size`` must match its size. The
+members of a block can also be set individually via set_uniform().
+Modified blocks are streamed into a UniformRing that is shared by all
+shaders of the screen, hence updating a block costs a single mapped
+write instead of one call per uniform. On Metal, blocks are ordinary
+buffer arguments.)doc";
+
 static const char *__doc_nanogui_Shader_shader_handle = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_unpin_textures = R"doc(Release the pins acquired by pin_textures() (called by end()))doc";
+
+static const char *__doc_nanogui_Shader_update_buffer_range =
+R"doc(Overwrite part of a vertex or index buffer that was previously
+uploaded using set_buffer().
+
+``offset`` and ``count`` refer to entries along the first dimension of
+the buffer (e.g. vertices), and ``data`` must contain ``count`` such
+entries with the same type and trailing shape as the original upload.
+This avoids re-transferring the entire buffer when only a small part
+of it changes, e.g. when appending to a ring buffer of samples.)doc";
+
 static const char *__doc_nanogui_Shader_vertex_array_handle = R"doc()doc";
 
 static const char *__doc_nanogui_Slider = R"doc()doc";
@@ -2235,6 +2863,65 @@ static const char *__doc_nanogui_Slider_set_value = R"doc()doc";
 
 static const char *__doc_nanogui_Slider_value = R"doc()doc";
 
+static const char *__doc_nanogui_Spectrogram =
+R"doc(Waterfall display of a stream of columns (e.g. spectra)
+
+Every column consists of bins() values, which are drawn from bottom to
+top, while time advances from left to right with the most recent
+column at the right edge. The last history() columns are kept in a
+texture that is used as a ring buffer: each frame only uploads the
+columns that were pushed since the previous one, and scrolling is
+realized by wrapping the texture coordinates in the fragment shader,
+which also maps values to colors using a lookup table.
+
+Values are mapped from range() to ``[0, 1]`` and quantized to 8 bits
+when they are pushed, hence changing the range only affects
+subsequently pushed columns.)doc";
+
+static const char *__doc_nanogui_Spectrogram_Colormap = R"doc(Predefined color maps)doc";
+
+static const char *__doc_nanogui_Spectrogram_Colormap_Grayscale = R"doc()doc";
+
+static const char *__doc_nanogui_Spectrogram_Colormap_Inferno = R"doc()doc";
+
+static const char *__doc_nanogui_Spectrogram_Colormap_Viridis = R"doc()doc";
+
+static const char *__doc_nanogui_Spectrogram_Spectrogram =
+R"doc(Create a spectrogram displaying ``history`` columns with ``bins``
+values each)doc";
+
+static const char *__doc_nanogui_Spectrogram_bins = R"doc(Return the number of values per column)doc";
+
+static const char *__doc_nanogui_Spectrogram_clear = R"doc(Remove all columns)doc";
+
+static const char *__doc_nanogui_Spectrogram_column_count = R"doc(Return the total number of columns pushed since the last clear())doc";
+
+static const char *__doc_nanogui_Spectrogram_draw_contents = R"doc(Draw the widget contents)doc";
+
+static const char *__doc_nanogui_Spectrogram_history = R"doc(Return the number of displayed columns)doc";
+
+static const char *__doc_nanogui_Spectrogram_init_texture = R"doc((Re)allocate the ring buffer texture)doc";
+
+static const char *__doc_nanogui_Spectrogram_push_column = R"doc(Append a column of bins() values)doc";
+
+static const char *__doc_nanogui_Spectrogram_push_columns = R"doc(Append ``count`` consecutive columns of bins() values each)doc";
+
+static const char *__doc_nanogui_Spectrogram_range = R"doc(Return the value range that is mapped onto the color map)doc";
+
+static const char *__doc_nanogui_Spectrogram_set_colormap = R"doc(Select one of the predefined color maps)doc";
+
+static const char *__doc_nanogui_Spectrogram_set_colormap_2 =
+R"doc(Specify a custom color map
+
+The colors are evenly spaced over the value range and linearly
+interpolated. At least two colors must be given.)doc";
+
+static const char *__doc_nanogui_Spectrogram_set_range = R"doc(Set the value range that is mapped onto the color map)doc";
+
+static const char *__doc_nanogui_Spectrogram_set_shape =
+R"doc(Change the number of values per column and displayed columns (discards
+the contents))doc";
+
 static const char *__doc_nanogui_TabWidget = R"doc()doc";
 
 static const char *__doc_nanogui_TabWidget_2 =
@@ -2679,6 +3366,195 @@ static const char *__doc_nanogui_TextBox_value = R"doc()doc";
 
 static const char *__doc_nanogui_Texture = R"doc()doc";
 
+static const char *__doc_nanogui_TextureDownload =
+R"doc(Handle of an asynchronous readback of a texture's contents.
+
+start() enqueues a copy of the texture into a staging buffer (a pixel
+pack buffer on OpenGL and GLES 3, a shared-memory buffer on Metal) and
+returns immediately. ready() polls whether the copy has completed, and
+data() provides access to the pixels, waiting if necessary. A handle
+can be restarted once its data has been consumed, which avoids
+reallocating the staging buffer.
+
+OpenGL stores render targets upside down. Instead of flipping the
+rows, data() then points to the last row of the buffer and
+row_stride() is negative, so that rows can always be traversed from
+top to bottom. read() produces a conventional top-down copy.
+
+All methods must be called from the render thread. Not supported on
+GLES 2. On GLES 3, the texture is read through a framebuffer, hence R,
+RA and depth textures cannot be downloaded.)doc";
+
+static const char *__doc_nanogui_TextureDownload_TextureDownload = R"doc(Create a readback handle for the given (single-sampled) texture)doc";
+
+static const char *__doc_nanogui_TextureDownload_data =
+R"doc(Return a pointer to the top row of the downloaded image
+
+Waits for the copy to complete. The pointer remains valid until the
+next call to start() or until the handle is destroyed.)doc";
+
+static const char *__doc_nanogui_TextureDownload_read =
+R"doc(Copy the image into ``out`` as tightly packed rows from top to bottom
+(waits))doc";
+
+static const char *__doc_nanogui_TextureDownload_ready = R"doc(Check whether the copy has completed (does not wait))doc";
+
+static const char *__doc_nanogui_TextureDownload_row_stride =
+R"doc(Return the offset in bytes from one row to the next (negative if
+flipped))doc";
+
+static const char *__doc_nanogui_TextureDownload_size = R"doc(Return the size of the image captured by the last call to start())doc";
+
+static const char *__doc_nanogui_TextureDownload_start = R"doc(Enqueue a copy of the current texture contents (does not wait))doc";
+
+static const char *__doc_nanogui_TextureDownload_texture = R"doc(Return the texture that is read back)doc";
+
+static const char *__doc_nanogui_TextureDownload_wait = R"doc(Wait for the copy to complete)doc";
+
+static const char *__doc_nanogui_TextureLoader =
+R"doc(Loads images without blocking the rendering thread
+
+Files are read and decoded by a pool of worker threads. The decoded
+images are queued and uploaded to the GPU by update(), which stops
+once a per-frame time budget is exhausted and continues at the next
+frame.
+
+Each screen owns a loader (see Screen::texture_loader()), which it
+updates at the beginning of every frame and which schedules a redraw
+whenever there are images to upload.)doc";
+
+static const char *__doc_nanogui_TextureLoader_TextureLoader =
+R"doc(Create a loader whose uploads are drawn by ``screen``
+
+Parameter ``thread_count``:
+    Number of worker threads (0: one per hardware thread)
+
+Parameter ``upload_budget``:
+    Time in milliseconds that update() may spend on uploads)doc";
+
+static const char *__doc_nanogui_TextureLoader_enqueue = R"doc()doc";
+
+static const char *__doc_nanogui_TextureLoader_load =
+R"doc(Load a texture from an image file (see the corresponding Texture
+constructor for the supported formats))doc";
+
+static const char *__doc_nanogui_TextureLoader_load_image_directory =
+R"doc(Asynchronous version of nanogui::load_image_directory()
+
+Returns the NanoVG image handles along with the file names (without
+extension) right away.)doc";
+
+static const char *__doc_nanogui_TextureLoader_load_nvg_image = R"doc(Load a NanoVG image (asynchronous version of ``nvgCreateImage()``))doc";
+
+static const char *__doc_nanogui_TextureLoader_pending_count = R"doc(Return the number of images that are being loaded)doc";
+
+static const char *__doc_nanogui_TextureLoader_placeholder = R"doc(Return the 1x1 transparent texture that stands in for pending textures)doc";
+
+static const char *__doc_nanogui_TextureLoader_set_upload_budget = R"doc(Set the time in milliseconds that update() may spend on uploads)doc";
+
+static const char *__doc_nanogui_TextureLoader_shutdown = R"doc(Stop the worker threads and drop all pending requests)doc";
+
+static const char *__doc_nanogui_TextureLoader_update =
+R"doc(Upload decoded images until the time budget is exhausted
+
+Must be called on the rendering thread. Returns ``True`` if any image
+was finished (i.e. ready or failed).)doc";
+
+static const char *__doc_nanogui_TextureLoader_upload_budget = R"doc(Return the time in milliseconds that update() may spend on uploads)doc";
+
+static const char *__doc_nanogui_TextureLoader_worker = R"doc()doc";
+
+static const char *__doc_nanogui_TextureStream =
+R"doc(Ring of staging buffers for streaming frames (e.g. video) into a
+texture without stalling the render thread.
+
+A producer thread (e.g. a video decoder) obtains a buffer via
+map_next(), writes a tightly packed frame directly into it, and hands
+it back via commit(). The render thread periodically calls update(),
+which copies the most recently committed frame into the texture on the
+GPU and recycles buffers once the GPU is done with them. If several
+frames were committed in the meantime, only the newest one is uploaded
+and the others are counted as dropped.
+
+On OpenGL and GLES 3, the buffers are pixel unpack buffers that stay
+mapped while they are owned by the producer, and fences track when
+their copies complete. On Metal, they are shared-memory buffers that
+are copied using a blit encoder. GLES 2 lacks pixel buffer objects,
+hence the frames are staged in CPU memory and uploaded synchronously
+by update().)doc";
+
+static const char *__doc_nanogui_TextureStream_Slot = R"doc()doc";
+
+static const char *__doc_nanogui_TextureStream_SlotState = R"doc()doc";
+
+static const char *__doc_nanogui_TextureStream_SlotState_Free = R"doc(Available to the producer)doc";
+
+static const char *__doc_nanogui_TextureStream_SlotState_InFlight = R"doc(Being copied into the texture by the GPU)doc";
+
+static const char *__doc_nanogui_TextureStream_SlotState_Ready = R"doc(Committed, waiting for update())doc";
+
+static const char *__doc_nanogui_TextureStream_SlotState_Writing = R"doc(Handed out by map_next())doc";
+
+static const char *__doc_nanogui_TextureStream_TextureStream =
+R"doc(Create a stream targeting the given texture
+
+The texture must be single-sampled and readable by shaders. At least
+two buffers are needed so that the producer can write one frame while
+the previous one is copied.)doc";
+
+static const char *__doc_nanogui_TextureStream_buffer_count = R"doc(Return the number of staging buffers)doc";
+
+static const char *__doc_nanogui_TextureStream_commit = R"doc(Queue a buffer obtained from map_next() for upload (thread-safe))doc";
+
+static const char *__doc_nanogui_TextureStream_discard =
+R"doc(Return a buffer obtained from map_next() without uploading it (thread-
+safe))doc";
+
+static const char *__doc_nanogui_TextureStream_frame_size = R"doc(Return the size of a frame (and hence of each buffer) in bytes)doc";
+
+static const char *__doc_nanogui_TextureStream_frames_dropped =
+R"doc(Return the number of committed frames that were superseded before
+being uploaded)doc";
+
+static const char *__doc_nanogui_TextureStream_frames_uploaded = R"doc(Return the number of frames that were copied into the texture)doc";
+
+static const char *__doc_nanogui_TextureStream_init =
+R"doc(Backend-specific: allocate the buffers and make them available to the
+producer)doc";
+
+static const char *__doc_nanogui_TextureStream_map_next =
+R"doc(Acquire a buffer for writing the next frame (thread-safe)
+
+Returns ``nullptr`` when all buffers are currently in use, in which
+case the producer should retry later or skip the frame. The returned
+pointer remains valid until it is passed to commit() or discard().)doc";
+
+static const char *__doc_nanogui_TextureStream_recycle =
+R"doc(Backend-specific: return a buffer to the producer once the GPU is done
+with it)doc";
+
+static const char *__doc_nanogui_TextureStream_request_notification =
+R"doc(Request that the next commit() calls Screen::redraw() on the given
+screen (render thread only)
+
+Should be called before update(), so that frames which arrive in the
+meantime are guaranteed to trigger another redraw. Specify ``nullptr``
+to disable notifications. The request is posted via
+Screen::redraw_async(), so it is harmless if the screen has been
+destroyed in the meantime.)doc";
+
+static const char *__doc_nanogui_TextureStream_slot_index = R"doc(Return the index of the slot whose buffer starts at ``data``)doc";
+
+static const char *__doc_nanogui_TextureStream_texture = R"doc(Return the target texture)doc";
+
+static const char *__doc_nanogui_TextureStream_update =
+R"doc(Copy the newest committed frame into the texture and recycle buffers
+(render thread only)
+
+Never waits for the GPU. Returns ``True`` if the texture was updated.)doc";
+
+static const char *__doc_nanogui_TextureStream_upload = R"doc(Backend-specific: copy a committed buffer into the texture)doc";
+
 static const char *__doc_nanogui_Texture_2 = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_3 = R"doc()doc";
@@ -2701,6 +3577,24 @@ static const char *__doc_nanogui_Texture_ComponentFormat_UInt32 = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_ComponentFormat_UInt8 = R"doc()doc";
 
+static const char *__doc_nanogui_Texture_Compression = R"doc(Block compression scheme (all of them operate on blocks of 4x4 pixels))doc";
+
+static const char *__doc_nanogui_Texture_Compression_BC1 = R"doc(BC1 (DXT1): RGB + 1 bit alpha, 8 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_BC3 = R"doc(BC3 (DXT5): RGBA, 16 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_BC4 = R"doc(BC4 (RGTC1): single channel, 8 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_BC5 = R"doc(BC5 (RGTC2): two channels, 16 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_BC7 = R"doc(BC7 (BPTC): high quality RGBA, 16 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_ETC2_RGB = R"doc(ETC2: RGB, 8 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_ETC2_RGBA = R"doc(ETC2 + EAC: RGBA, 16 bytes per block)doc";
+
+static const char *__doc_nanogui_Texture_Compression_None = R"doc(Uncompressed texture)doc";
+
 static const char *__doc_nanogui_Texture_InterpolationMode = R"doc(Texture interpolation mode)doc";
 
 static const char *__doc_nanogui_Texture_InterpolationMode_Bilinear = R"doc(Bilinear ineterpolation)doc";
@@ -2737,7 +3631,12 @@ pixel_format() and component_format(). Some caution must be exercised
 in this case, since upload() will need to provide the data in a
 different storage format.)doc";
 
-static const char *__doc_nanogui_Texture_Texture_2 = R"doc(Load an image from the given file using stb-image)doc";
+static const char *__doc_nanogui_Texture_Texture_2 =
+R"doc(Load an image from the given file
+
+KTX (version 1) containers with a block-compressed internal format are
+uploaded as-is including their mip chain, which skips decoding on the
+CPU. Other files are decoded using stb-image.)doc";
 
 static const char *__doc_nanogui_Texture_TextureFlags = R"doc(How will the texture be used? (Must specify at least one))doc";
 
@@ -2745,6 +3644,14 @@ static const char *__doc_nanogui_Texture_TextureFlags_RenderTarget = R"doc(Targe
 
 static const char *__doc_nanogui_Texture_TextureFlags_ShaderRead = R"doc(Texture to be read in shaders)doc";
 
+static const char *__doc_nanogui_Texture_Texture_3 =
+R"doc(Allocate a block-compressed texture with ``mip_levels`` levels
+
+The contents must be provided level by level via upload_compressed().
+The reported pixel and component format describe the decompressed data
+(e.g. ``RGBA`` and ``UInt8`` for BC7). Use compression_supported() to
+check whether the hardware can sample the format.)doc";
+
 static const char *__doc_nanogui_Texture_WrapMode = R"doc(How should out-of-bounds texture evaluations be handled?)doc";
 
 static const char *__doc_nanogui_Texture_WrapMode_ClampToEdge = R"doc(Clamp evaluations to the edge of the texture)doc";
@@ -2759,7 +3666,32 @@ static const char *__doc_nanogui_Texture_channels = R"doc(Return the number of c
 
 static const char *__doc_nanogui_Texture_component_format = R"doc(Return the component format)doc";
 
-static const char *__doc_nanogui_Texture_download = R"doc(Download packed pixel data from the GPU to the CPU)doc";
+static const char *__doc_nanogui_Texture_compressed_size =
+R"doc(Return the number of bytes of the given MIP level of a compressed
+texture)doc";
+
+static const char *__doc_nanogui_Texture_compression = R"doc(Return the block compression scheme (or Compression::None))doc";
+
+static const char *__doc_nanogui_Texture_compression_supported = R"doc(Check whether the hardware supports a block compression scheme)doc";
+
+static const char *__doc_nanogui_Texture_download =
+R"doc(Download packed pixel data from the GPU to the CPU
+
+Waits for the transfer to finish. Use download_async() to avoid
+stalling the pipeline.)doc";
+
+static const char *__doc_nanogui_Texture_download_async =
+R"doc(Start copying the texture contents into a staging buffer without
+waiting for the transfer to finish
+
+Equivalent to creating a TextureDownload and calling its
+TextureDownload::start() method. To read back every frame, it is more
+efficient to keep a few TextureDownload instances around and to reuse
+them.)doc";
+
+static const char *__doc_nanogui_Texture_evictable =
+R"doc(Can the texture storage be released when the memory budget is
+exceeded?)doc";
 
 static const char *__doc_nanogui_Texture_flags = R"doc(Return a combination of flags (from Texture::TextureFlags))doc";
 
@@ -2787,21 +3719,97 @@ static const char *__doc_nanogui_Texture_m_wrap_mode = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_mag_interpolation_mode = R"doc(Return the interpolation mode for minimization)doc";
 
+static const char *__doc_nanogui_Texture_make_resident =
+R"doc(Recreate the storage of an evicted texture, and mark the texture as
+most recently used)doc";
+
+static const char *__doc_nanogui_Texture_memory_budget = R"doc(Return the texture memory budget in bytes (0: unlimited))doc";
+
+static const char *__doc_nanogui_Texture_memory_usage =
+R"doc(Return the number of bytes of GPU memory that the texture occupies
+(including MIP levels and multisampling)
+
+Evicted textures (see set_evictable()) are not counted by
+total_memory_usage().)doc";
+
+static const char *__doc_nanogui_Texture_memory_usage_by_owner = R"doc(Return the memory occupied by resident textures, grouped by owner())doc";
+
 static const char *__doc_nanogui_Texture_min_interpolation_mode = R"doc(Return the interpolation mode for minimization)doc";
 
+static const char *__doc_nanogui_Texture_mip_levels = R"doc(Return the number of MIP levels of a compressed texture (1 otherwise))doc";
+
+static const char *__doc_nanogui_Texture_owner = R"doc(Return the label under which the texture's memory is reported)doc";
+
+static const char *__doc_nanogui_Texture_pin =
+R"doc(Make the texture resident and exempt it from eviction until the
+matching unpin() call
+
+Shader::begin() pins all of its textures before binding any texture
+unit, so that restoring one texture cannot evict another that is about
+to be used by the same draw call.)doc";
+
 static const char *__doc_nanogui_Texture_pixel_format = R"doc(Return the pixel format)doc";
 
 static const char *__doc_nanogui_Texture_renderbuffer_handle = R"doc()doc";
 
+static const char *__doc_nanogui_Texture_resident = R"doc(Return whether the texture storage is currently allocated)doc";
+
 static const char *__doc_nanogui_Texture_resize = R"doc(Resize the texture (discards the current contents))doc";
 
 static const char *__doc_nanogui_Texture_samples = R"doc(Return the number of samples (MSAA))doc";
 
+static const char *__doc_nanogui_Texture_set_evictable =
+R"doc(Specify whether the texture storage can be released when the memory
+budget is exceeded
+
+Evicted textures are recreated when they are next bound by a Shader,
+which invokes ``restore`` to upload the contents again. For textures
+that were loaded from an image file, ``restore`` may be omitted to
+reload the file. Only supported for textures that are exclusively read
+by shaders.)doc";
+
+static const char *__doc_nanogui_Texture_set_memory_budget =
+R"doc(Set the texture memory budget in bytes (0: unlimited)
+
+Whenever textures are allocated beyond the budget, evictable textures
+are released in least recently used order until the total fits again.)doc";
+
+static const char *__doc_nanogui_Texture_set_owner = R"doc(Set the label under which the texture's memory is reported)doc";
+
 static const char *__doc_nanogui_Texture_size = R"doc(Return the size of this texture)doc";
 
 static const char *__doc_nanogui_Texture_texture_handle = R"doc()doc";
 
-static const char *__doc_nanogui_Texture_upload = R"doc(Upload packed pixel data from the CPU to the GPU)doc";
+static const char *__doc_nanogui_Texture_total_memory_usage = R"doc(Return the number of bytes occupied by all textures that are resident)doc";
+
+static const char *__doc_nanogui_Texture_unpin = R"doc(Release a pin acquired by pin() and enforce the memory budget)doc";
+
+static const char *__doc_nanogui_Texture_upload =
+R"doc(Upload packed pixel data from the CPU to the GPU
+
+The texture storage is only (re)allocated by the first upload and
+following a resize(); subsequent uploads overwrite the existing
+storage in place.)doc";
+
+static const char *__doc_nanogui_Texture_upload_compressed =
+R"doc(Upload one MIP level of a compressed texture
+
+``data`` holds rows of 4x4 blocks as produced by the compressor, and
+``size`` must equal compressed_size() of the level.)doc";
+
+static const char *__doc_nanogui_Texture_upload_sub_region =
+R"doc(Upload pixel data to a rectangular region of the texture
+
+``data`` contains ``size.y()`` rows of ``size.x()`` pixels each, which
+are written to the texture starting at ``origin``. The remainder of
+the texture is left untouched, which makes this much cheaper than
+upload() when only a small part of a large texture changes (e.g. one
+line of a ring buffer).
+
+Consecutive rows of ``data`` are ``row_stride`` pixels apart, which
+makes it possible to upload a region straight out of a larger image
+(pass a pointer to its first pixel). The default value of zero refers
+to tightly packed rows.)doc";
 
 static const char *__doc_nanogui_Texture_wrap_mode = R"doc(Return the wrap mode)doc";
 
@@ -3011,6 +4019,131 @@ static const char *__doc_nanogui_Theme_m_window_title_unfocused =
 R"doc(The title color for a Window that is not in focus (default:
 intensity=``220``, alpha=``160``; see nanogui::Color::Color(int,int)).)doc";
 
+static const char *__doc_nanogui_TileCache =
+R"doc(Decodes the tiles of a TileSource on worker threads and keeps them in
+GPU textures, evicting the least recently used ones when the memory
+budget is exceeded.
+
+Requested tiles are decoded in the order of the request() calls.
+Requests that were not picked up by a worker yet can be withdrawn via
+clear_requests(), which makes it possible to re-prioritize the queue
+at every frame (e.g. after the view has changed). Decoded tiles are
+uploaded on the rendering thread by update().)doc";
+
+static const char *__doc_nanogui_TileCache_TileCache =
+R"doc(Create a cache of the tiles of ``source``
+
+Parameter ``memory_budget``:
+    Maximum size of the cached tile textures in bytes
+
+Parameter ``thread_count``:
+    Number of worker threads (0: one per hardware thread))doc";
+
+static const char *__doc_nanogui_TileCache_clear_failures =
+R"doc(Forget about tiles that failed to load, so that they can be requested
+again)doc";
+
+static const char *__doc_nanogui_TileCache_clear_requests = R"doc(Withdraw all requests that were not picked up by a worker thread yet)doc";
+
+static const char *__doc_nanogui_TileCache_failed_count =
+R"doc(Return the number of tiles whose TileSource::load_tile() call threw an
+exception)doc";
+
+static const char *__doc_nanogui_TileCache_memory_budget = R"doc(Return the maximum size of the cached tile textures in bytes)doc";
+
+static const char *__doc_nanogui_TileCache_memory_usage = R"doc(Return the size of the cached tile textures in bytes)doc";
+
+static const char *__doc_nanogui_TileCache_pending_count = R"doc(Return the number of tiles that are waiting to be decoded or uploaded)doc";
+
+static const char *__doc_nanogui_TileCache_request =
+R"doc(Queue a tile for decoding unless it is resident, already pending, or
+failed to load before)doc";
+
+static const char *__doc_nanogui_TileCache_request_notification =
+R"doc(Redraw ``screen`` once the next tile has been decoded
+
+The request is one-shot and must be renewed (typically at every
+frame). Pass ``nullptr`` to cancel it.)doc";
+
+static const char *__doc_nanogui_TileCache_resident_count = R"doc(Return the number of tiles that are currently resident on the GPU)doc";
+
+static const char *__doc_nanogui_TileCache_set_memory_budget = R"doc(Set the maximum size of the cached tile textures in bytes)doc";
+
+static const char *__doc_nanogui_TileCache_shutdown =
+R"doc(Stop the worker threads and drop all pending requests
+
+Resident tiles remain usable, but further requests are ignored.)doc";
+
+static const char *__doc_nanogui_TileCache_source = R"doc(Return the tile source)doc";
+
+static const char *__doc_nanogui_TileCache_tile =
+R"doc(Return the texture of a resident tile (or ``nullptr``)
+
+Marks the tile as most recently used.)doc";
+
+static const char *__doc_nanogui_TileCache_update =
+R"doc(Upload decoded tiles to the GPU, evicting the least recently used ones
+to stay within the memory budget
+
+Tiles that were used since the previous call are never evicted, hence
+the budget is exceeded when the visible tiles alone don't fit. Returns
+``True`` if any tile was uploaded.)doc";
+
+static const char *__doc_nanogui_TileSource =
+R"doc(Interface to an image that is too large to be loaded at once
+
+The image is organized as a pyramid of levels: level 0 has the full
+resolution size(), and every following level halves the resolution
+(rounding up) until the whole image fits into a single tile. Each
+level is split into square tiles of tile_size() pixels, which are
+produced on demand by load_tile().)doc";
+
+static const char *__doc_nanogui_TileSource_TileSource = R"doc(Describe an image with the given full resolution and pixel format)doc";
+
+static const char *__doc_nanogui_TileSource_bytes_per_pixel = R"doc(Return the number of bytes per pixel)doc";
+
+static const char *__doc_nanogui_TileSource_channels = R"doc(Return the number of channels per pixel)doc";
+
+static const char *__doc_nanogui_TileSource_component_format = R"doc(Return the component format of the tiles)doc";
+
+static const char *__doc_nanogui_TileSource_level_count = R"doc(Return the number of levels of the pyramid)doc";
+
+static const char *__doc_nanogui_TileSource_level_size = R"doc(Return the resolution of the given level)doc";
+
+static const char *__doc_nanogui_TileSource_load_tile =
+R"doc(Decode a tile
+
+Writes the tightly packed pixels of the tile with the given index
+(``tile_extent(level, index)`` pixels in row-major order) to ``data``.
+This function is called by the worker threads of a TileCache and must
+therefore be thread-safe.)doc";
+
+static const char *__doc_nanogui_TileSource_pixel_format = R"doc(Return the pixel format of the tiles)doc";
+
+static const char *__doc_nanogui_TileSource_size = R"doc(Return the resolution of level 0)doc";
+
+static const char *__doc_nanogui_TileSource_tile_count = R"doc(Return the number of tiles along each axis of the given level)doc";
+
+static const char *__doc_nanogui_TileSource_tile_extent =
+R"doc(Return the resolution of a tile (smaller than tile_size() at the right
+and bottom edge))doc";
+
+static const char *__doc_nanogui_TileSource_tile_size = R"doc(Return the width and height of a tile in pixels)doc";
+
+static const char *__doc_nanogui_TimeSeries_Decimation =
+R"doc(Decimation strategy used to reduce a series to the available screen
+space)doc";
+
+static const char *__doc_nanogui_TimeSeries_Decimation_LTTB = R"doc(Largest-Triangle-Three-Buckets: picks visually representative samples)doc";
+
+static const char *__doc_nanogui_TimeSeries_Decimation_MinMax =
+R"doc(Preserve the minimum and maximum within each pixel column (exact
+envelope))doc";
+
+static const char *__doc_nanogui_TimeSeries_data =
+R"doc(Return the ring storage, where the sample with absolute index ``i`` is
+at ``i % capacity()``)doc";
+
 static const char *__doc_nanogui_ToolButton = R"doc()doc";
 
 static const char *__doc_nanogui_ToolButton_2 =
@@ -3020,6 +4153,43 @@ Simple radio+toggle button with an icon.)doc";
 
 static const char *__doc_nanogui_ToolButton_ToolButton = R"doc()doc";
 
+static const char *__doc_nanogui_UniformRing =
+R"doc(Ring buffer that streams the contents of uniform blocks to the GPU
+
+Each update is copied into the next free (suitably aligned) range of a
+single uniform buffer, which the shader then binds by offset.
+
+When ``glBufferStorage()`` is available (OpenGL 4.4), the buffer is
+mapped persistently and updates are written straight into it. The ring
+is split into thirds, and a fence guards each third from being
+overwritten before the GPU has finished reading it. Otherwise, updates
+are staged in memory and copied by flush() using a single map
+operation. Once the buffer is full, its storage is orphaned, so that
+the driver can hand out fresh memory without waiting for pending draw
+calls. Either way, moving on to memory that previous updates may
+occupy increments generation(), which tells the shaders to re-upload
+their blocks.
+
+Every screen owns a ring (see Screen::uniform_ring()) that is shared
+by the shaders created while its context is current. Requires OpenGL
+or GLES 3.)doc";
+
+static const char *__doc_nanogui_UniformRing_UniformRing = R"doc(Allocate a ring of ``size`` bytes)doc";
+
+static const char *__doc_nanogui_UniformRing_buffer_handle = R"doc(Return the handle of the uniform buffer)doc";
+
+static const char *__doc_nanogui_UniformRing_flush = R"doc(Make the data of preceding push() calls visible to draw calls)doc";
+
+static const char *__doc_nanogui_UniformRing_generation =
+R"doc(Return the number of times that previously returned offsets were
+invalidated)doc";
+
+static const char *__doc_nanogui_UniformRing_push =
+R"doc(Copy ``size`` bytes into the ring and return their offset (see
+flush()))doc";
+
+static const char *__doc_nanogui_UniformRing_size = R"doc(Return the size of the ring in bytes)doc";
+
 static const char *__doc_nanogui_VScrollPanel = R"doc()doc";
 
 static const char *__doc_nanogui_VScrollPanel_2 =
@@ -3525,6 +4695,8 @@ Parameter ``multiple``:
 
 static const char *__doc_nanogui_get_type = R"doc(Convert from a C++ type to an element of VariableType)doc";
 
+static const char *__doc_nanogui_image_directory_files = R"doc(Return the full paths of the PNG images in a directory)doc";
+
 static const char *__doc_nanogui_init =
 R"doc(Static initialization; should be called once before invoking **any**
 NanoGUI functions **if** you are having NanoGUI manage OpenGL / GLFW.
@@ -3541,7 +4713,10 @@ mainloop).)doc";
 
 static const char *__doc_nanogui_load_image_directory =
 R"doc(Load a directory of PNG images and upload them to the GPU (suitable
-for use with ImagePanel))doc";
+for use with ImagePanel)
+
+The images are decoded on the calling thread. See
+TextureLoader::load_image_directory() for an asynchronous version.)doc";
 
 static const char *__doc_nanogui_mainloop =
 R"doc(Enter the application main loop
@@ -41,7 +41,8 @@ static VariableType dtype_to_enoki(const py::dtype &dtype) {
     return VariableType::Invalid;
 }
 
-static void shader_set_buffer(Shader &shader, const std::string &name, py::array array) {
+template <typename Key>
+static void shader_set_buffer(Shader &shader, const Key &name, py::array array) {
     if (array.ndim() > 3)
         throw py::type_error("Shader::set_buffer(): tensor rank must be < 3!");
     array = py::array::ensure(array, py::array::c_style);
@@ -60,9 +61,23 @@ static void shader_set_buffer(Shader &shader, const std::string &name, py::array
     shader.set_buffer(name, dtype, array.ndim(), dim, array.data());
 }
 
-static py::array texture_download(Texture &texture) {
+template <typename Key>
+static void shader_update_buffer_range(Shader &shader, const Key &name,
+                                       size_t offset, py::array array) {
+    array = py::array::ensure(array, py::array::c_style);
+    size_t count = array.ndim() > 0 ? (size_t) array.shape(0) : 1;
+    shader.update_buffer_range(name, offset, count, array.data());
+}
+
+template <typename Key>
+static void shader_set_uniform_block(Shader &shader, const Key &name, py::buffer buffer) {
+    py::buffer_info info = buffer.request();
+    shader.set_uniform_block(name, info.ptr, (size_t) (info.size * info.itemsize));
+}
+
+static const char *texture_dtype_name(Texture::ComponentFormat component_format) {
     const char *dtype_name;
-    switch (texture.component_format()) {
+    switch (component_format) {
         case Texture::ComponentFormat::UInt8:   dtype_name = "u1"; break;
         case Texture::ComponentFormat::Int8:    dtype_name = "i1"; break;
         case Texture::ComponentFormat::UInt16:  dtype_name = "u2"; break;
@@ -74,6 +89,11 @@ static py::array texture_download(Texture &texture) {
         default:
             throw std::runtime_error("Invalid component format");
     }
+    return dtype_name;
+}
+
+static py::array texture_download(Texture &texture) {
+    const char *dtype_name = texture_dtype_name(texture.component_format());
 
     py::array result(
         py::dtype(dtype_name),
@@ -86,6 +106,20 @@ static py::array texture_download(Texture &texture) {
     return result;
 }
 
+static py::array texture_download_read(TextureDownload &download) {
+    Texture *texture = download.texture();
+
+    py::array result(
+        py::dtype(texture_dtype_name(texture->component_format())),
+        std::vector<ssize_t> { download.size().y(), download.size().x(),
+                               (ssize_t) texture->channels() },
+        std::vector<ssize_t> { }
+    );
+
+    download.read((uint8_t *) result.mutable_data());
+    return result;
+}
+
 static void texture_upload(Texture &texture, py::array array) {
     size_t n_channels = array.ndim() == 3 ? array.shape(2) : 1;
     VariableType dtype         = dtype_to_enoki(array.dtype()),
@@ -110,12 +144,100 @@ static void texture_upload(Texture &texture, py::array array) {
     texture.upload((const uint8_t *) array.data());
 }
 
+static void texture_upload_sub_region(Texture &texture, py::array array,
+                                      const Vector2i &origin) {
+    size_t n_channels = array.ndim() == 3 ? array.shape(2) : 1;
+    VariableType dtype         = dtype_to_enoki(array.dtype()),
+                 dtype_texture = (VariableType) texture.component_format();
+
+    if (array.ndim() != 2 && array.ndim() != 3)
+        throw std::runtime_error("Texture::upload_sub_region(): expected a 2 or 3-dimensional array!");
+    else if (n_channels != texture.channels())
+        throw std::runtime_error(
+            "Texture::upload_sub_region(): number of color channels does not match the texture!");
+    else if (dtype != dtype_texture)
+        throw std::runtime_error(
+            "Texture::upload_sub_region(): dtype does not match the texture!");
+
+    /* Views into a larger image can be uploaded without copying, as long as
+       the pixels within each row are contiguous */
+    ssize_t pixel_bytes = (ssize_t) texture.bytes_per_pixel();
+    bool strided = array.strides(1) == pixel_bytes &&
+                   (array.ndim() == 2 || array.strides(2) == (ssize_t) array.itemsize()) &&
+                   array.strides(0) >= pixel_bytes * array.shape(1) &&
+                   array.strides(0) % pixel_bytes == 0;
+    if (!strided)
+        array = py::array::ensure(array, py::array::c_style);
+
+    texture.upload_sub_region((const uint8_t *) array.data(), origin,
+                              Vector2i((int) array.shape(1), (int) array.shape(0)),
+                              strided ? (size_t) (array.strides(0) / pixel_bytes) : 0);
+}
+
+/// Expose the next buffer of a texture stream as an array (or return None)
+static py::object texture_stream_map_next(TextureStream &stream) {
+    uint8_t *data = stream.map_next();
+    if (!data)
+        return py::none();
+
+    Texture *texture = stream.texture();
+    py::dtype dtype(texture_dtype_name(texture->component_format()));
+    ssize_t channels = (ssize_t) texture->channels();
+
+    /* The array references the stream so that the buffer remains valid */
+    return py::array(
+        dtype,
+        std::vector<ssize_t> { texture->size().y(), texture->size().x(), channels },
+        std::vector<ssize_t> { },
+        data, py::cast(&stream)
+    );
+}
+
+class PyTileSource : public TileSource {
+public:
+    using TileSource::TileSource;
+
+    void load_tile(uint32_t level, const Vector2i &index, uint8_t *data) override {
+        py::gil_scoped_acquire gil;
+        py::function overload = py::get_overload(this, "load_tile");
+        if (!overload)
+            throw std::runtime_error("TileSource::load_tile(): not implemented!");
+
+        /* The array is a view of 'data' that is only valid during the call */
+        Vector2i extent = tile_extent(level, index);
+        py::array array(
+            py::dtype(texture_dtype_name(m_component_format)),
+            std::vector<ssize_t> { extent.y(), extent.x(), (ssize_t) channels() },
+            std::vector<ssize_t> { },
+            data, py::none()
+        );
+        overload(level, index, array);
+    }
+};
+
+class PyTileCache : public TileCache {
+public:
+    using TileCache::TileCache;
+
+protected:
+    ~PyTileCache() {
+        /* Workers may be blocked acquiring the GIL in PyTileSource::load_tile() */
+        if (PyGILState_Check()) {
+            py::gil_scoped_release release;
+            shutdown();
+        } else {
+            shutdown();
+        }
+    }
+};
+
 void register_render(py::module &m) {
     using PixelFormat       = Texture::PixelFormat;
     using ComponentFormat   = Texture::ComponentFormat;
     using InterpolationMode = Texture::InterpolationMode;
     using WrapMode          = Texture::WrapMode;
     using TextureFlags      = Texture::TextureFlags;
+    using Compression       = Texture::Compression;
     using PrimitiveType     = Shader::PrimitiveType;
     using BlendMode         = Shader::BlendMode;
     using DepthTest         = RenderPass::DepthTest;
@@ -157,6 +279,16 @@ void register_render(py::module &m) {
         .value("ShaderRead", TextureFlags::ShaderRead, D(Texture, TextureFlags, ShaderRead))
         .value("RenderTarget", TextureFlags::RenderTarget, D(Texture, TextureFlags, RenderTarget));
 
+    py::enum_<Compression>(texture, "Compression", D(Texture, Compression))
+        .value("None", Compression::None, D(Texture, Compression, None))
+        .value("BC1", Compression::BC1, D(Texture, Compression, BC1))
+        .value("BC3", Compression::BC3, D(Texture, Compression, BC3))
+        .value("BC4", Compression::BC4, D(Texture, Compression, BC4))
+        .value("BC5", Compression::BC5, D(Texture, Compression, BC5))
+        .value("BC7", Compression::BC7, D(Texture, Compression, BC7))
+        .value("ETC2_RGB", Compression::ETC2_RGB, D(Texture, Compression, ETC2_RGB))
+        .value("ETC2_RGBA", Compression::ETC2_RGBA, D(Texture, Compression, ETC2_RGBA));
+
     texture
         .def(py::init<PixelFormat, ComponentFormat, const Vector2i &,
                       InterpolationMode, InterpolationMode, WrapMode, uint8_t, uint8_t>(),
@@ -170,6 +302,12 @@ void register_render(py::module &m) {
              "min_interpolation_mode"_a = InterpolationMode::Bilinear,
              "mag_interpolation_mode"_a = InterpolationMode::Bilinear,
              "wrap_mode"_a = WrapMode::ClampToEdge)
+        .def(py::init<Compression, const Vector2i &, uint32_t,
+                      InterpolationMode, InterpolationMode, WrapMode>(),
+             D(Texture, Texture, 3), "compression"_a, "size"_a, "mip_levels"_a = 1,
+             "min_interpolation_mode"_a = InterpolationMode::Bilinear,
+             "mag_interpolation_mode"_a = InterpolationMode::Bilinear,
+             "wrap_mode"_a = WrapMode::ClampToEdge)
         .def("pixel_format", &Texture::pixel_format, D(Texture, pixel_format))
         .def("component_format", &Texture::component_format, D(Texture, component_format))
         .def("min_interpolation_mode", &Texture::min_interpolation_mode, D(Texture, min_interpolation_mode))
@@ -181,8 +319,39 @@ void register_render(py::module &m) {
         .def("bytes_per_pixel", &Texture::bytes_per_pixel, D(Texture, bytes_per_pixel))
         .def("channels", &Texture::channels, D(Texture, channels))
         .def("download", &texture_download, D(Texture, download))
+        .def("download_async", &Texture::download_async, D(Texture, download_async))
         .def("upload", &texture_upload, D(Texture, upload))
+        .def("upload_sub_region", &texture_upload_sub_region,
+             D(Texture, upload_sub_region), "array"_a, "origin"_a)
         .def("resize", &Texture::resize, D(Texture, resize))
+        .def("compression", &Texture::compression, D(Texture, compression))
+        .def("mip_levels", &Texture::mip_levels, D(Texture, mip_levels))
+        .def("compressed_size", &Texture::compressed_size, D(Texture, compressed_size),
+             "level"_a = 0)
+        .def_static("compression_supported", &Texture::compression_supported,
+                    D(Texture, compression_supported), "compression"_a)
+        .def("upload_compressed", [](Texture &texture, py::buffer buffer, uint32_t level) {
+                 py::buffer_info info = buffer.request();
+                 texture.upload_compressed((const uint8_t *) info.ptr,
+                                           (size_t) (info.size * info.itemsize), level);
+             }, D(Texture, upload_compressed), "data"_a, "level"_a = 0)
+        .def("memory_usage", &Texture::memory_usage, D(Texture, memory_usage))
+        .def("owner", &Texture::owner, D(Texture, owner))
+        .def("set_owner", &Texture::set_owner, D(Texture, set_owner))
+        .def("evictable", &Texture::evictable, D(Texture, evictable))
+        .def("set_evictable", &Texture::set_evictable, D(Texture, set_evictable),
+             "evictable"_a, "restore"_a = std::function<void(Texture *)>())
+        .def("resident", &Texture::resident, D(Texture, resident))
+        .def("make_resident", &Texture::make_resident, D(Texture, make_resident))
+        .def("pin", &Texture::pin, D(Texture, pin))
+        .def("unpin", &Texture::unpin, D(Texture, unpin))
+        .def_static("total_memory_usage", &Texture::total_memory_usage,
+                    D(Texture, total_memory_usage))
+        .def_static("memory_usage_by_owner", &Texture::memory_usage_by_owner,
+                    D(Texture, memory_usage_by_owner))
+        .def_static("memory_budget", &Texture::memory_budget, D(Texture, memory_budget))
+        .def_static("set_memory_budget", &Texture::set_memory_budget,
+                    D(Texture, set_memory_budget))
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         .def("texture_handle", &Texture::texture_handle)
         .def("renderbuffer_handle", &Texture::renderbuffer_handle)
@@ -192,12 +361,114 @@ void register_render(py::module &m) {
 #endif
         ;
 
+    py::class_<TextureDownload, Object, ref<TextureDownload>>(m, "TextureDownload", D(TextureDownload))
+        .def(py::init<Texture *>(), D(TextureDownload, TextureDownload), "texture"_a)
+        .def("texture", &TextureDownload::texture, D(TextureDownload, texture))
+        .def("size", &TextureDownload::size, D(TextureDownload, size))
+        .def("start", &TextureDownload::start, D(TextureDownload, start))
+        .def("ready", &TextureDownload::ready, D(TextureDownload, ready))
+        .def("wait", &TextureDownload::wait, D(TextureDownload, wait))
+        .def("read", &texture_download_read, D(TextureDownload, read));
+
+    py::class_<TextureStream, Object, ref<TextureStream>>(m, "TextureStream", D(TextureStream))
+        .def(py::init<Texture *, size_t>(), D(TextureStream, TextureStream),
+             "texture"_a, "buffer_count"_a = 3)
+        .def("texture", &TextureStream::texture, D(TextureStream, texture))
+        .def("buffer_count", &TextureStream::buffer_count, D(TextureStream, buffer_count))
+        .def("frame_size", &TextureStream::frame_size, D(TextureStream, frame_size))
+        .def("map_next", &texture_stream_map_next, D(TextureStream, map_next))
+        .def("commit", [](TextureStream &stream, py::array array) {
+                 stream.commit((uint8_t *) array.mutable_data());
+             }, D(TextureStream, commit))
+        .def("discard", [](TextureStream &stream, py::array array) {
+                 stream.discard((uint8_t *) array.mutable_data());
+             }, D(TextureStream, discard))
+        .def("update", &TextureStream::update, D(TextureStream, update))
+        .def("frames_uploaded", &TextureStream::frames_uploaded, D(TextureStream, frames_uploaded))
+        .def("frames_dropped", &TextureStream::frames_dropped, D(TextureStream, frames_dropped));
+
+    auto async_texture = py::class_<AsyncTexture, Object, ref<AsyncTexture>>(
+        m, "AsyncTexture", D(AsyncTexture));
+
+    py::enum_<AsyncTexture::State>(async_texture, "State", D(AsyncTexture, State))
+        .value("Pending", AsyncTexture::State::Pending, D(AsyncTexture, State, Pending))
+        .value("Ready", AsyncTexture::State::Ready, D(AsyncTexture, State, Ready))
+        .value("Failed", AsyncTexture::State::Failed, D(AsyncTexture, State, Failed));
+
+    async_texture
+        .def("filename", &AsyncTexture::filename, D(AsyncTexture, filename))
+        .def("state", &AsyncTexture::state, D(AsyncTexture, state))
+        .def("ready", &AsyncTexture::ready, D(AsyncTexture, ready))
+        .def("texture", &AsyncTexture::texture, D(AsyncTexture, texture))
+        .def("nvg_image", &AsyncTexture::nvg_image, D(AsyncTexture, nvg_image))
+        .def("error", &AsyncTexture::error, D(AsyncTexture, error))
+        .def("set_callback", &AsyncTexture::set_callback, D(AsyncTexture, set_callback));
+
+    py::class_<TextureLoader, Object, ref<TextureLoader>>(m, "TextureLoader", D(TextureLoader))
+        .def(py::init<Screen *, size_t, double>(), D(TextureLoader, TextureLoader),
+             "screen"_a, "thread_count"_a = 0, "upload_budget"_a = 2.0)
+        .def("load", &TextureLoader::load, D(TextureLoader, load), "filename"_a,
+             "min_interpolation_mode"_a = InterpolationMode::Bilinear,
+             "mag_interpolation_mode"_a = InterpolationMode::Bilinear,
+             "wrap_mode"_a = WrapMode::ClampToEdge)
+        .def("load_nvg_image", &TextureLoader::load_nvg_image, D(TextureLoader, load_nvg_image),
+             "ctx"_a, "filename"_a, "image_flags"_a = 0)
+        .def("load_image_directory", &TextureLoader::load_image_directory,
+             D(TextureLoader, load_image_directory), "ctx"_a, "path"_a)
+        .def("update", &TextureLoader::update, D(TextureLoader, update))
+        .def("pending_count", &TextureLoader::pending_count, D(TextureLoader, pending_count))
+        .def("upload_budget", &TextureLoader::upload_budget, D(TextureLoader, upload_budget))
+        .def("set_upload_budget", &TextureLoader::set_upload_budget, D(TextureLoader, set_upload_budget))
+        .def("placeholder", &TextureLoader::placeholder, D(TextureLoader, placeholder))
+        .def("shutdown", &TextureLoader::shutdown, D(TextureLoader, shutdown));
+
+    py::class_<TileSource, Object, ref<TileSource>, PyTileSource>(m, "TileSource", D(TileSource))
+        .def(py::init<const Vector2i &, uint32_t, PixelFormat, ComponentFormat>(),
+             D(TileSource, TileSource), "size"_a, "tile_size"_a = 256,
+             "pixel_format"_a = PixelFormat::RGBA,
+             "component_format"_a = ComponentFormat::UInt8)
+        .def("size", &TileSource::size, D(TileSource, size))
+        .def("tile_size", &TileSource::tile_size, D(TileSource, tile_size))
+        .def("level_count", &TileSource::level_count, D(TileSource, level_count))
+        .def("pixel_format", &TileSource::pixel_format, D(TileSource, pixel_format))
+        .def("component_format", &TileSource::component_format, D(TileSource, component_format))
+        .def("channels", &TileSource::channels, D(TileSource, channels))
+        .def("bytes_per_pixel", &TileSource::bytes_per_pixel, D(TileSource, bytes_per_pixel))
+        .def("level_size", &TileSource::level_size, D(TileSource, level_size), "level"_a)
+        .def("tile_count", &TileSource::tile_count, D(TileSource, tile_count), "level"_a)
+        .def("tile_extent", &TileSource::tile_extent, D(TileSource, tile_extent),
+             "level"_a, "index"_a);
+
+    py::class_<TileCache, Object, ref<TileCache>, PyTileCache>(m, "TileCache", D(TileCache))
+        .def(py::init_alias<TileSource *, size_t, size_t>(), D(TileCache, TileCache),
+             "source"_a, "memory_budget"_a = 256 * 1024 * 1024, "thread_count"_a = 0)
+        .def("source", py::overload_cast<>(&TileCache::source), D(TileCache, source))
+        .def("memory_budget", &TileCache::memory_budget, D(TileCache, memory_budget))
+        .def("set_memory_budget", &TileCache::set_memory_budget, D(TileCache, set_memory_budget))
+        .def("memory_usage", &TileCache::memory_usage, D(TileCache, memory_usage))
+        .def("resident_count", &TileCache::resident_count, D(TileCache, resident_count))
+        .def("pending_count", &TileCache::pending_count, D(TileCache, pending_count))
+        .def("tile", &TileCache::tile, D(TileCache, tile), "level"_a, "index"_a)
+        .def("request", &TileCache::request, D(TileCache, request), "level"_a, "index"_a)
+        .def("clear_requests", &TileCache::clear_requests, D(TileCache, clear_requests))
+        .def("failed_count", &TileCache::failed_count, D(TileCache, failed_count))
+        .def("clear_failures", &TileCache::clear_failures, D(TileCache, clear_failures))
+        .def("update", &TileCache::update, D(TileCache, update))
+        .def("shutdown", &TileCache::shutdown, D(TileCache, shutdown),
+             py::call_guard<py::gil_scoped_release>());
+
     auto shader = py::class_<Shader, Object, ref<Shader>>(m, "Shader", D(Shader));
 
     py::enum_<BlendMode>(shader, "BlendMode", D(Shader, BlendMode))
         .value("None", BlendMode::None, D(Shader, BlendMode, None))
         .value("AlphaBlend", BlendMode::AlphaBlend, D(Shader, BlendMode, AlphaBlend));
 
+    py::enum_<Shader::BufferUsage>(shader, "BufferUsage", D(Shader, BufferUsage))
+        .value("Static", Shader::BufferUsage::Static, D(Shader, BufferUsage, Static))
+        .value("Dynamic", Shader::BufferUsage::Dynamic, D(Shader, BufferUsage, Dynamic))
+        .value("Stream", Shader::BufferUsage::Stream, D(Shader, BufferUsage, Stream))
+        .value("Persistent", Shader::BufferUsage::Persistent, D(Shader, BufferUsage, Persistent));
+
     shader
         .def(py::init<RenderPass *, const std::string &,
                       const std::string &, const std::string &, Shader::BlendMode>(),
@@ -205,24 +476,88 @@ void register_render(py::module &m) {
              "fragment_shader"_a, "blend_mode"_a = BlendMode::None)
         .def("name", &Shader::name, D(Shader, name))
         .def("blend_mode", &Shader::blend_mode, D(Shader, blend_mode))
-        .def("set_buffer", &shader_set_buffer, D(Shader, set_buffer))
-        .def("set_texture", &Shader::set_texture, D(Shader, set_texture))
+        .def("binding", &Shader::binding, D(Shader, binding), "name"_a)
+        .def("has_binding", &Shader::has_binding, D(Shader, has_binding), "name"_a)
+        .def("set_buffer", &shader_set_buffer<std::string>, D(Shader, set_buffer))
+        .def("set_buffer", &shader_set_buffer<Shader::BindingHandle>, D(Shader, set_buffer))
+        .def("update_buffer_range", &shader_update_buffer_range<std::string>,
+             D(Shader, update_buffer_range), "name"_a, "offset"_a, "array"_a)
+        .def("update_buffer_range", &shader_update_buffer_range<Shader::BindingHandle>,
+             D(Shader, update_buffer_range), "binding"_a, "offset"_a, "array"_a)
+        .def("set_buffer_usage",
+             py::overload_cast<const std::string &, Shader::BufferUsage>(&Shader::set_buffer_usage),
+             D(Shader, set_buffer_usage), "name"_a, "usage"_a)
+        .def("set_buffer_usage",
+             py::overload_cast<Shader::BindingHandle, Shader::BufferUsage>(&Shader::set_buffer_usage),
+             D(Shader, set_buffer_usage), "binding"_a, "usage"_a)
+        .def("set_buffer_divisor",
+             py::overload_cast<const std::string &, uint32_t>(&Shader::set_buffer_divisor),
+             D(Shader, set_buffer_divisor), "name"_a, "divisor"_a)
+        .def("set_buffer_divisor",
+             py::overload_cast<Shader::BindingHandle, uint32_t>(&Shader::set_buffer_divisor),
+             D(Shader, set_buffer_divisor), "binding"_a, "divisor"_a)
+        .def("set_texture", py::overload_cast<const std::string &, Texture *>(&Shader::set_texture),
+             D(Shader, set_texture))
+        .def("set_texture", py::overload_cast<Shader::BindingHandle, Texture *>(&Shader::set_texture),
+             D(Shader, set_texture))
+        .def("set_uniform_block", &shader_set_uniform_block<std::string>,
+             D(Shader, set_uniform_block), "name"_a, "data"_a)
+        .def("set_uniform_block", &shader_set_uniform_block<Shader::BindingHandle>,
+             D(Shader, set_uniform_block), "binding"_a, "data"_a)
         .def("begin", &Shader::begin, D(Shader, begin))
         .def("end", &Shader::end, D(Shader, end))
         .def("__enter__", &Shader::begin)
         .def("__exit__", [](Shader &s, py::handle, py::handle, py::handle) { s.end(); })
         .def("draw_array", &Shader::draw_array, D(Shader, draw_array),
              "primitive_type"_a, "offset"_a, "count"_a, "indexed"_a = false)
+        .def("draw_array_instanced", &Shader::draw_array_instanced,
+             D(Shader, draw_array_instanced), "primitive_type"_a, "offset"_a, "count"_a,
+             "instance_count"_a, "indexed"_a = false)
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         .def("shader_handle", &Shader::shader_handle)
+        .def_static("set_program_cache_directory", &Shader::set_program_cache_directory,
+                    D(Shader, set_program_cache_directory), "path"_a)
+        .def_static("program_cache_directory", &Shader::program_cache_directory,
+                    D(Shader, program_cache_directory))
+        .def_static("program_cache_stats", &Shader::program_cache_stats,
+                    D(Shader, program_cache_stats), py::return_value_policy::copy)
 #elif defined(NANOGUI_USE_METAL)
         .def("pipeline_state", &Shader::pipeline_state)
 #endif
-#if defined(NANOGUI_USE_OPENGL)
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
         .def("vertex_array_handle", &Shader::vertex_array_handle)
 #endif
         ;
 
+    py::class_<Shader::BindingHandle>(shader, "BindingHandle", D(Shader, BindingHandle))
+        .def_readonly("index", &Shader::BindingHandle::index);
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    py::class_<Shader::ProgramCacheStats>(shader, "ProgramCacheStats", D(Shader, ProgramCacheStats))
+        .def_readonly("hits", &Shader::ProgramCacheStats::hits, D(Shader, ProgramCacheStats, hits))
+        .def_readonly("misses", &Shader::ProgramCacheStats::misses, D(Shader, ProgramCacheStats, misses))
+        .def_readonly("rejected", &Shader::ProgramCacheStats::rejected,
+                      D(Shader, ProgramCacheStats, rejected))
+        .def_readonly("stored", &Shader::ProgramCacheStats::stored, D(Shader, ProgramCacheStats, stored));
+#endif
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    py::class_<UniformRing, Object, ref<UniformRing>>(m, "UniformRing", D(UniformRing))
+        .def(py::init<size_t>(), D(UniformRing, UniformRing), "size"_a = 1024 * 1024)
+        .def("size", &UniformRing::size, D(UniformRing, size))
+        .def("generation", &UniformRing::generation, D(UniformRing, generation))
+        .def("buffer_handle", &UniformRing::buffer_handle, D(UniformRing, buffer_handle));
+
+    py::class_<GLState>(m, "GLState", D(GLState))
+        .def_static("current", &GLState::current, py::return_value_policy::reference,
+                    D(GLState, current))
+        .def("invalidate", &GLState::invalidate, D(GLState, invalidate))
+        .def("framebuffer", &GLState::framebuffer, D(GLState, framebuffer))
+        .def("redundant_calls", &GLState::redundant_calls, D(GLState, redundant_calls))
+        .def("reset_redundant_calls", &GLState::reset_redundant_calls,
+             D(GLState, reset_redundant_calls));
+#endif
+
     py::enum_<PrimitiveType>(shader, "PrimitiveType", D(Shader, PrimitiveType))
         .value("Point", PrimitiveType::Point, D(Shader, PrimitiveType, Point))
         .value("Line", PrimitiveType::Line, D(Shader, PrimitiveType, Line))
@@ -230,6 +565,25 @@ void register_render(py::module &m) {
         .value("Triangle", PrimitiveType::Triangle, D(Shader, PrimitiveType, Triangle))
         .value("TriangleStrip", PrimitiveType::TriangleStrip, D(Shader, PrimitiveType, TriangleStrip));
 
+    auto gputimer = py::class_<GPUTimer, Object, ref<GPUTimer>>(m, "GPUTimer", D(GPUTimer))
+        .def(py::init<>(), D(GPUTimer, GPUTimer))
+        .def_static("supported", &GPUTimer::supported, D(GPUTimer, supported))
+        .def("begin", &GPUTimer::begin, D(GPUTimer, begin))
+        .def("end", &GPUTimer::end, D(GPUTimer, end))
+        .def("collect", &GPUTimer::collect, D(GPUTimer, collect))
+        .def("add_sample", &GPUTimer::add_sample, D(GPUTimer, add_sample))
+        .def("stats", &GPUTimer::stats, D(GPUTimer, stats))
+        .def("reset", &GPUTimer::reset, D(GPUTimer, reset))
+        .def("__enter__", &GPUTimer::begin)
+        .def("__exit__", [](GPUTimer &t, py::handle, py::handle, py::handle) { t.end(); });
+
+    py::class_<GPUTimer::Stats>(gputimer, "Stats", D(GPUTimer, Stats))
+        .def_readonly("last", &GPUTimer::Stats::last, D(GPUTimer, Stats, last))
+        .def_readonly("min", &GPUTimer::Stats::min)
+        .def_readonly("max", &GPUTimer::Stats::max)
+        .def_readonly("mean", &GPUTimer::Stats::mean)
+        .def_readonly("samples", &GPUTimer::Stats::samples, D(GPUTimer, Stats, samples));
+
     auto renderpass = py::class_<RenderPass, Object, ref<RenderPass>>(m, "RenderPass", D(RenderPass))
         .def(py::init<std::vector<Object *>, Object *, Object *, Object *, bool>(),
              D(RenderPass, RenderPass), "color_targets"_a, "depth_target"_a = nullptr,
@@ -246,6 +600,8 @@ void register_render(py::module &m) {
         .def("depth_test", &RenderPass::depth_test, D(RenderPass, depth_test))
         .def("set_cull_mode", &RenderPass::set_cull_mode, D(RenderPass, set_cull_mode))
         .def("cull_mode", &RenderPass::cull_mode, D(RenderPass, cull_mode))
+        .def("set_gpu_timing", &RenderPass::set_gpu_timing, D(RenderPass, set_gpu_timing))
+        .def("gpu_timer", &RenderPass::gpu_timer, D(RenderPass, gpu_timer))
         .def("begin", &RenderPass::begin, D(RenderPass, begin))
         .def("end", &RenderPass::end, D(RenderPass, end))
         .def("resize", &RenderPass::resize, D(RenderPass, resize))
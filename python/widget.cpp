@@ -110,6 +110,7 @@ void register_widget(py::module &m) {
         .def("framebuffer_size", &Screen::framebuffer_size, D(Screen, framebuffer_size))
         .def("perform_layout", (void(Screen::*)(void)) &Screen::perform_layout, D(Screen, perform_layout))
         .def("redraw", &Screen::redraw, D(Screen, redraw))
+        .def_static("redraw_async", &Screen::redraw_async, D(Screen, redraw_async))
         .def("clear", &Screen::clear, D(Screen, clear))
         .def("draw_all", &Screen::draw_all, D(Screen, draw_all))
         .def("draw_contents", &Screen::draw_contents, D(Screen, draw_contents))
@@ -129,6 +130,13 @@ void register_widget(py::module &m) {
         .def("pixel_format", &Screen::pixel_format, D(Screen, pixel_format))
         .def("component_format", &Screen::component_format, D(Screen, component_format))
         .def("nvg_flush", &Screen::nvg_flush, D(Screen, nvg_flush))
+        .def("nvg_texture_image", &Screen::nvg_texture_image, D(Screen, nvg_texture_image))
+        .def("set_nvg_gpu_timing", &Screen::set_nvg_gpu_timing, D(Screen, set_nvg_gpu_timing))
+        .def("nvg_gpu_timer", &Screen::nvg_gpu_timer, D(Screen, nvg_gpu_timer))
+        .def("texture_loader", &Screen::texture_loader, D(Screen, texture_loader))
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        .def("uniform_ring", &Screen::uniform_ring, D(Screen, uniform_ring))
+#endif
 #if defined(NANOGUI_USE_METAL)
         .def("metal_layer", &Screen::metal_layer)
         .def("metal_texture", &Screen::metal_texture)
@@ -0,0 +1,150 @@
+# Generates the NanoGUI resource bundle (nanogui_resources.cpp)
+#
+# Invoked in script mode with the following parameters:
+#
+#   INPUT_FILES  Comma-separated list of files to embed
+#   OUTPUT_C     Name of the generated C++ file
+#   MODE         "incbin": reference the files via the assembler's .incbin
+#                directive (fast, but requires a GNU-compatible assembler)
+#                "hex": emit the contents as hex array literals (fallback
+#                for MSVC and Emscripten)
+#   COMPRESS     If ON, store every file that shrinks noticeably as a gzip
+#                stream that is inflated on first access (needs CMake 3.18)
+#   WORK_DIR     Directory for intermediate (compressed) files
+#
+# Resources are looked up by their file name via nanogui::resource(), which
+# performs a binary search -- the table is therefore emitted in sorted order.
+
+cmake_minimum_required(VERSION 3.13)
+
+if (NOT MODE)
+  set(MODE "incbin")
+endif()
+
+if (COMPRESS AND CMAKE_VERSION VERSION_LESS 3.18)
+  message(WARNING "bundle.cmake: resource compression requires CMake 3.18, disabling it.")
+  set(COMPRESS OFF)
+endif()
+
+if (NOT WORK_DIR)
+  get_filename_component(WORK_DIR "${OUTPUT_C}" ABSOLUTE)
+  get_filename_component(WORK_DIR "${WORK_DIR}" DIRECTORY)
+endif()
+
+function(resource_size path out)
+  if (CMAKE_VERSION VERSION_LESS 3.14)
+    file(READ "${path}" hex HEX)
+    string(LENGTH "${hex}" len)
+    math(EXPR len "${len} / 2")
+  else()
+    file(SIZE "${path}" len)
+  endif()
+  set(${out} ${len} PARENT_SCOPE)
+endfunction()
+
+# Sort inputs by file name alone (this is the key used at runtime). Sorting
+# "name|path" strings instead would misorder names that are prefixes of
+# each other, since '|' compares greater than e.g. '.' or '_'.
+string(REPLACE "," ";" INPUT_LIST "${INPUT_FILES}")
+set(names "")
+foreach(path IN LISTS INPUT_LIST)
+  get_filename_component(name "${path}" NAME)
+  if (DEFINED "resource_path_${name}")
+    message(FATAL_ERROR "bundle.cmake: duplicate resource name \"${name}\"!")
+  endif()
+  set("resource_path_${name}" "${path}")
+  list(APPEND names "${name}")
+endforeach()
+list(SORT names)
+
+set(decls "")
+set(table_name "")
+set(table_data "")
+set(table_size "")
+set(table_compressed "")
+set(index 0)
+
+foreach(name IN LISTS names)
+  get_filename_component(path "${resource_path_${name}}" ABSOLUTE)
+  set(symbol "nanogui_res_${index}")
+
+  # Optionally compress, but only keep the result if it saves at least 1/8
+  set(compressed "false")
+  resource_size("${path}" size)
+  if (COMPRESS)
+    set(gz_path "${WORK_DIR}/${name}.gz")
+    file(ARCHIVE_CREATE OUTPUT "${gz_path}" PATHS "${path}"
+         FORMAT raw COMPRESSION GZip)
+    resource_size("${gz_path}" gz_size)
+    math(EXPR threshold "${size} - ${size} / 8")
+    if (gz_size LESS threshold)
+      set(path "${gz_path}")
+      set(size ${gz_size})
+      set(compressed "true")
+    else()
+      file(REMOVE "${gz_path}")
+    endif()
+  endif()
+
+  if (MODE STREQUAL "hex")
+    file(READ "${path}" data HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," data "${data}")
+    string(APPEND decls "alignas(16) static const uint8_t ${symbol}[] = {${data}0x00};\n")
+  else()
+    string(APPEND decls "NANOGUI_INCBIN(${symbol}, \"${path}\")\n")
+  endif()
+
+  string(APPEND table_name "    \"${name}\",\n")
+  string(APPEND table_data "    ${symbol},\n")
+  string(APPEND table_size "    ${size},\n")
+  string(APPEND table_compressed "    ${compressed},\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+
+set(out "/* Autogenerated by resources/bundle.cmake -- do not edit */\n\n")
+string(APPEND out "#include <stdint.h>\n\n")
+
+if (NOT MODE STREQUAL "hex")
+  string(APPEND out [=[
+#if defined(__APPLE__)
+#  define NANOGUI_RES_SECTION ".const_data\n"
+#  define NANOGUI_RES_SYM(name) "_" #name
+#  define NANOGUI_RES_HIDE(sym) ".private_extern " sym "\n"
+#elif defined(_WIN32)
+#  define NANOGUI_RES_SECTION ".section .rdata,\"dr\"\n"
+#  if defined(_WIN64)
+#    define NANOGUI_RES_SYM(name) #name
+#  else
+#    define NANOGUI_RES_SYM(name) "_" #name
+#  endif
+#  define NANOGUI_RES_HIDE(sym) ""
+#else
+#  define NANOGUI_RES_SECTION ".section .rodata\n"
+#  define NANOGUI_RES_SYM(name) #name
+#  define NANOGUI_RES_HIDE(sym) ".hidden " sym "\n"
+#endif
+
+/* Let the assembler pull in the file contents directly (plus a trailing
+   zero byte so that text resources are NUL-terminated) */
+#define NANOGUI_INCBIN(name, file)                                       \
+    __asm__(NANOGUI_RES_SECTION                                           \
+            ".global " NANOGUI_RES_SYM(name) "\n"                         \
+            NANOGUI_RES_HIDE(NANOGUI_RES_SYM(name))                       \
+            ".balign 16\n"                                                \
+            NANOGUI_RES_SYM(name) ":\n"                                   \
+            ".incbin \"" file "\"\n"                                      \
+            ".byte 0\n"                                                   \
+            ".text\n");                                                   \
+    extern "C" const uint8_t name[];
+
+]=])
+endif()
+
+string(APPEND out "${decls}\n")
+string(APPEND out "extern const uint32_t nanogui_resource_count = ${index};\n\n")
+string(APPEND out "extern const char *const nanogui_resource_name[] = {\n${table_name}    nullptr\n};\n\n")
+string(APPEND out "extern const uint8_t *const nanogui_resource_data[] = {\n${table_data}    nullptr\n};\n\n")
+string(APPEND out "extern const uint32_t nanogui_resource_size[] = {\n${table_size}    0\n};\n\n")
+string(APPEND out "extern const bool nanogui_resource_compressed[] = {\n${table_compressed}    false\n};\n")
+
+file(WRITE "${OUTPUT_C}" "${out}")
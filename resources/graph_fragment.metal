@@ -0,0 +1,15 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float dist;
+    float edge;
+};
+
+fragment float4 fragment_main(VertexOut vert [[stage_in]],
+                              constant float4 &color) {
+    float alpha = clamp(vert.edge - abs(vert.dist), 0.f, 1.f);
+    return float4(color.rgb, color.a * alpha);
+}
@@ -0,0 +1,76 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float dist;
+    float edge;
+};
+
+/* Sample with the given age (0: newest), wrapped into rows of the texture */
+static float sample_at(texture2d<float, access::read> samples,
+                       int head, int slots, int row, int age) {
+    int slot = (head - age + slots) % slots;
+    return samples.read(uint2(slot % row, slot / row)).r;
+}
+
+vertex VertexOut vertex_main(texture2d<float, access::read> samples,
+                             constant float2 &size,
+                             constant float &spacing,
+                             constant int &head,
+                             constant int &slots,
+                             constant int &count,
+                             constant int &row,
+                             constant float &stroke_width,
+                             constant float &fill,
+                             uint id [[vertex_id]]) {
+    /* One quad per pixel column, counted from the right edge. The two
+       triangles use corners 0-1-2 and 2-1-3, where bit 0 selects the right
+       edge and bit 1 the bottom. */
+    int column = (int) id / 6, corner = (int) id % 6;
+    corner = corner < 3 ? corner : (corner == 3 ? 2 : (corner == 4 ? 1 : 3));
+
+    /* Range of the curve within the column: its values at both edges
+       (interpolated between samples) and at all samples in between */
+    float a[2] = { column / spacing, min((column + 1) / spacing, (float) (count - 1)) };
+    float lo = INFINITY, hi = -INFINITY;
+    for (int k = 0; k < 2; ++k) {
+        int i = (int) a[k];
+        float t = a[k] - i,
+              v = sample_at(samples, head, slots, row, i);
+        if (t > 0.f)
+            v = mix(v, sample_at(samples, head, slots, row, i + 1), t);
+        lo = min(lo, v);
+        hi = max(hi, v);
+    }
+    for (int i = (int) a[0] + 1; i < a[1]; ++i) {
+        float v = sample_at(samples, head, slots, row, i);
+        lo = min(lo, v);
+        hi = max(hi, v);
+    }
+
+    float x = size.x - ((corner & 1) ? a[0] : a[1]) * spacing,
+          top = (1.f - hi) * size.y,
+          bottom = (1.f - lo) * size.y,
+          y;
+    bool lower = (corner & 2) != 0;
+
+    VertexOut vert;
+    if (fill > .5f) {
+        /* Area below the curve */
+        y = lower ? size.y : top;
+        vert.dist = 0.f;
+        vert.edge = 1.f;
+    } else {
+        /* Widen the range by the stroke width, plus a one pixel margin for
+           anti-aliasing */
+        float half_height = .5f * (bottom - top + stroke_width);
+        vert.dist = lower ? half_height + 1.f : -(half_height + 1.f);
+        vert.edge = half_height + .5f;
+        y = .5f * (top + bottom) + vert.dist;
+    }
+
+    vert.position = float4(x / size.x * 2.f - 1.f, 1.f - y / size.y * 2.f, 0.f, 1.f);
+    return vert;
+}
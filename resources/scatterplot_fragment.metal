@@ -0,0 +1,18 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float point_size [[point_size]];
+    float4 color;
+    float size;
+};
+
+fragment float4 fragment_main(VertexOut vert [[stage_in]],
+                              float2 point_coord [[point_coord]]) {
+    /* Round, anti-aliased point sprite (with a one pixel margin) */
+    float dist = length(point_coord - .5f) * (vert.size + 1.f);
+    float alpha = clamp(.5f * vert.size + .5f - dist, 0.f, 1.f);
+    return float4(vert.color.rgb, vert.color.a * alpha);
+}
@@ -0,0 +1,24 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float point_size [[point_size]];
+    float4 color;
+    float size;
+};
+
+vertex VertexOut vertex_main(const device float2 *position,
+                             constant float2 &scale,
+                             constant float2 &offset,
+                             constant float &point_size,
+                             constant float4 &point_color,
+                             uint id [[vertex_id]]) {
+    VertexOut vert;
+    vert.position = float4(position[id] * scale + offset, 0.f, 1.f);
+    vert.point_size = point_size + 1.f;
+    vert.color = point_color;
+    vert.size = point_size;
+    return vert;
+}
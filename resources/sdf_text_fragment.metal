@@ -0,0 +1,20 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float2 uv;
+    float4 color;
+    float2 params;
+};
+
+fragment float4 fragment_main(VertexOut vert [[stage_in]],
+                              texture2d<float, access::sample> font,
+                              sampler font_sampler) {
+    /* params.x: iso-value of the glyph outline, params.y: smoothing width */
+    float dist = font.sample(font_sampler, vert.uv).r;
+    float alpha = smoothstep(vert.params.x - vert.params.y,
+                             vert.params.x + vert.params.y, dist);
+    return float4(vert.color.rgb, vert.color.a * alpha);
+}
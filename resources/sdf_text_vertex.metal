@@ -0,0 +1,25 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float2 uv;
+    float4 color;
+    float2 params;
+};
+
+vertex VertexOut vertex_main(const device float2 *position,
+                             const device float2 *uv,
+                             const device float4 *color,
+                             const device float2 *params,
+                             constant float4x4 &mvp,
+                             constant float2 &atlas_size,
+                             uint id [[vertex_id]]) {
+    VertexOut vert;
+    vert.position = mvp * float4(position[id], 0.f, 1.f);
+    vert.uv = uv[id] / atlas_size;
+    vert.color = color[id];
+    vert.params = params[id];
+    return vert;
+}
@@ -0,0 +1,25 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position [[position]];
+    float2 uv;
+};
+
+fragment float4 fragment_main(VertexOut vert [[stage_in]],
+                              texture2d<float, access::sample> spectrum,
+                              texture2d<float, access::sample> colormap,
+                              sampler spectrum_sampler,
+                              sampler colormap_sampler,
+                              constant float &scroll,
+                              constant float &history,
+                              constant float &bins) {
+    /* Columns are stored as rows of a ring buffer; wrap around so that the
+       newest one ends up at the right edge */
+    float t = fract(scroll + (.5f + vert.uv.x * (history - 1.f)) / history);
+    /* Stay within the outer bins, since the texture repeats along both axes */
+    float s = (.5f + vert.uv.y * (bins - 1.f)) / bins;
+    float value = spectrum.sample(spectrum_sampler, float2(s, t)).r;
+    return colormap.sample(colormap_sampler, float2(value * (255.f / 256.f) + .5f / 256.f, .5f));
+}
@@ -0,0 +1,59 @@
+/*
+    src/bench_resources.cpp -- Startup-time benchmark of the embedded
+    resource bundle: measures the cost of the first (cold) access of each
+    resource, which includes page faults and decompression, and compares it
+    to subsequent (warm) accesses that are served from the cache.
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/resources.h>
+#include <chrono>
+#include <cstdio>
+
+using namespace nanogui;
+using Clock = std::chrono::high_resolution_clock;
+
+static double elapsed_us(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+int main(int /* argc */, char ** /* argv */) {
+    const int warm_iterations = 1000;
+    std::vector<std::string> names = resource_names();
+
+    double total_cold = 0.0, total_warm = 0.0;
+    size_t total_size = 0;
+
+    printf("%-32s %10s %12s %12s\n", "Resource", "Size", "Cold (us)", "Warm (us)");
+
+    for (const std::string &name : names) {
+        Clock::time_point start = Clock::now();
+        std::string_view data = resource(name);
+
+        /* Touch every page so that lazily mapped data is accounted for */
+        volatile uint8_t checksum = 0;
+        for (size_t i = 0; i < data.size(); i += 4096)
+            checksum = checksum ^ (uint8_t) data[i];
+        double cold = elapsed_us(start);
+
+        start = Clock::now();
+        for (int i = 0; i < warm_iterations; ++i)
+            data = resource(name);
+        double warm = elapsed_us(start) / warm_iterations;
+
+        printf("%-32s %10zu %12.2f %12.4f\n", name.c_str(), data.size(), cold, warm);
+
+        total_cold += cold;
+        total_warm += warm;
+        total_size += data.size();
+    }
+
+    printf("%-32s %10zu %12.2f %12.4f\n", "Total", total_size, total_cold, total_warm);
+    return 0;
+}
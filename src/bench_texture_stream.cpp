@@ -0,0 +1,134 @@
+/*
+    src/bench_texture_stream.cpp -- Throughput benchmark of texture
+    uploads: compares synchronous Texture::upload() calls to a TextureStream
+    that is fed by a producer thread, reporting the time that the render
+    thread spends per frame along with the overall frame rate.
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/screen.h>
+#include <nanogui/texture.h>
+#include <nanogui/opengl.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace nanogui;
+using Clock = std::chrono::high_resolution_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/// Wait until the GPU has processed all submitted work
+static void finish() {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    glFinish();
+#endif
+}
+
+static void report(const char *name, size_t frames, size_t frame_size,
+                   double render_thread_ms, double total_ms) {
+    printf("%-24s %8zu %16.3f %12.1f %12.1f\n", name, frames,
+           render_thread_ms / frames, frames * 1000.0 / total_ms,
+           frames * (double) frame_size / (total_ms * 1e3));
+}
+
+int main(int argc, char **argv) {
+    Vector2i size(3840, 2160);
+    size_t frames = argc > 1 ? (size_t) atoi(argv[1]) : 240;
+
+    nanogui::init();
+
+    {
+        ref<Screen> screen = new Screen(Vector2i(256, 256), "bench_texture_stream", false);
+
+        ref<Texture> texture = new Texture(
+            Texture::PixelFormat::RGBA, Texture::ComponentFormat::UInt8, size,
+            Texture::InterpolationMode::Nearest, Texture::InterpolationMode::Nearest);
+
+        size_t frame_size = texture->bytes_per_pixel() * (size_t) size.x() * (size_t) size.y();
+
+        /* A few distinct source frames, as produced by a decoder */
+        const size_t sources = 4;
+        std::unique_ptr<uint8_t[]> source(new uint8_t[sources * frame_size]);
+        for (size_t i = 0; i < sources * frame_size; ++i)
+            source[i] = (uint8_t) (i * 31 + i / frame_size);
+
+        printf("%-24s %8s %16s %12s %12s\n", "Method", "Frames",
+               "Render (ms/fr)", "Frames/s", "MB/s");
+
+        /* 1. Synchronous uploads issued by the render thread */
+        texture->upload(source.get());
+        finish();
+
+        Clock::time_point start = Clock::now();
+        double render_ms = 0.0;
+        for (size_t i = 0; i < frames; ++i) {
+            Clock::time_point t = Clock::now();
+            texture->upload(source.get() + (i % sources) * frame_size);
+            render_ms += elapsed_ms(t);
+        }
+        finish();
+        report("Texture::upload", frames, frame_size, render_ms, elapsed_ms(start));
+
+        /* 2. Streaming uploads: a producer thread writes into mapped buffers */
+        for (size_t buffer_count : { (size_t) 2, (size_t) 3, (size_t) 4 }) {
+            ref<TextureStream> stream = new TextureStream(texture, buffer_count);
+            std::atomic<bool> stop { false };
+
+            std::thread producer([&]() {
+                size_t produced = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    uint8_t *data = stream->map_next();
+                    if (!data) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    memcpy(data, source.get() + (produced++ % sources) * frame_size,
+                           frame_size);
+                    stream->commit(data);
+                }
+            });
+
+            start = Clock::now();
+            render_ms = 0.0;
+            size_t uploaded = 0;
+            while (uploaded < frames) {
+                Clock::time_point t = Clock::now();
+                bool updated = stream->update();
+                render_ms += elapsed_ms(t);
+                if (updated)
+                    uploaded++;
+                else
+                    std::this_thread::yield();
+            }
+            finish();
+            double total_ms = elapsed_ms(start);
+
+            stop = true;
+            producer.join();
+
+            char name[32];
+            snprintf(name, sizeof(name), "TextureStream (%zu bufs)", buffer_count);
+            report(name, frames, frame_size, render_ms, total_ms);
+            printf("%-24s %8llu frames superseded before upload\n", "",
+                   (unsigned long long) stream->frames_dropped());
+
+            /* Release the stream's buffers while the context is alive */
+            stream = nullptr;
+        }
+    }
+
+    nanogui::shutdown();
+    return 0;
+}
@@ -18,14 +18,15 @@
 #include <nanogui/renderpass.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
 
 NAMESPACE_BEGIN(nanogui)
 
 Canvas::Canvas(Widget *parent, uint8_t samples,
                bool has_depth_buffer, bool has_stencil_buffer,
-               bool clear)
-    : Widget(parent), m_draw_border(true) {
+               bool clear, bool deferred)
+    : Widget(parent), m_draw_border(true), m_deferred(deferred) {
     m_size = Vector2i(250, 250);
     m_border_color = m_theme->m_border_light;
 
@@ -37,7 +38,8 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
     if (scr == nullptr)
         throw std::runtime_error("Canvas::Canvas(): could not find parent screen!");
 
-    m_render_to_texture = samples != 1
+    m_render_to_texture = deferred
+        || samples != 1
         || (has_depth_buffer && !scr->has_depth_buffer())
         || (has_stencil_buffer && !scr->has_stencil_buffer());
 
@@ -57,6 +59,15 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
 #endif
         }
     } else {
+        /* A deferred canvas is sampled by NanoVG, after resolving it if
+           multisampled (Metal always needs the resolve pass for blitting) */
+#if defined(NANOGUI_USE_METAL)
+        bool resolve = samples > 1;
+#else
+        bool resolve = samples > 1 && deferred;
+#endif
+        uint8_t read_flag = deferred ? (uint8_t) Texture::TextureFlags::ShaderRead : 0;
+
         color_texture = new Texture(
             scr->pixel_format(),
             scr->component_format(),
@@ -65,14 +76,11 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
             Texture::InterpolationMode::Bilinear,
             Texture::WrapMode::ClampToEdge,
             samples,
-            Texture::TextureFlags::RenderTarget
+            Texture::TextureFlags::RenderTarget | (resolve ? 0 : read_flag)
         );
 
-#if defined(NANOGUI_USE_METAL)
-        Texture *color_texture_resolved = nullptr;
-
-        if (samples > 1) {
-            color_texture_resolved = new Texture(
+        if (resolve) {
+            Texture *color_texture_resolved = new Texture(
                 scr->pixel_format(),
                 scr->component_format(),
                 m_size,
@@ -80,14 +88,14 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
                 Texture::InterpolationMode::Bilinear,
                 Texture::WrapMode::ClampToEdge,
                 1,
-                Texture::TextureFlags::RenderTarget
+                Texture::TextureFlags::RenderTarget | read_flag
             );
+            color_texture_resolved->set_owner("Canvas");
 
             m_render_pass_resolved = new RenderPass(
                 { color_texture_resolved }
             );
         }
-#endif
 
         depth_texture = new Texture(
             has_stencil_buffer ? Texture::PixelFormat::DepthStencil
@@ -100,23 +108,23 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
             samples,
             Texture::TextureFlags::RenderTarget
         );
+
+        ((Texture *) color_texture)->set_owner("Canvas");
+        ((Texture *) depth_texture)->set_owner("Canvas");
     }
 
     m_render_pass = new RenderPass(
         { color_texture },
         depth_texture,
         has_stencil_buffer ? depth_texture : nullptr,
-#if defined(NANOGUI_USE_METAL)
         m_render_pass_resolved,
-#else
-        nullptr,
-#endif
         clear
     );
 }
 
 void Canvas::set_background_color(const Color &background_color) {
     m_render_pass->set_clear_color(0, background_color);
+    m_content_dirty = true;
 }
 
 const Color& Canvas::background_color() const {
@@ -134,7 +142,10 @@ void Canvas::draw(NVGcontext *ctx) {
 
     Widget::draw(ctx);
 
-    scr->nvg_flush();
+    /* NanoVG only submits its commands at the end of the frame, so that the
+       render pass of a deferred canvas runs first in any case */
+    if (!m_deferred)
+        scr->nvg_flush();
 
     Vector2i fbsize = m_size;
     Vector2i offset = absolute_position();
@@ -152,20 +163,49 @@ void Canvas::draw(NVGcontext *ctx) {
     fbsize = Vector2i(Vector2f(fbsize) * pixel_ratio);
     offset = Vector2i(Vector2f(offset) * pixel_ratio);
 
-    if (m_render_to_texture) {
-        m_render_pass->resize(fbsize);
-#if defined(NANOGUI_USE_METAL)
-        if (m_render_pass_resolved)
-            m_render_pass_resolved->resize(fbsize);
+    /* A retained canvas keeps the previous contents of its texture */
+    bool render = !(m_retained && m_render_to_texture) || m_content_dirty ||
+                  m_content_size != fbsize;
+
+    if (render) {
+        if (m_render_to_texture) {
+            m_render_pass->resize(fbsize);
+            if (m_render_pass_resolved)
+                m_render_pass_resolved->resize(fbsize);
+        } else {
+            m_render_pass->resize(scr->framebuffer_size());
+            m_render_pass->set_viewport(offset, fbsize);
+        }
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        /* NanoVG binds textures when it updates its font atlas */
+        if (m_deferred)
+            GLState::current().invalidate_textures();
 #endif
-    } else {
-        m_render_pass->resize(scr->framebuffer_size());
-        m_render_pass->set_viewport(offset, fbsize);
+
+        m_render_pass->begin();
+        draw_contents();
+        m_render_pass->end();
+
+        m_content_dirty = false;
+        m_content_size = fbsize;
     }
 
-    m_render_pass->begin();
-    draw_contents();
-    m_render_pass->end();
+    if (m_deferred) {
+        RenderPass *rp = m_render_pass_resolved ? m_render_pass_resolved.get()
+                                                : m_render_pass.get();
+        int image = scr->nvg_texture_image((Texture *) rp->targets()[2].get());
+        float inset = m_draw_border ? 1.f : 0.f;
+        Vector2f pos = Vector2f(m_pos) + inset,
+                 size = Vector2f(m_size) - 2.f * inset;
+
+        NVGpaint paint = nvgImagePattern(ctx, pos.x(), pos.y(), size.x(), size.y(),
+                                         0.f, image, 1.f);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, pos.x(), pos.y(), size.x(), size.y());
+        nvgFillPaint(ctx, paint);
+        nvgFill(ctx);
+    }
 
     if (m_draw_border) {
         nvgBeginPath(ctx);
@@ -177,12 +217,10 @@ void Canvas::draw(NVGcontext *ctx) {
         nvgStroke(ctx);
     }
 
-    if (m_render_to_texture) {
+    if (m_render_to_texture && !m_deferred) {
         RenderPass *rp = m_render_pass;
-#if defined(NANOGUI_USE_METAL)
         if (m_render_pass_resolved)
             rp = m_render_pass_resolved;
-#endif
         rp->blit_to(Vector2i(0, 0), fbsize, scr, offset);
     }
 }
@@ -0,0 +1,216 @@
+/*
+    src/glstate_gl.cpp -- Client-side cache of the OpenGL state that is
+    modified by render passes, shaders, and textures
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/glstate.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+
+NAMESPACE_BEGIN(nanogui)
+
+static void gl_set_enabled(GLenum capability, bool enabled) {
+    if (enabled)
+        CHK(glEnable(capability));
+    else
+        CHK(glDisable(capability));
+}
+
+GLState &GLState::current() {
+    static GLState state;
+    return state;
+}
+
+void GLState::invalidate() {
+    m_state.valid = 0;
+    m_program.valid = false;
+    m_vertex_array.valid = false;
+    m_read_framebuffer.valid = false;
+    m_draw_framebuffer.valid = false;
+    invalidate_textures();
+}
+
+void GLState::invalidate_textures() {
+    m_active_texture.valid = false;
+    for (Binding &texture : m_textures)
+        texture.valid = false;
+}
+
+void GLState::set_viewport(const Vector4i &viewport) {
+    if (update(m_state.viewport, viewport, State::Viewport))
+        CHK(glViewport(viewport.x(), viewport.y(), viewport.z(), viewport.w()));
+}
+
+void GLState::set_scissor(const Vector4i &scissor) {
+    if (update(m_state.scissor, scissor, State::Scissor))
+        CHK(glScissor(scissor.x(), scissor.y(), scissor.z(), scissor.w()));
+}
+
+void GLState::set_depth_test(bool enabled) {
+    if (update(m_state.depth_test, enabled, State::DepthTest))
+        gl_set_enabled(GL_DEPTH_TEST, enabled);
+}
+
+void GLState::set_depth_func(uint32_t func) {
+    if (update(m_state.depth_func, func, State::DepthFunc))
+        CHK(glDepthFunc((GLenum) func));
+}
+
+void GLState::set_depth_mask(bool enabled) {
+    if (update(m_state.depth_mask, enabled, State::DepthMask))
+        CHK(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+}
+
+void GLState::set_scissor_test(bool enabled) {
+    if (update(m_state.scissor_test, enabled, State::ScissorTest))
+        gl_set_enabled(GL_SCISSOR_TEST, enabled);
+}
+
+void GLState::set_cull_face(bool enabled) {
+    if (update(m_state.cull_face, enabled, State::CullFace))
+        gl_set_enabled(GL_CULL_FACE, enabled);
+}
+
+void GLState::set_cull_face_mode(uint32_t mode) {
+    if (update(m_state.cull_face_mode, mode, State::CullFaceMode))
+        CHK(glCullFace((GLenum) mode));
+}
+
+void GLState::set_blend(bool enabled) {
+    if (update(m_state.blend, enabled, State::Blend))
+        gl_set_enabled(GL_BLEND, enabled);
+}
+
+void GLState::set_blend_func(uint32_t src, uint32_t dst) {
+    if ((m_state.valid & State::BlendFunc) && m_state.blend_src == src &&
+        m_state.blend_dst == dst) {
+        m_redundant_calls++;
+        return;
+    }
+    m_state.blend_src = src;
+    m_state.blend_dst = dst;
+    m_state.valid |= State::BlendFunc;
+    CHK(glBlendFunc((GLenum) src, (GLenum) dst));
+}
+
+#if defined(NANOGUI_USE_OPENGL)
+void GLState::set_program_point_size(bool enabled) {
+    if (update(m_state.program_point_size, enabled, State::ProgramPointSize))
+        gl_set_enabled(GL_PROGRAM_POINT_SIZE, enabled);
+}
+#endif
+
+void GLState::restore(const State &state) {
+    uint32_t valid = state.valid;
+    if (valid & State::Viewport)
+        set_viewport(state.viewport);
+    if (valid & State::Scissor)
+        set_scissor(state.scissor);
+    if (valid & State::DepthTest)
+        set_depth_test(state.depth_test);
+    if (valid & State::DepthFunc)
+        set_depth_func(state.depth_func);
+    if (valid & State::DepthMask)
+        set_depth_mask(state.depth_mask);
+    if (valid & State::ScissorTest)
+        set_scissor_test(state.scissor_test);
+    if (valid & State::CullFace)
+        set_cull_face(state.cull_face);
+    if (valid & State::CullFaceMode)
+        set_cull_face_mode(state.cull_face_mode);
+    if (valid & State::Blend)
+        set_blend(state.blend);
+    if (valid & State::BlendFunc)
+        set_blend_func(state.blend_src, state.blend_dst);
+#if defined(NANOGUI_USE_OPENGL)
+    if (valid & State::ProgramPointSize)
+        set_program_point_size(state.program_point_size);
+#endif
+}
+
+void GLState::use_program(uint32_t program) {
+    if (update(m_program, program))
+        CHK(glUseProgram((GLuint) program));
+}
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+void GLState::bind_vertex_array(uint32_t vertex_array) {
+    if (update(m_vertex_array, vertex_array))
+        CHK(glBindVertexArray((GLuint) vertex_array));
+}
+#endif
+
+void GLState::bind_framebuffer(uint32_t target, uint32_t framebuffer) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    /* GLES 2 has a single framebuffer binding */
+    (void) target;
+    if (update(m_draw_framebuffer, framebuffer))
+        CHK(glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) framebuffer));
+#else
+    if (target == GL_FRAMEBUFFER) {
+        if (m_read_framebuffer.valid && m_draw_framebuffer.valid &&
+            m_read_framebuffer.value == framebuffer &&
+            m_draw_framebuffer.value == framebuffer) {
+            m_redundant_calls++;
+            return;
+        }
+        m_read_framebuffer = m_draw_framebuffer = Binding{ framebuffer, true };
+        CHK(glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) framebuffer));
+    } else {
+        Binding &binding = target == GL_READ_FRAMEBUFFER ? m_read_framebuffer
+                                                         : m_draw_framebuffer;
+        if (update(binding, framebuffer))
+            CHK(glBindFramebuffer((GLenum) target, (GLuint) framebuffer));
+    }
+#endif
+}
+
+void GLState::bind_texture(uint32_t unit, uint32_t target, uint32_t texture) {
+    if (update(m_active_texture, unit))
+        CHK(glActiveTexture((GLenum) (GL_TEXTURE0 + unit)));
+
+    /* Only 2D textures are cached (a unit has one binding per target) */
+    if (target != GL_TEXTURE_2D || unit >= TextureUnits) {
+        CHK(glBindTexture((GLenum) target, (GLuint) texture));
+        return;
+    }
+
+    if (update(m_textures[unit], texture))
+        CHK(glBindTexture(GL_TEXTURE_2D, (GLuint) texture));
+}
+
+void GLState::texture_deleted(uint32_t texture) {
+    for (Binding &binding : m_textures) {
+        if (binding.valid && binding.value == texture)
+            binding.value = 0;
+    }
+}
+
+void GLState::program_deleted(uint32_t program) {
+    /* A program that is in use is only deleted once it is unbound */
+    if (m_program.valid && m_program.value == program)
+        use_program(0);
+}
+
+void GLState::framebuffer_deleted(uint32_t framebuffer) {
+    if (m_read_framebuffer.valid && m_read_framebuffer.value == framebuffer)
+        m_read_framebuffer.value = 0;
+    if (m_draw_framebuffer.valid && m_draw_framebuffer.value == framebuffer)
+        m_draw_framebuffer.value = 0;
+}
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+void GLState::vertex_array_deleted(uint32_t vertex_array) {
+    if (m_vertex_array.valid && m_vertex_array.value == vertex_array)
+        m_vertex_array.value = 0;
+}
+#endif
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,44 @@
+/*
+    src/gputimer.cpp -- Asynchronous measurement of the GPU time spent
+    by render passes and NanoVG
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/gputimer.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+GPUTimer::GPUTimer() { }
+
+void GPUTimer::add_sample(double milliseconds) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    Stats &s = m_stats;
+    if (s.samples == 0) {
+        s.min = s.max = milliseconds;
+    } else {
+        s.min = std::min(s.min, milliseconds);
+        s.max = std::max(s.max, milliseconds);
+    }
+    s.last = milliseconds;
+    s.samples++;
+    s.mean += (milliseconds - s.mean) / (double) s.samples;
+}
+
+GPUTimer::Stats GPUTimer::stats() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_stats;
+}
+
+void GPUTimer::reset() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stats = Stats();
+}
+
+NAMESPACE_END(nanogui)
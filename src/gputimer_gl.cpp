@@ -0,0 +1,122 @@
+/*
+    src/gputimer_gl.cpp -- Asynchronous measurement of the GPU time spent
+    by render passes and NanoVG
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/gputimer.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+#include "opengl_extensions.h"
+
+/* GLES 2 lacks query objects altogether */
+#if defined(NANOGUI_USE_OPENGL)
+#  define NANOGUI_TIMER_QUERY GL_TIME_ELAPSED
+#elif NANOGUI_GLES_VERSION >= 3
+#  define NANOGUI_TIMER_QUERY GL_TIME_ELAPSED_EXT
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_TIMER_QUERY)
+/// Timer that is currently measuring an interval (queries cannot be nested)
+static GPUTimer *active_timer = nullptr;
+#endif
+
+GPUTimer::~GPUTimer() {
+#if defined(NANOGUI_TIMER_QUERY)
+    if (active_timer == this)
+        active_timer = nullptr;
+    if (m_query)
+        m_free.push_back(m_query);
+    for (uint32_t query : m_pending)
+        m_free.push_back(query);
+    if (!m_free.empty())
+        CHK(glDeleteQueries((GLsizei) m_free.size(), m_free.data()));
+#endif
+}
+
+bool GPUTimer::supported() {
+#if defined(NANOGUI_TIMER_QUERY)
+    static int supported = -1;
+#  if defined(NANOGUI_USE_OPENGL)
+    if (supported < 0)
+        supported = gl_supports(33, "GL_ARB_timer_query");
+#  else
+    if (supported < 0)
+        supported = gl_supports(0, "GL_EXT_disjoint_timer_query");
+#  endif
+    return supported != 0;
+#else
+    return false;
+#endif
+}
+
+void GPUTimer::begin() {
+#if defined(NANOGUI_TIMER_QUERY)
+    collect();
+
+    /* Skip the interval if it is nested, or if the results are overdue */
+    if (active_timer || m_pending.size() >= MaxPending || !supported())
+        return;
+
+    if (m_free.empty()) {
+        GLuint query = 0;
+        CHK(glGenQueries(1, &query));
+        m_free.push_back(query);
+    }
+    m_query = m_free.back();
+    m_free.pop_back();
+
+    CHK(glBeginQuery(NANOGUI_TIMER_QUERY, m_query));
+    active_timer = this;
+#endif
+}
+
+void GPUTimer::end() {
+#if defined(NANOGUI_TIMER_QUERY)
+    if (active_timer != this)
+        return;
+    CHK(glEndQuery(NANOGUI_TIMER_QUERY));
+    m_pending.push_back(m_query);
+    m_query = 0;
+    active_timer = nullptr;
+#endif
+}
+
+void GPUTimer::collect() {
+#if defined(NANOGUI_TIMER_QUERY)
+    while (!m_pending.empty()) {
+        GLuint query = m_pending.front();
+        GLuint available = 0;
+        CHK(glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            break;
+
+#if defined(NANOGUI_USE_OPENGL)
+        GLuint64 elapsed = 0;
+        CHK(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed));
+        add_sample((double) elapsed * 1e-6);
+#else
+        /* Results are meaningless if the GPU changed its clock meanwhile */
+        GLuint elapsed = 0;
+        GLint disjoint = 0;
+        CHK(glGetQueryObjectuiv(query, GL_QUERY_RESULT, &elapsed));
+        CHK(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+        if (!disjoint)
+            add_sample((double) elapsed * 1e-6);
+#endif
+
+        m_pending.pop_front();
+        m_free.push_back(query);
+    }
+#endif
+}
+
+NAMESPACE_END(nanogui)
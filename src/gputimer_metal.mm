@@ -0,0 +1,18 @@
+#include <nanogui/gputimer.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Metal lacks timer queries that can be placed around arbitrary commands.
+   Render passes report the GPU time of their command buffers instead. */
+
+GPUTimer::~GPUTimer() { }
+
+bool GPUTimer::supported() { return true; }
+
+void GPUTimer::begin() { }
+
+void GPUTimer::end() { }
+
+void GPUTimer::collect() { }
+
+NAMESPACE_END(nanogui)
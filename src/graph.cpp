@@ -10,11 +10,275 @@
 */
 
 #include <nanogui/graph.h>
+#include <nanogui/screen.h>
+#include <nanogui/renderpass.h>
+#include <nanogui/shader.h>
+#include <nanogui/texture.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 NAMESPACE_BEGIN(nanogui)
 
+TimeSeries::TimeSeries(size_t capacity) {
+    set_capacity(capacity);
+}
+
+void TimeSeries::set_capacity(size_t capacity) {
+    m_capacity = capacity;
+    m_total = 0;
+    m_samples.assign(capacity, 0.f);
+    m_levels.clear();
+
+    /* A level's ring must hold every block that intersects the retained
+       window, i.e. up to capacity / block_size + 2 of them */
+    for (uint64_t block_size = 4; block_size < capacity; block_size *= 4)
+        m_levels.emplace_back(capacity / block_size + 2, Range { 0.f, 0.f });
+}
+
+void TimeSeries::clear() {
+    m_total = 0;
+}
+
+void TimeSeries::push(float value) {
+    if (m_capacity == 0)
+        throw std::runtime_error("TimeSeries::push(): capacity is zero!");
+
+    uint64_t index = m_total++;
+    m_samples[index % m_capacity] = value;
+
+    /* Fold the sample into its level-1 block. Blocks on higher levels are
+       only updated once a child block is complete (amortized O(1) per
+       sample)---min_max() never visits incomplete blocks on those levels. */
+    Range child { value, value };
+    for (size_t l = 0; l < m_levels.size(); ++l) {
+        uint32_t shift = 2 * (uint32_t) (l + 1);
+        std::vector<Range> &level = m_levels[l];
+        Range &range = level[(index >> shift) % level.size()];
+
+        if (((index >> (shift - 2)) & 3) == 0) {
+            range = child; // first child of a new block
+        } else {
+            range.min = std::min(range.min, child.min);
+            range.max = std::max(range.max, child.max);
+        }
+
+        if (((index + 1) & ((uint64_t(1) << shift) - 1)) != 0)
+            break;
+        child = range;
+    }
+}
+
+void TimeSeries::push(const float *values, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        push(values[i]);
+}
+
+void TimeSeries::min_max(uint64_t begin, uint64_t end, float &min, float &max) const {
+    min = std::numeric_limits<float>::infinity();
+    max = -std::numeric_limits<float>::infinity();
+
+    auto combine = [&](size_t l, uint64_t index) {
+        if (l == 0) {
+            float value = at(index);
+            min = std::min(min, value);
+            max = std::max(max, value);
+        } else {
+            const std::vector<Range> &level = m_levels[l - 1];
+            const Range &range = level[(index >> (2 * l)) % level.size()];
+            min = std::min(min, range.min);
+            max = std::max(max, range.max);
+        }
+    };
+
+    /* Peel off unaligned blocks at both ends, then continue one level up.
+       At level 'l', 'begin' and 'end' are always multiples of 4^l. */
+    for (size_t l = 0; begin < end; ++l) {
+        uint64_t block_size = uint64_t(1) << (2 * l);
+
+        if (l == m_levels.size()) {
+            for (; begin < end; begin += block_size)
+                combine(l, begin);
+            break;
+        }
+
+        uint64_t mask = (block_size << 2) - 1;
+        for (; begin < end && (begin & mask) != 0; begin += block_size)
+            combine(l, begin);
+        while (begin < end && (end & mask) != 0) {
+            end -= block_size;
+            combine(l, end);
+        }
+    }
+}
+
+/**
+ * Shared decimation logic for ring buffers and plain arrays. 'value(i)'
+ * returns the i-th sample and 'min_max(begin, end, min, max)' computes the
+ * range of an index interval.
+ */
+template <typename ValueFunc, typename MinMaxFunc>
+static void decimate_series(size_t n, size_t columns, TimeSeries::Decimation decimation,
+                            const ValueFunc &value, const MinMaxFunc &min_max,
+                            std::vector<Vector2f> &out) {
+    out.clear();
+    columns = std::max(columns, (size_t) 1);
+    float scale = n > 1 ? 1.f / (float) (n - 1) : 0.f;
+
+    if (n <= 2 * columns) {
+        for (size_t i = 0; i < n; ++i)
+            out.emplace_back(i * scale, value(i));
+        return;
+    }
+
+    /* Min/max envelope: one or two points per column, ordered so that the
+       polyline first visits the extremum closest to the previous point */
+    auto envelope = [&](size_t cols, std::vector<Vector2f> &result) {
+        float prev = value(0);
+        for (size_t c = 0; c < cols; ++c) {
+            size_t begin = (size_t) ((uint64_t) c * n / cols),
+                   end   = (size_t) ((uint64_t) (c + 1) * n / cols);
+            if (begin == end)
+                continue;
+            float min, max;
+            min_max(begin, end, min, max);
+            float x = .5f * (begin + end - 1) * scale;
+            if (min == max) {
+                result.emplace_back(x, min);
+            } else if (std::abs(prev - min) < std::abs(prev - max)) {
+                result.emplace_back(x, min);
+                result.emplace_back(x, max);
+            } else {
+                result.emplace_back(x, max);
+                result.emplace_back(x, min);
+            }
+            prev = result.back().y();
+        }
+    };
+
+    if (decimation == TimeSeries::Decimation::MinMax) {
+        envelope(columns, out);
+        return;
+    }
+
+    /* LTTB on top of a finer min/max envelope, so that the cost remains
+       independent of the number of samples */
+    std::vector<Vector2f> candidates;
+    envelope(std::min(4 * columns, n / 2), candidates);
+
+    size_t target = 2 * columns;
+    if (candidates.size() <= target) {
+        out.swap(candidates);
+        return;
+    }
+
+    size_t last = candidates.size() - 1, selected = 0;
+    float bucket_size = (float) (candidates.size() - 2) / (float) (target - 2);
+    out.push_back(candidates[0]);
+
+    for (size_t i = 0; i < target - 2; ++i) {
+        size_t begin      = (size_t) (i * bucket_size) + 1,
+               end        = std::min((size_t) ((i + 1) * bucket_size) + 1, last),
+               next_begin = end,
+               next_end   = std::min((size_t) ((i + 2) * bucket_size) + 1, last);
+
+        Vector2f next_avg = candidates[last];
+        if (next_end > next_begin) {
+            next_avg = Vector2f(0.f);
+            for (size_t j = next_begin; j < next_end; ++j)
+                next_avg += candidates[j];
+            next_avg /= (float) (next_end - next_begin);
+        }
+
+        const Vector2f &a = candidates[selected];
+        float best_area = -1.f;
+        for (size_t j = begin; j < end; ++j) {
+            const Vector2f &b = candidates[j];
+            float area = std::abs((a.x() - next_avg.x()) * (b.y() - a.y()) -
+                                  (a.x() - b.x()) * (next_avg.y() - a.y()));
+            if (area > best_area) {
+                best_area = area;
+                selected = j;
+            }
+        }
+        if (best_area >= 0.f)
+            out.push_back(candidates[selected]);
+    }
+
+    out.push_back(candidates[last]);
+}
+
+void TimeSeries::decimate(size_t columns, Decimation decimation,
+                          std::vector<Vector2f> &out) const {
+    uint64_t offset = first();
+    decimate_series(
+        size(), columns, decimation,
+        [&](size_t i) { return at(offset + i); },
+        [&](size_t begin, size_t end, float &min, float &max) {
+            min_max(offset + begin, offset + end, min, max);
+        },
+        out
+    );
+}
+
+SampleChannel::SampleChannel(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    m_samples.reset(new float[size]);
+    m_mask = size - 1;
+}
+
+size_t SampleChannel::push(const float *values, size_t count) {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    size_t capacity = m_mask + 1;
+
+    /* Only re-read the consumer position when the cached one suggests that
+       the queue is full, to avoid bouncing its cache line */
+    if (capacity - (size_t) (head - m_tail_cached) < count)
+        m_tail_cached = m_tail.load(std::memory_order_acquire);
+
+    size_t n = std::min(count, capacity - (size_t) (head - m_tail_cached)),
+           offset = (size_t) (head & m_mask),
+           n1 = std::min(n, capacity - offset);
+
+    memcpy(m_samples.get() + offset, values, n1 * sizeof(float));
+    memcpy(m_samples.get(), values + n1, (n - n1) * sizeof(float));
+    m_head.store(head + n, std::memory_order_release);
+
+    if (n < count)
+        m_dropped.store(m_dropped.load(std::memory_order_relaxed) + (count - n),
+                        std::memory_order_relaxed);
+
+    if (n > 0 && m_armed.load(std::memory_order_relaxed) &&
+        m_armed.exchange(false, std::memory_order_acq_rel)) {
+        Screen::redraw_async(m_screen.load(std::memory_order_relaxed));
+    }
+
+    return n;
+}
+
+size_t SampleChannel::pop(float *values, size_t count) {
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t capacity = m_mask + 1;
+
+    if ((size_t) (m_head_cached - tail) < count)
+        m_head_cached = m_head.load(std::memory_order_acquire);
+
+    size_t n = std::min(count, (size_t) (m_head_cached - tail)),
+           offset = (size_t) (tail & m_mask),
+           n1 = std::min(n, capacity - offset);
+
+    memcpy(values, m_samples.get() + offset, n1 * sizeof(float));
+    memcpy(values + n1, m_samples.get(), (n - n1) * sizeof(float));
+    m_tail.store(tail + n, std::memory_order_release);
+
+    return n;
+}
+
 Graph::Graph(Widget *parent, const std::string &caption)
     : Widget(parent), m_caption(caption) {
     m_background_color = Color(20, 128);
@@ -23,36 +287,242 @@ Graph::Graph(Widget *parent, const std::string &caption)
     m_text_color = Color(240, 192);
 }
 
+Graph::~Graph() {
+    if (m_channel)
+        m_channel->request_notification(nullptr);
+}
+
 Vector2i Graph::preferred_size(NVGcontext *) const {
     return Vector2i(180, 45);
 }
 
+void Graph::push_samples(const float *values, size_t count) {
+    if (m_stream.capacity() == 0)
+        throw std::runtime_error("Graph::push_samples(): call set_stream_capacity() first!");
+    m_stream.push(values, count);
+    m_stream_dirty = true;
+}
+
+void Graph::set_channel(SampleChannel *channel) {
+    if (channel && m_stream.capacity() == 0)
+        throw std::runtime_error("Graph::set_channel(): call set_stream_capacity() first!");
+    if (m_channel)
+        m_channel->request_notification(nullptr);
+    m_channel = channel;
+}
+
+void Graph::drain_channel() {
+    /* Re-arm first: samples pushed while draining then trigger another redraw */
+    m_channel->request_notification(screen());
+
+    float buffer[1024];
+    size_t count;
+    while ((count = m_channel->pop(buffer, 1024)) > 0) {
+        m_stream.push(buffer, count);
+        m_stream_dirty = true;
+    }
+}
+
+const std::vector<Vector2f> &Graph::plot_points(size_t columns) {
+    if (m_stream.capacity() > 0) {
+        if (m_stream_dirty || columns != m_points_columns) {
+            m_stream.decimate(columns, m_decimation, m_points);
+            m_points_columns = columns;
+            m_stream_dirty = false;
+        }
+    } else {
+        /* The array may have been modified through values(), so no caching */
+        const std::vector<float> &values = m_values;
+        decimate_series(
+            values.size(), columns, m_decimation,
+            [&](size_t i) { return values[i]; },
+            [&](size_t begin, size_t end, float &min, float &max) {
+                auto result = std::minmax_element(values.begin() + begin,
+                                                  values.begin() + end);
+                min = *result.first;
+                max = *result.second;
+            },
+            m_points
+        );
+    }
+    return m_points;
+}
+
+size_t Graph::add_series(const float *data, size_t size, ptrdiff_t stride,
+                         const Color &stroke_color, const Color &fill_color) {
+    m_series.push_back(Series { data, size, stride, stroke_color, fill_color, true });
+    return m_series.size() - 1;
+}
+
+void Graph::set_series_data(size_t index, const float *data, size_t size,
+                            ptrdiff_t stride) {
+    Series &series = m_series.at(index);
+    series.data = data;
+    series.size = size;
+    series.stride = stride;
+}
+
+void Graph::draw_polyline(NVGcontext *ctx, const std::vector<Vector2f> &points, float x0,
+                          const Color &stroke_color, const Color &fill_color) {
+    float width = (1.f - x0) * m_size.x(),
+          left = m_pos.x() + x0 * m_size.x();
+
+    nvgBeginPath(ctx);
+    nvgMoveTo(ctx, left, m_pos.y() + m_size.y());
+    for (const Vector2f &p : points)
+        nvgLineTo(ctx, left + p.x() * width, m_pos.y() + (1 - p.y()) * m_size.y());
+
+    nvgLineTo(ctx, m_pos.x() + m_size.x(), m_pos.y() + m_size.y());
+    nvgStrokeColor(ctx, stroke_color);
+    nvgStroke(ctx);
+    if (fill_color.w() > 0) {
+        nvgFillColor(ctx, fill_color);
+        nvgFill(ctx);
+    }
+}
+
+void Graph::draw_stream_gpu(NVGcontext *) {
+    Screen *scr = screen();
+    if (scr == nullptr)
+        throw std::runtime_error("Graph::draw(): could not find parent screen!");
+
+    size_t capacity = m_stream.capacity(),
+           count = m_stream.size();
+
+    if (!m_shader) {
+        m_render_pass = new RenderPass({ scr }, nullptr, nullptr, nullptr, false);
+        m_shader = new Shader(m_render_pass, "graph",
+                              NANOGUI_SHADER(graph_vertex),
+                              NANOGUI_SHADER(graph_fragment),
+                              Shader::BlendMode::AlphaBlend);
+    }
+
+    if (m_gpu_reset) {
+        /* One texel per ring slot, wrapped into rows of at most 1024 texels
+           to stay within the texture size limits */
+        size_t row = std::min<size_t>(capacity, 1024);
+        Vector2i size((int) row, (int) ((capacity + row - 1) / row));
+        if (!m_gpu_samples || m_gpu_samples->size() != size) {
+            m_gpu_samples = new Texture(Texture::PixelFormat::R,
+                                        Texture::ComponentFormat::Float32, size,
+                                        Texture::InterpolationMode::Nearest,
+                                        Texture::InterpolationMode::Nearest);
+            m_gpu_samples->set_owner("Graph");
+            m_gpu_samples->upload(nullptr);
+            m_shader->set_texture("samples", m_gpu_samples);
+        }
+        m_gpu_uploaded = 0;
+        m_gpu_reset = false;
+    }
+
+    /* Upload the samples that were pushed since the last frame, straight out
+       of the ring buffer (slot 'i % capacity' holds the sample 'i') */
+    size_t row = (size_t) m_gpu_samples->size().x();
+    uint64_t begin = std::max(m_gpu_uploaded, m_stream.first()),
+             end = m_stream.total();
+    while (begin < end) {
+        size_t slot = (size_t) (begin % capacity),
+               x = slot % row, y = slot / row,
+               n = (size_t) std::min<uint64_t>(end - begin, capacity - slot);
+        Vector2i region((int) std::min(n, row - x), 1);
+        if (x == 0 && n >= (size_t) row)
+            region = Vector2i((int) row, (int) (n / row));
+        m_gpu_samples->upload_sub_region((const uint8_t *) (m_stream.data() + slot),
+                                         Vector2i((int) x, (int) y), region);
+        begin += (uint64_t) region.x() * region.y();
+    }
+    m_gpu_uploaded = end;
+
+    float pixel_ratio = scr->pixel_ratio();
+    scr->nvg_flush();
+
+    Vector2i fbsize = Vector2i(Vector2f(m_size) * pixel_ratio),
+             offset = Vector2i(Vector2f(absolute_position()) * pixel_ratio);
+    m_render_pass->resize(scr->framebuffer_size());
+    m_render_pass->set_viewport(offset, fbsize);
+
+    /* One quad per pixel column covered by the retained samples */
+    float spacing = fbsize.x() / (float) (capacity - 1);
+    size_t columns = std::min((size_t) std::max(fbsize.x(), 0),
+                              (size_t) std::ceil((count - 1) * spacing));
+
+    m_shader->set_uniform("size", Vector2f(fbsize));
+    m_shader->set_uniform("spacing", spacing);
+    m_shader->set_uniform("head", (int32_t) ((m_stream.total() - 1) % capacity));
+    m_shader->set_uniform("slots", (int32_t) capacity);
+    m_shader->set_uniform("count", (int32_t) count);
+    m_shader->set_uniform("row", (int32_t) row);
+    m_shader->set_uniform("stroke_width", pixel_ratio);
+
+    auto draw_columns = [&](float fill, const Color &color) {
+        m_shader->set_uniform("fill", fill);
+        m_shader->set_uniform("color", color);
+        m_shader->begin();
+        m_shader->draw_array(Shader::PrimitiveType::Triangle, 0, columns * 6);
+        m_shader->end();
+    };
+
+    m_render_pass->begin();
+    if (m_fill_color.w() > 0)
+        draw_columns(1.f, m_fill_color);
+    draw_columns(0.f, m_stroke_color);
+    m_render_pass->end();
+}
+
 void Graph::draw(NVGcontext *ctx) {
     Widget::draw(ctx);
 
+    if (m_channel && m_stream.capacity() > 0)
+        drain_channel();
+
     nvgBeginPath(ctx);
     nvgRect(ctx, m_pos.x(), m_pos.y(), m_size.x(), m_size.y());
     nvgFillColor(ctx, m_background_color);
     nvgFill(ctx);
 
-    if (m_values.size() < 2)
+    /* In streaming mode, the newest sample is always at the right edge and
+       the horizontal scale is fixed by the capacity of the ring buffer */
+    size_t count = m_stream.capacity() > 0 ? m_stream.size() : m_values.size();
+    if (count < 2 && m_series.empty())
         return;
 
-    nvgBeginPath(ctx);
-    nvgMoveTo(ctx, m_pos.x(), m_pos.y()+m_size.y());
-    for (size_t i = 0; i < (size_t) m_values.size(); i++) {
-        float value = m_values[i];
-        float vx = m_pos.x() + i * m_size.x() / (float) (m_values.size() - 1);
-        float vy = m_pos.y() + (1-value) * m_size.y();
-        nvgLineTo(ctx, vx, vy);
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    /* The shader needs gl_VertexID and vertex texture fetches */
+    bool gpu_rendering = false;
+#else
+    bool gpu_rendering = m_gpu_rendering && m_stream.capacity() > 1;
+#endif
+
+    if (count >= 2 && gpu_rendering) {
+        draw_stream_gpu(ctx);
+    } else if (count >= 2) {
+        float x0 = 0.f;
+        if (m_stream.capacity() > 1)
+            x0 = 1.f - (count - 1) / (float) (m_stream.capacity() - 1);
+
+        size_t columns = (size_t) std::max(1.f, std::ceil((1.f - x0) * m_size.x()));
+        draw_polyline(ctx, plot_points(columns), x0, m_stroke_color, m_fill_color);
     }
 
-    nvgLineTo(ctx, m_pos.x() + m_size.x(), m_pos.y() + m_size.y());
-    nvgStrokeColor(ctx, m_stroke_color);
-    nvgStroke(ctx);
-    if (m_fill_color.w() > 0) {
-        nvgFillColor(ctx, m_fill_color);
-        nvgFill(ctx);
+    for (const Series &series : m_series) {
+        if (!series.visible || series.size < 2)
+            continue;
+        const float *data = series.data;
+        ptrdiff_t stride = series.stride;
+        decimate_series(
+            series.size, (size_t) std::max(m_size.x(), 1), m_decimation,
+            [&](size_t i) { return data[(ptrdiff_t) i * stride]; },
+            [&](size_t begin, size_t end, float &min, float &max) {
+                min = max = data[(ptrdiff_t) begin * stride];
+                for (size_t i = begin + 1; i < end; ++i) {
+                    float value = data[(ptrdiff_t) i * stride];
+                    min = std::min(min, value);
+                    max = std::max(max, value);
+                }
+            },
+            m_series_points
+        );
+        draw_polyline(ctx, m_series_points, 0.f, series.stroke_color, series.fill_color);
     }
 
     nvgFontFace(ctx, "sans");
@@ -0,0 +1,187 @@
+/*
+    src/histogram.cpp -- Histogram widget that bins large arrays of
+    samples directly
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/histogram.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+/// Minimum number of samples that are worth handing to another thread
+static const size_t HISTOGRAM_MIN_CHUNK = 1 << 18;
+
+/**
+ * Accumulate samples into 'counts', which has 'bins + 1' entries (the last one
+ * counts the outliers). Bin indices are first computed for a block of samples
+ * in a branch-free loop that the compiler can vectorize, followed by a
+ * separate loop that performs the (inherently scalar) increments.
+ */
+static void histogram_bin(const float *data, size_t size, float offset,
+                          float scale, uint32_t bins, uint64_t *counts) {
+    const size_t block_size = 256;
+    uint32_t index[block_size];
+    float bins_f = (float) bins;
+
+    for (size_t i = 0; i < size; i += block_size) {
+        size_t n = std::min(block_size, size - i);
+        const float *block = data + i;
+
+        for (size_t j = 0; j < n; ++j) {
+            float t = (block[j] - offset) * scale;
+            bool valid = t >= 0.f && t <= bins_f; // false for NaNs
+            uint32_t k = (uint32_t) (valid ? t : 0.f);
+            k = k < bins - 1 ? k : bins - 1;     // the maximum goes into the last bin
+            index[j] = valid ? k : bins;
+        }
+
+        for (size_t j = 0; j < n; ++j)
+            counts[index[j]]++;
+    }
+}
+
+Histogram::Histogram(Widget *parent, const std::string &caption)
+    : Widget(parent), m_caption(caption) {
+    m_background_color = Color(20, 128);
+    m_bar_color = Color(255, 192, 0, 128);
+    m_text_color = Color(240, 192);
+    m_counts.assign(m_bin_count, 0);
+}
+
+void Histogram::set_data(const float *data, size_t size) {
+    if (data != m_data || size < m_binned)
+        m_binned = 0;
+    m_data = data;
+    m_size_data = size;
+}
+
+void Histogram::set_bin_count(size_t bin_count) {
+    if (bin_count == 0 || bin_count >= (size_t) std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("Histogram::set_bin_count(): invalid number of bins!");
+    m_bin_count = bin_count;
+    m_binned = 0;
+}
+
+void Histogram::set_range(float min, float max) {
+    if (!(min < max))
+        throw std::runtime_error("Histogram::set_range(): invalid range!");
+    m_range_min = min;
+    m_range_max = max;
+    m_binned = 0;
+}
+
+void Histogram::update() {
+    if (m_binned == 0) {
+        m_counts.assign(m_bin_count, 0);
+        m_outliers = 0;
+    }
+
+    if (!m_data || m_binned >= m_size_data)
+        return;
+
+    const float *data = m_data + m_binned;
+    size_t size = m_size_data - m_binned;
+    float scale = m_bin_count / (m_range_max - m_range_min);
+    uint32_t bins = (uint32_t) m_bin_count;
+
+    size_t threads = m_thread_count;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, size / HISTOGRAM_MIN_CHUNK));
+
+    /* Every thread accumulates into a private histogram */
+    std::vector<uint64_t> partial(threads * (m_bin_count + 1), 0);
+    size_t chunk = (size + threads - 1) / threads;
+
+    auto work = [&](size_t i) {
+        size_t begin = std::min(i * chunk, size),
+               end = std::min(begin + chunk, size);
+        histogram_bin(data + begin, end - begin, m_range_min, scale, bins,
+                      partial.data() + i * (m_bin_count + 1));
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work, i);
+    work(0);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    /* Merge */
+    for (size_t i = 0; i < threads; ++i) {
+        const uint64_t *counts = partial.data() + i * (m_bin_count + 1);
+        for (size_t j = 0; j < m_bin_count; ++j)
+            m_counts[j] += counts[j];
+        m_outliers += counts[m_bin_count];
+    }
+
+    m_binned = m_size_data;
+}
+
+Vector2i Histogram::preferred_size(NVGcontext *) const {
+    return Vector2i(180, 45);
+}
+
+void Histogram::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    update();
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, m_pos.x(), m_pos.y(), m_size.x(), m_size.y());
+    nvgFillColor(ctx, m_background_color);
+    nvgFill(ctx);
+
+    uint64_t max_count = 0;
+    for (uint64_t count : m_counts)
+        max_count = std::max(max_count, count);
+
+    if (max_count > 0) {
+        /* When there are more bins than pixels, adjacent bins are merged into
+           one bar (showing the maximum), and all bars are drawn as one path */
+        size_t columns = std::min(m_bin_count, (size_t) std::max(m_size.x(), 1));
+        float width = m_size.x() / (float) columns,
+              height = m_size.y() / (float) max_count;
+
+        nvgBeginPath(ctx);
+        for (size_t i = 0; i < columns; ++i) {
+            size_t begin = i * m_bin_count / columns,
+                   end = (i + 1) * m_bin_count / columns;
+            uint64_t count = 0;
+            for (size_t j = begin; j < end; ++j)
+                count = std::max(count, m_counts[j]);
+            if (count == 0)
+                continue;
+            float h = count * height;
+            nvgRect(ctx, m_pos.x() + i * width, m_pos.y() + m_size.y() - h,
+                    width, h);
+        }
+        nvgFillColor(ctx, m_bar_color);
+        nvgFill(ctx);
+    }
+
+    if (!m_caption.empty()) {
+        nvgFontFace(ctx, "sans");
+        nvgFontSize(ctx, 14.0f);
+        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+        nvgFillColor(ctx, m_text_color);
+        nvgText(ctx, m_pos.x() + 3, m_pos.y() + 1, m_caption.c_str(), NULL);
+    }
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, m_pos.x(), m_pos.y(), m_size.x(), m_size.y());
+    nvgStrokeColor(ctx, Color(100, 255));
+    nvgStroke(ctx);
+}
+
+NAMESPACE_END(nanogui)
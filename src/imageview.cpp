@@ -13,9 +13,10 @@
 #include <nanogui/renderpass.h>
 #include <nanogui/shader.h>
 #include <nanogui/texture.h>
+#include <nanogui/tilecache.h>
 #include <nanogui/screen.h>
 #include <nanogui/opengl.h>
-#include <nanogui_resources.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -45,12 +46,53 @@ ImageView::ImageView(Widget *parent) : Canvas(parent, 1, false, false, false) {
     m_image_background_color = Color(0.f, 0.f, 0.f, 0.f);
 }
 
+ImageView::~ImageView() {
+    if (m_stream)
+        m_stream->request_notification(nullptr);
+    if (m_tile_cache)
+        m_tile_cache->request_notification(nullptr);
+}
+
+void ImageView::set_stream(TextureStream *stream) {
+    if (m_stream)
+        m_stream->request_notification(nullptr);
+    if (stream)
+        set_image(stream->texture());
+    m_stream = stream;
+}
+
 void ImageView::set_image(Texture *image) {
     if (image->mag_interpolation_mode() != Texture::InterpolationMode::Nearest)
         throw std::runtime_error(
             "ImageView::set_image(): interpolation mode must be set to 'Nearest'!");
     m_image_shader->set_texture("image", image);
     m_image = image;
+    if (m_tile_cache) {
+        m_tile_cache->request_notification(nullptr);
+        m_tile_cache = nullptr;
+    }
+    set_content_dirty();
+}
+
+void ImageView::set_tile_cache(TileCache *tile_cache) {
+    if (m_stream) {
+        m_stream->request_notification(nullptr);
+        m_stream = nullptr;
+    }
+    if (m_tile_cache)
+        m_tile_cache->request_notification(nullptr);
+    m_image = nullptr;
+    m_tile_cache = tile_cache;
+    set_content_dirty();
+}
+
+Vector2i ImageView::image_size() const {
+    if (m_image)
+        return m_image->size();
+    else if (m_tile_cache)
+        return m_tile_cache->source()->size();
+    else
+        return Vector2i(0);
 }
 
 float ImageView::scale() const {
@@ -59,12 +101,14 @@ float ImageView::scale() const {
 
 void ImageView::set_scale(float scale) {
     m_scale = std::log2(scale) * 5.f;
+    set_content_dirty();
 }
 
 void ImageView::center() {
-    if (!m_image)
+    if (!m_image && !m_tile_cache)
         return;
-    m_offset = Vector2i(.5f * (Vector2f(m_size) * screen()->pixel_ratio() - Vector2f(m_image->size()) * scale()));
+    m_offset = Vector2i(.5f * (Vector2f(m_size) * screen()->pixel_ratio() - Vector2f(image_size()) * scale()));
+    set_content_dirty();
 }
 
 void ImageView::reset() {
@@ -87,7 +131,7 @@ Vector2f ImageView::pixel_to_pos(const Vector2f &p) const {
 }
 
 bool ImageView::keyboard_event(int key, int /* scancode */, int action, int /* modifiers */) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tile_cache))
         return false;
 
     if (action == GLFW_PRESS) {
@@ -101,40 +145,57 @@ bool ImageView::keyboard_event(int key, int /* scancode */, int action, int /* m
 
 bool ImageView::mouse_drag_event(const Vector2i & /* p */, const Vector2i &rel,
                                  int /* button */, int /* modifiers */) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tile_cache))
         return false;
 
     m_offset += rel * screen()->pixel_ratio();
+    set_content_dirty();
 
     return true;
 }
 
 bool ImageView::scroll_event(const Vector2i &p, const Vector2f &rel) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tile_cache))
         return false;
 
     Vector2f p1 = pos_to_pixel(p - m_pos);
     m_scale += rel.y();
 
     // Restrict scaling to a reasonable range
+    Vector2i image_size = this->image_size();
     m_scale = std::max(
-        m_scale, std::min(0.f, std::log2(40.f / std::max(m_image->size().x(),
-                                                         m_image->size().y())) * 5.f));
+        m_scale, std::min(0.f, std::log2(40.f / std::max(image_size.x(),
+                                                         image_size.y())) * 5.f));
     m_scale = std::min(m_scale, 45.f);
 
     Vector2f p2 = pos_to_pixel(p - m_pos);
     m_offset += (p2 - p1) * scale();
+    set_content_dirty();
     return true;
 }
 
 void ImageView::draw(NVGcontext *ctx) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tile_cache))
         return;
 
+    /* Copy the newest streamed frame (if any) before the canvas is drawn */
+    if (m_stream) {
+        m_stream->request_notification(screen());
+        if (m_stream->update())
+            set_content_dirty();
+    }
+
+    /* Likewise, upload tiles that finished decoding since the last frame */
+    if (m_tile_cache) {
+        m_tile_cache->request_notification(screen());
+        if (m_tile_cache->update())
+            set_content_dirty();
+    }
+
     Canvas::draw(ctx);
 
     Vector2i top_left = Vector2i(pixel_to_pos(Vector2f(0.f, 0.f))),
-             size     = Vector2i(pixel_to_pos(Vector2f(m_image->size())) - Vector2f(top_left));
+             size     = Vector2i(pixel_to_pos(Vector2f(image_size())) - Vector2f(top_left));
 
     if (m_draw_image_border) {
         nvgBeginPath(ctx);
@@ -149,7 +210,7 @@ void ImageView::draw(NVGcontext *ctx) {
     nvgSave(ctx);
     nvgIntersectScissor(ctx, m_pos.x(), m_pos.y(), m_size.x(), m_size.y());
 
-    if (scale() > 100 && m_pixel_callback) {
+    if (!m_sdf_text && scale() > 100 && m_pixel_callback) {
         float font_size = scale() / 10.f;
         float alpha = std::min(1.f, (scale() - 100) / 100.f);
         nvgFontSize(ctx, font_size);
@@ -157,7 +218,7 @@ void ImageView::draw(NVGcontext *ctx) {
         nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 
         Vector2i start = max(Vector2i(0), Vector2i(pos_to_pixel(Vector2f(0.f, 0.f))) - 1),
-                 end   = min(Vector2i(pos_to_pixel(Vector2f(m_size))) + 1, m_image->size() - 1);
+                 end   = min(Vector2i(pos_to_pixel(Vector2f(m_size))) + 1, image_size() - 1);
 
         char text_buf[80],
             *text[4] = { text_buf, text_buf + 20, text_buf + 40, text_buf + 60 };
@@ -192,7 +253,7 @@ void ImageView::draw(NVGcontext *ctx) {
 }
 
 void ImageView::draw_contents() {
-    if (!m_image)
+    if (!m_image && !m_tile_cache)
         return;
 
     /* Ensure that 'offset' is a multiple of the pixel ratio */
@@ -200,7 +261,7 @@ void ImageView::draw_contents() {
     m_offset = (Vector2f(Vector2i(m_offset / pixel_ratio)) * pixel_ratio);
 
     Vector2f bound1 = Vector2f(m_size) * pixel_ratio,
-             bound2 = -Vector2f(m_image->size()) * scale();
+             bound2 = -Vector2f(image_size()) * scale();
 
     if ((m_offset.x() >= bound1.x()) != (m_offset.x() < bound2.x()))
         m_offset.x() = std::max(std::min(m_offset.x(), bound1.x()), bound2.x());
@@ -211,23 +272,183 @@ void ImageView::draw_contents() {
 
     float scale = std::pow(2.f, m_scale / 5.f);
 
-    Matrix4f matrix_background =
-        Matrix4f::scale(Vector3f(m_image->size().x() * scale / 20.f,
-                                 m_image->size().y() * scale / 20.f, 1.f));
+    Matrix4f projection =
+        Matrix4f::ortho(0.f, viewport_size.x(), viewport_size.y(), 0.f, -1.f, 1.f);
+
+    if (m_tile_cache) {
+        draw_tiles(projection, scale);
+    } else {
+        Matrix4f matrix_background =
+            Matrix4f::scale(Vector3f(m_image->size().x() * scale / 20.f,
+                                     m_image->size().y() * scale / 20.f, 1.f));
+
+        Matrix4f matrix_image =
+            projection *
+            Matrix4f::translate(Vector3f(m_offset.x(), (int) m_offset.y(), 0.f)) *
+            Matrix4f::scale(Vector3f(m_image->size().x() * scale,
+                                     m_image->size().y() * scale, 1.f));
+
+        m_image_shader->set_uniform("matrix_image",      Matrix4f(matrix_image));
+        m_image_shader->set_uniform("matrix_background", Matrix4f(matrix_background));
+        m_image_shader->set_uniform("background_color",  m_image_background_color);
+
+        m_image_shader->begin();
+        m_image_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
+        m_image_shader->end();
+    }
+
+    if (m_sdf_text && scale > 100 && m_pixel_callback) {
+        /* Same layout as the NanoVG code path in draw(), but in framebuffer pixels */
+        float font_size = scale / 10.f * pixel_ratio;
+        float alpha = std::min(1.f, (scale - 100) / 100.f);
+
+        if (!m_label_text)
+            m_label_text = new SDFText(render_pass());
+        m_label_text->clear();
+
+        Vector2i start = max(Vector2i(0), Vector2i(pos_to_pixel(Vector2f(0.f, 0.f))) - 1),
+                 end   = min(Vector2i(pos_to_pixel(Vector2f(m_size))) + 1, image_size() - 1);
+
+        char text_buf[80],
+            *text[4] = { text_buf, text_buf + 20, text_buf + 40, text_buf + 60 };
+
+        for (int y = start.y(); y <= end.y(); ++y) {
+            for (int x = start.x(); x <= end.x(); ++x) {
+                Vector2f pos = Vector2f(x + .5f, y + .5f) * scale + m_offset;
+
+                m_pixel_callback(Vector2i(x, y), text, 20);
+
+                for (int ch = 0; ch < 4; ++ch) {
+                    Vector2f text_pos(pos.x(), pos.y() + (ch - 1.5f) * font_size);
+                    Color col(0.3f, 0.3f, 0.3f, alpha);
+                    if (ch == 3)
+                        col[0] = col[1] = col[2] = 1.f;
+                    else
+                        col[ch] = 1.f;
+
+                    m_label_text->add(text[ch], text_pos, font_size, Color(0.f, 0.f, 0.f, alpha),
+                                      NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE, 2.f * pixel_ratio);
+                    m_label_text->add(text[ch], text_pos, font_size, col,
+                                      NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
+                }
+            }
+        }
+
+        m_label_text->draw(projection);
+    }
+}
+
+void ImageView::draw_tiles(const Matrix4f &projection, float scale) {
+    TileSource *source = m_tile_cache->source();
+    uint32_t level_count = source->level_count(),
+             tile_size   = source->tile_size();
+    Vector2i viewport_size = render_pass()->viewport().second;
+
+    /* Finest level whose resolution does not exceed that of the screen */
+    int level = (int) std::floor(std::log2(1.f / scale));
+    level = std::max(0, std::min(level, (int) level_count - 1));
+
+    /* Visible range of tiles (in level 0 pixels, upper bound exclusive) */
+    float tile_pixels = (float) (tile_size << level);
+    Vector2f p0 = -m_offset / scale,
+             p1 = (Vector2f(viewport_size) - m_offset) / scale;
+    Vector2i count = source->tile_count((uint32_t) level),
+             i0 = max(Vector2i(p0 / tile_pixels), Vector2i(0)),
+             i1 = min(Vector2i((int) std::ceil(p1.x() / tile_pixels),
+                               (int) std::ceil(p1.y() / tile_pixels)), count);
+
+    struct TileRef {
+        uint32_t level;
+        Vector2i index;
+        Texture *texture;
+    };
 
-    Matrix4f matrix_image =
-        Matrix4f::ortho(0.f, viewport_size.x(), viewport_size.y(), 0.f, -1.f, 1.f) *
-        Matrix4f::translate(Vector3f(m_offset.x(), (int) m_offset.y(), 0.f)) *
-        Matrix4f::scale(Vector3f(m_image->size().x() * scale,
-                                 m_image->size().y() * scale, 1.f));
+    std::vector<TileRef> visible;
+    for (int y = i0.y(); y < i1.y(); ++y)
+        for (int x = i0.x(); x < i1.x(); ++x)
+            visible.push_back(TileRef{ (uint32_t) level, Vector2i(x, y), nullptr });
+
+    /* Decode tiles close to the center of the view first */
+    Vector2f center = .5f * (p0 + p1) / tile_pixels - .5f;
+    std::sort(visible.begin(), visible.end(), [&](const TileRef &a, const TileRef &b) {
+        return squared_norm(Vector2f(a.index) - center) <
+               squared_norm(Vector2f(b.index) - center);
+    });
+
+    /* The coarsest level serves as a fallback everywhere, hence it is
+       requested first and always marked as used */
+    m_tile_cache->clear_requests();
+    Texture *coarsest = m_tile_cache->tile(level_count - 1, Vector2i(0));
+    if (!coarsest)
+        m_tile_cache->request(level_count - 1, Vector2i(0));
+
+    std::vector<TileRef> fallback;
+    for (TileRef &tile : visible) {
+        tile.texture = m_tile_cache->tile(tile.level, tile.index);
+        if (tile.texture)
+            continue;
+        m_tile_cache->request(tile.level, tile.index);
+
+        /* Substitute the closest coarser tile that is resident */
+        for (uint32_t l = tile.level + 1; l < level_count; ++l) {
+            Vector2i index(tile.index.x() >> (l - tile.level),
+                           tile.index.y() >> (l - tile.level));
+            Texture *texture = m_tile_cache->tile(l, index);
+            if (!texture)
+                continue;
+            bool found = false;
+            for (const TileRef &f : fallback)
+                found |= f.level == l && f.index == index;
+            if (!found)
+                fallback.push_back(TileRef{ l, index, texture });
+            break;
+        }
+    }
 
-    m_image_shader->set_uniform("matrix_image",      Matrix4f(matrix_image));
-    m_image_shader->set_uniform("matrix_background", Matrix4f(matrix_background));
-    m_image_shader->set_uniform("background_color",  m_image_background_color);
+    /* Coarse tiles are drawn first and then covered by finer ones */
+    std::sort(fallback.begin(), fallback.end(), [](const TileRef &a, const TileRef &b) {
+        return a.level > b.level;
+    });
+
+    m_image_shader->set_uniform("background_color", m_image_background_color);
+
+    /* Resolve the per-tile parameters once */
+    Shader::BindingHandle image_binding             = m_image_shader->binding("image"),
+                          matrix_image_binding      = m_image_shader->binding("matrix_image"),
+                          matrix_background_binding = m_image_shader->binding("matrix_background");
+
+    auto draw_tile = [&](const TileRef &tile) {
+        Vector2f origin = Vector2f(tile.index * (int) (tile_size << tile.level)),
+                 extent = min(Vector2f(tile.texture->size() * (1 << tile.level)),
+                              Vector2f(source->size()) - origin);
+
+        Matrix4f matrix_background =
+            Matrix4f::translate(Vector3f(origin.x() * scale / 20.f,
+                                         origin.y() * scale / 20.f, 0.f)) *
+            Matrix4f::scale(Vector3f(extent.x() * scale / 20.f,
+                                     extent.y() * scale / 20.f, 1.f));
+
+        Matrix4f matrix_image =
+            projection *
+            Matrix4f::translate(Vector3f(m_offset.x() + origin.x() * scale,
+                                         (int) m_offset.y() + origin.y() * scale, 0.f)) *
+            Matrix4f::scale(Vector3f(extent.x() * scale, extent.y() * scale, 1.f));
+
+        m_image_shader->set_texture(image_binding, tile.texture);
+        m_image_shader->set_uniform(matrix_image_binding,      matrix_image);
+        m_image_shader->set_uniform(matrix_background_binding, matrix_background);
+
+        m_image_shader->begin();
+        m_image_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
+        m_image_shader->end();
+    };
 
-    m_image_shader->begin();
-    m_image_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
-    m_image_shader->end();
+    for (const TileRef &tile : fallback)
+        draw_tile(tile);
+    for (const TileRef &tile : visible) {
+        if (tile.texture)
+            draw_tile(tile);
+    }
 }
 
 NAMESPACE_END(nanogui)
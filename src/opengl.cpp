@@ -1,4 +1,7 @@
 #include <nanogui/opengl.h>
+#include "opengl_check.h"
+#include "opengl_extensions.h"
+#include <cstring>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -56,4 +59,38 @@ bool nanogui_check_glerror(const char *cmd) {
     return true;
 }
 
+bool gl_has_extension(const char *name) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    const char *extensions = (const char *) glGetString(GL_EXTENSIONS);
+    size_t length = strlen(name);
+    for (const char *p = extensions; p && (p = strstr(p, name)) != nullptr; p += length) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+            return true;
+    }
+    return false;
+#else
+    GLint count = 0;
+    CHK(glGetIntegerv(GL_NUM_EXTENSIONS, &count));
+    for (GLint i = 0; i < count; ++i) {
+        const char *extension = (const char *) glGetStringi(GL_EXTENSIONS, (GLuint) i);
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+#endif
+}
+
+bool gl_supports(int version, const char *extension) {
+#if defined(NANOGUI_USE_OPENGL)
+    GLint major = 0, minor = 0;
+    CHK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+    CHK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+    if (major * 10 + minor >= version)
+        return true;
+#else
+    (void) version;
+#endif
+    return gl_has_extension(extension);
+}
+
 NAMESPACE_END(nanogui)
@@ -0,0 +1,14 @@
+#pragma once
+
+NAMESPACE_BEGIN(nanogui)
+
+/// Does the current context provide the given extension?
+extern bool gl_has_extension(const char *name);
+
+/**
+ * Does the current context provide the given OpenGL version (e.g. 44) or
+ * extension? On GLES, only the extension is checked.
+ */
+extern bool gl_supports(int version, const char *extension);
+
+NAMESPACE_END(nanogui)
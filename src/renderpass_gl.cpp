@@ -1,4 +1,5 @@
 #include <nanogui/renderpass.h>
+#include <nanogui/glstate.h>
 #include <nanogui/screen.h>
 #include <nanogui/opengl.h>
 #include <nanogui/texture.h>
@@ -31,8 +32,9 @@ RenderPass::RenderPass(std::vector<Object *> color_targets,
         m_depth_test = DepthTest::Always;
     }
 
+    GLState &state = GLState::current();
     CHK(glGenFramebuffers(1, &m_framebuffer_handle));
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_handle));
+    state.bind_framebuffer(GL_FRAMEBUFFER, m_framebuffer_handle);
 
 #if defined(NANOGUI_USE_OPENGL)
     std::vector<GLenum> draw_buffers;
@@ -78,6 +80,7 @@ RenderPass::RenderPass(std::vector<Object *> color_targets,
     m_viewport_size = m_framebuffer_size;
 
     if (has_screen && !has_texture) {
+        state.framebuffer_deleted(m_framebuffer_handle);
         CHK(glDeleteFramebuffers(1, &m_framebuffer_handle));
         m_framebuffer_handle = 0;
     } else {
@@ -133,10 +136,12 @@ RenderPass::RenderPass(std::vector<Object *> color_targets,
         }
     }
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    state.bind_framebuffer(GL_FRAMEBUFFER, 0);
 }
 
 RenderPass::~RenderPass() {
+    if (m_framebuffer_handle)
+        GLState::current().framebuffer_deleted(m_framebuffer_handle);
     CHK(glDeleteFramebuffers(1, &m_framebuffer_handle));
 }
 
@@ -147,21 +152,21 @@ void RenderPass::begin() {
 #endif
     m_active = true;
 
-    CHK(glGetIntegerv(GL_VIEWPORT, m_viewport_backup));
-    CHK(glGetIntegerv(GL_SCISSOR_BOX, m_scissor_backup));
-    GLboolean depth_write;
-    CHK(glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_write));
-    m_depth_write_backup = depth_write;
+    /* Back up the tracked state instead of querying it from the driver */
+    GLState &state = GLState::current();
+    m_state_backup = state.state();
 
-    m_depth_test_backup = glIsEnabled(GL_DEPTH_TEST);
-    m_scissor_test_backup = glIsEnabled(GL_SCISSOR_TEST);
-    m_cull_face_backup = glIsEnabled(GL_CULL_FACE);
-    m_blend_backup = glIsEnabled(GL_BLEND);
+    if (m_gpu_timer)
+        m_gpu_timer->begin();
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_handle));
+    state.bind_framebuffer(GL_FRAMEBUFFER, m_framebuffer_handle);
     set_viewport(m_viewport_offset, m_viewport_size);
 
     if (m_clear) {
+        /* The depth clear is subject to the depth write mask */
+        if (m_targets[0])
+            state.set_depth_mask(true);
+
 #if defined(NANOGUI_USE_OPENGL)
         for (size_t i = 0; i < m_targets.size(); ++i) {
             if (i == 0 && m_targets[0]) {
@@ -196,9 +201,7 @@ void RenderPass::begin() {
 
     set_depth_test(m_depth_test, m_depth_write);
     set_cull_mode(m_cull_mode);
-
-    if (m_blend_backup)
-        CHK(glDisable(GL_BLEND));
+    state.set_blend(false);
 }
 
 void RenderPass::end() {
@@ -207,36 +210,16 @@ void RenderPass::end() {
         throw std::runtime_error("RenderPass::end(): render pass is not active!");
 #endif
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    GLState &state = GLState::current();
+    state.bind_framebuffer(GL_FRAMEBUFFER, 0);
     if (m_blit_target)
         blit_to(Vector2i(0, 0), m_framebuffer_size, m_blit_target, Vector2i(0, 0));
 
-    CHK(glViewport(m_viewport_backup[0], m_viewport_backup[1],
-                   m_viewport_backup[2], m_viewport_backup[3]));
-    CHK(glScissor(m_scissor_backup[0], m_scissor_backup[1],
-                  m_scissor_backup[2], m_scissor_backup[3]));
-
-    if (m_depth_test_backup)
-        CHK(glEnable(GL_DEPTH_TEST));
-    else
-        CHK(glDisable(GL_DEPTH_TEST));
-
-    CHK(glDepthMask(m_depth_write_backup));
+    if (m_gpu_timer)
+        m_gpu_timer->end();
 
-    if (m_scissor_test_backup)
-        CHK(glEnable(GL_SCISSOR_TEST));
-    else
-        CHK(glDisable(GL_SCISSOR_TEST));
-
-    if (m_cull_face_backup)
-        CHK(glEnable(GL_CULL_FACE));
-    else
-        CHK(glDisable(GL_CULL_FACE));
-
-    if (m_blend_backup)
-        CHK(glEnable(GL_BLEND));
-    else
-        CHK(glDisable(GL_BLEND));
+    /* Fields that were unknown when the pass began are left as they are */
+    state.restore(m_state_backup);
 
     m_active = false;
 }
@@ -269,17 +252,14 @@ void RenderPass::set_viewport(const Vector2i &offset, const Vector2i &size) {
     m_viewport_size = size;
 
     if (m_active) {
+        GLState &state = GLState::current();
         int ypos = m_framebuffer_size.y() - m_viewport_size.y() - m_viewport_offset.y();
-        CHK(glViewport(m_viewport_offset.x(), ypos,
-                       m_viewport_size.x(), m_viewport_size.y()));
-        CHK(glScissor(m_viewport_offset.x(), ypos,
-                      m_viewport_size.x(), m_viewport_size.y()));
-
-        if (m_viewport_offset == Vector2i(0, 0) &&
-            m_viewport_size == m_framebuffer_size)
-            CHK(glDisable(GL_SCISSOR_TEST));
-        else
-            CHK(glEnable(GL_SCISSOR_TEST));
+        Vector4i rect(m_viewport_offset.x(), ypos,
+                      m_viewport_size.x(), m_viewport_size.y());
+        state.set_viewport(rect);
+        state.set_scissor(rect);
+        state.set_scissor_test(!(m_viewport_offset == Vector2i(0, 0) &&
+                                 m_viewport_size == m_framebuffer_size));
     }
 }
 
@@ -288,6 +268,7 @@ void RenderPass::set_depth_test(DepthTest depth_test, bool depth_write) {
     m_depth_write = depth_write;
 
     if (m_active) {
+        GLState &state = GLState::current();
         if (m_targets[0] && depth_test != DepthTest::Always) {
             GLenum func;
             switch (depth_test) {
@@ -301,12 +282,12 @@ void RenderPass::set_depth_test(DepthTest depth_test, bool depth_write) {
                 default:
                     throw std::runtime_error("Shader::set_depth_test(): invalid depth test mode!");
             }
-            CHK(glEnable(GL_DEPTH_TEST));
-            CHK(glDepthFunc(func));
+            state.set_depth_test(true);
+            state.set_depth_func(func);
         } else {
-            CHK(glDisable(GL_DEPTH_TEST));
+            state.set_depth_test(false);
         }
-        CHK(glDepthMask(depth_write ? GL_TRUE : GL_FALSE));
+        state.set_depth_mask(depth_write);
     }
 }
 
@@ -314,14 +295,15 @@ void RenderPass::set_cull_mode(CullMode cull_mode) {
     m_cull_mode = cull_mode;
 
     if (m_active) {
+        GLState &state = GLState::current();
         if (cull_mode == CullMode::Disabled) {
-            CHK(glDisable(GL_CULL_FACE));
+            state.set_cull_face(false);
         } else {
-            CHK(glEnable(GL_CULL_FACE));
+            state.set_cull_face(true);
             if (cull_mode == CullMode::Front)
-                CHK(glCullFace(GL_FRONT));
+                state.set_cull_face_mode(GL_FRONT);
             else if (cull_mode == CullMode::Back)
-                CHK(glCullFace(GL_BACK));
+                state.set_cull_face_mode(GL_BACK);
             else
                 throw std::runtime_error("Shader::set_cull_mode(): invalid cull mode!");
         }
@@ -365,8 +347,9 @@ void RenderPass::blit_to(const Vector2i &src_offset,
         what = GL_COLOR_BUFFER_BIT;
     #endif
 
-    CHK(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer_handle));
-    CHK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target_id));
+    GLState &state = GLState::current();
+    state.bind_framebuffer(GL_READ_FRAMEBUFFER, m_framebuffer_handle);
+    state.bind_framebuffer(GL_DRAW_FRAMEBUFFER, target_id);
 
     if (target_id == 0) {
         #if defined(NANOGUI_USE_OPENGL)
@@ -386,7 +369,7 @@ void RenderPass::blit_to(const Vector2i &src_offset,
                           (GLsizei) dst_end.x(), (GLsizei) dst_end.y(),
                           what, GL_NEAREST));
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    state.bind_framebuffer(GL_FRAMEBUFFER, 0);
 #endif
 }
 
@@ -234,6 +234,16 @@ void RenderPass::end() {
     id<MTLRenderCommandEncoder> command_encoder =
         (__bridge_transfer id<MTLRenderCommandEncoder>) m_command_encoder;
     [command_encoder endEncoding];
+    if (m_gpu_timer) {
+        /* Each render pass has its own command buffer, which is timed */
+        GPUTimer *timer = m_gpu_timer.get();
+        timer->inc_ref();
+        [command_buffer addCompletedHandler: ^(id<MTLCommandBuffer> buffer) {
+            if (buffer.status == MTLCommandBufferStatusCompleted)
+                timer->add_sample((buffer.GPUEndTime - buffer.GPUStartTime) * 1000.0);
+            timer->dec_ref();
+        }];
+    }
     [command_buffer commit];
     m_command_encoder = nullptr;
     m_command_buffer = nullptr;
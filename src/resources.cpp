@@ -0,0 +1,307 @@
+/*
+    src/resources.cpp -- Lookup and lazy decompression of embedded resources
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/resources.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <cstring>
+
+/* Resource table, generated by resources/bundle.cmake (sorted by name) */
+extern const uint32_t nanogui_resource_count;
+extern const char *const nanogui_resource_name[];
+extern const uint8_t *const nanogui_resource_data[];
+extern const uint32_t nanogui_resource_size[];
+extern const bool nanogui_resource_compressed[];
+
+NAMESPACE_BEGIN(nanogui)
+
+/* ======================================================================
+   Minimal DEFLATE decoder (RFC 1951) with a gzip wrapper (RFC 1952).
+   The input is generated at build time, so this favors compactness over
+   throughput and does not verify the CRC32 checksum.
+   ====================================================================== */
+
+struct Inflater {
+    const uint8_t *in;
+    size_t in_size;
+    size_t in_pos = 0;
+    uint32_t bit_buf = 0;
+    uint32_t bit_count = 0;
+    std::string out;
+
+    struct Huffman {
+        uint16_t count[16];
+        uint16_t symbol[288];
+    };
+
+    Inflater(const uint8_t *in, size_t in_size) : in(in), in_size(in_size) { }
+
+    [[noreturn]] static void fail() {
+        throw std::runtime_error("nanogui::resource(): corrupt compressed resource!");
+    }
+
+    uint32_t bits(uint32_t n) {
+        uint32_t value = bit_buf;
+        while (bit_count < n) {
+            if (in_pos == in_size)
+                fail();
+            value |= (uint32_t) in[in_pos++] << bit_count;
+            bit_count += 8;
+        }
+        bit_buf = value >> n;
+        bit_count -= n;
+        return value & ((1u << n) - 1);
+    }
+
+    void build(Huffman &h, const uint8_t *lengths, uint32_t n) {
+        uint16_t offset[16];
+        memset(h.count, 0, sizeof(h.count));
+        for (uint32_t i = 0; i < n; ++i)
+            h.count[lengths[i]]++;
+
+        int left = 1;
+        for (uint32_t len = 1; len < 16; ++len) {
+            left = (left << 1) - h.count[len];
+            if (left < 0) // over-subscribed
+                fail();
+        }
+
+        offset[1] = 0;
+        for (uint32_t len = 1; len < 15; ++len)
+            offset[len + 1] = offset[len] + h.count[len];
+        for (uint32_t i = 0; i < n; ++i) {
+            if (lengths[i] != 0)
+                h.symbol[offset[lengths[i]]++] = (uint16_t) i;
+        }
+    }
+
+    uint32_t decode(const Huffman &h) {
+        int code = 0, first = 0, index = 0;
+        for (uint32_t len = 1; len < 16; ++len) {
+            code |= (int) bits(1);
+            int count = h.count[len];
+            if (code - count < first)
+                return h.symbol[index + (code - first)];
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        fail();
+    }
+
+    void stored() {
+        bit_buf = bit_count = 0;
+        if (in_pos + 4 > in_size)
+            fail();
+        uint32_t len  = in[in_pos] | (in[in_pos + 1] << 8),
+                 nlen = in[in_pos + 2] | (in[in_pos + 3] << 8);
+        in_pos += 4;
+        if (len != (~nlen & 0xFFFF) || in_pos + len > in_size)
+            fail();
+        out.append((const char *) in + in_pos, len);
+        in_pos += len;
+    }
+
+    void codes(const Huffman &lencode, const Huffman &distcode) {
+        static const uint16_t len_base[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const uint8_t len_extra[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const uint16_t dist_base[30] = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+            8193, 12289, 16385, 24577 };
+        static const uint8_t dist_extra[30] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        while (true) {
+            uint32_t symbol = decode(lencode);
+            if (symbol < 256) {
+                out.push_back((char) symbol);
+            } else if (symbol == 256) {
+                return;
+            } else {
+                symbol -= 257;
+                if (symbol >= 29)
+                    fail();
+                size_t len = len_base[symbol] + bits(len_extra[symbol]);
+                symbol = decode(distcode);
+                if (symbol >= 30)
+                    fail();
+                size_t dist = dist_base[symbol] + bits(dist_extra[symbol]);
+                if (dist > out.size())
+                    fail();
+                size_t start = out.size() - dist;
+                for (size_t i = 0; i < len; ++i) // may overlap, copy bytewise
+                    out.push_back(out[start + i]);
+            }
+        }
+    }
+
+    void fixed() {
+        static Huffman lencode, distcode;
+        static std::once_flag once;
+        std::call_once(once, [this] {
+            uint8_t lengths[288];
+            uint32_t i = 0;
+            for (; i < 144; ++i) lengths[i] = 8;
+            for (; i < 256; ++i) lengths[i] = 9;
+            for (; i < 280; ++i) lengths[i] = 7;
+            for (; i < 288; ++i) lengths[i] = 8;
+            build(lencode, lengths, 288);
+            for (i = 0; i < 30; ++i) lengths[i] = 5;
+            build(distcode, lengths, 30);
+        });
+        codes(lencode, distcode);
+    }
+
+    void dynamic() {
+        static const uint8_t order[19] = { 16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                           11, 4,  12, 3, 13, 2, 14, 1, 15 };
+        uint8_t lengths[320];
+        Huffman lencode, distcode;
+
+        uint32_t nlen  = bits(5) + 257,
+                 ndist = bits(5) + 1,
+                 ncode = bits(4) + 4;
+        if (nlen > 286 || ndist > 30)
+            fail();
+
+        memset(lengths, 0, 19);
+        for (uint32_t i = 0; i < ncode; ++i)
+            lengths[order[i]] = (uint8_t) bits(3);
+        build(lencode, lengths, 19);
+
+        uint32_t index = 0;
+        while (index < nlen + ndist) {
+            uint32_t symbol = decode(lencode), len = 0, repeat;
+            if (symbol < 16) {
+                lengths[index++] = (uint8_t) symbol;
+                continue;
+            } else if (symbol == 16) {
+                if (index == 0)
+                    fail();
+                len = lengths[index - 1];
+                repeat = 3 + bits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + bits(3);
+            } else {
+                repeat = 11 + bits(7);
+            }
+            if (index + repeat > nlen + ndist)
+                fail();
+            while (repeat--)
+                lengths[index++] = (uint8_t) len;
+        }
+
+        if (lengths[256] == 0)
+            fail();
+
+        build(lencode, lengths, nlen);
+        build(distcode, lengths + nlen, ndist);
+        codes(lencode, distcode);
+    }
+
+    void inflate() {
+        uint32_t last;
+        do {
+            last = bits(1);
+            switch (bits(2)) {
+                case 0: stored(); break;
+                case 1: fixed(); break;
+                case 2: dynamic(); break;
+                default: fail();
+            }
+        } while (!last);
+    }
+
+    void gunzip() {
+        if (in_size < 18 || in[0] != 0x1f || in[1] != 0x8b || in[2] != 8)
+            fail();
+        uint8_t flags = in[3];
+        in_pos = 10;
+        if (flags & 4) { // FEXTRA
+            if (in_pos + 2 > in_size)
+                fail();
+            in_pos += 2 + (in[in_pos] | (in[in_pos + 1] << 8));
+        }
+        for (uint8_t flag : { (uint8_t) 8, (uint8_t) 16 }) { // FNAME, FCOMMENT
+            if (flags & flag) {
+                while (in_pos < in_size && in[in_pos] != 0)
+                    in_pos++;
+                in_pos++;
+            }
+        }
+        if (flags & 2) // FHCRC
+            in_pos += 2;
+        if (in_pos > in_size - 8)
+            fail();
+
+        const uint8_t *trailer = in + in_size - 4;
+        uint32_t size = trailer[0] | (trailer[1] << 8) |
+                        (trailer[2] << 16) | ((uint32_t) trailer[3] << 24);
+        out.reserve(size + 1);
+        in_size -= 8;
+        inflate();
+        if (out.size() != size)
+            fail();
+    }
+};
+
+/* Inflated copies of compressed resources, indexed like the resource table */
+static std::mutex resource_mutex;
+static std::unique_ptr<std::unique_ptr<std::string>[]> resource_cache;
+
+std::string_view resource(std::string_view name) {
+    const char *const *begin = nanogui_resource_name,
+                      *const *end = begin + nanogui_resource_count;
+
+    const char *const *it = std::lower_bound(
+        begin, end, name,
+        [](const char *a, std::string_view b) { return a < b; });
+
+    if (it == end || name != *it)
+        throw std::runtime_error("nanogui::resource(): no resource named \"" +
+                                 std::string(name) + "\"!");
+
+    size_t index = (size_t) (it - begin);
+    const uint8_t *data = nanogui_resource_data[index];
+    uint32_t size = nanogui_resource_size[index];
+
+    if (!nanogui_resource_compressed[index])
+        return std::string_view((const char *) data, size);
+
+    std::lock_guard<std::mutex> guard(resource_mutex);
+    if (!resource_cache)
+        resource_cache.reset(new std::unique_ptr<std::string>[nanogui_resource_count]);
+
+    std::unique_ptr<std::string> &entry = resource_cache[index];
+    if (!entry) {
+        Inflater inflater(data, size);
+        inflater.gunzip();
+        entry.reset(new std::string(std::move(inflater.out)));
+    }
+
+    return *entry;
+}
+
+std::vector<std::string> resource_names() {
+    return std::vector<std::string>(nanogui_resource_name,
+                                    nanogui_resource_name + nanogui_resource_count);
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,279 @@
+/*
+    src/scatterplot.cpp -- Widget for interactively exploring large
+    two-dimensional point sets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/scatterplot.h>
+#include <nanogui/renderpass.h>
+#include <nanogui/screen.h>
+#include <nanogui/shader.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN(nanogui)
+
+ScatterPlot::ScatterPlot(Widget *parent)
+    : Canvas(parent, 1, false, false, true), m_point_color(1.f, 1.f) {
+    render_pass()->set_clear_color(0, Color(0.3f, 0.3f, 0.32f, 1.f));
+    m_render_pass->set_cull_mode(RenderPass::CullMode::Disabled);
+    set_points(nullptr, 0);
+}
+
+void ScatterPlot::set_points(const float *positions, size_t count,
+                             const float *colors) {
+    if (count > (size_t) std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("ScatterPlot::set_points(): too many points!");
+
+    m_positions.assign(positions, positions + 2 * count);
+    set_hovered(-1);
+
+    m_bbox_min = Vector2f(std::numeric_limits<float>::infinity());
+    m_bbox_max = Vector2f(-std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < count; ++i) {
+        Vector2f p = point(i);
+        m_bbox_min = min(m_bbox_min, p);
+        m_bbox_max = max(m_bbox_max, p);
+    }
+    if (count == 0) {
+        m_bbox_min = Vector2f(0.f);
+        m_bbox_max = Vector2f(1.f);
+    }
+
+    /* Build a uniform grid with roughly four points per cell (counting sort) */
+    Vector2f extent = max(m_bbox_max - m_bbox_min, Vector2f(1e-20f));
+    float cells = std::max(1.f, count / 4.f),
+          res_x = std::sqrt(cells * extent.x() / extent.y());
+    m_grid_res = Vector2i(
+        (int) std::max(1.f, std::min(4096.f, std::round(res_x))),
+        (int) std::max(1.f, std::min(4096.f, std::round(cells / std::max(res_x, 1.f))))
+    );
+
+    Vector2f cell_scale = Vector2f(m_grid_res) / extent;
+    auto cell_index = [&](const Vector2f &p) {
+        Vector2i c(min((p - m_bbox_min) * cell_scale, Vector2f(m_grid_res - 1)));
+        return (size_t) c.y() * (size_t) m_grid_res.x() + (size_t) c.x();
+    };
+
+    m_grid_start.assign((size_t) m_grid_res.x() * (size_t) m_grid_res.y() + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+        m_grid_start[cell_index(point(i)) + 1]++;
+    for (size_t i = 1; i < m_grid_start.size(); ++i)
+        m_grid_start[i] += m_grid_start[i - 1];
+
+    std::vector<uint32_t> fill(m_grid_start.begin(), m_grid_start.end() - 1);
+    m_grid_points.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        m_grid_points[fill[cell_index(point(i))]++] = (uint32_t) i;
+
+    /* Without per-point colors, a shader variant that lacks the color
+       attribute draws all points using set_point_color(). Switching
+       variants also releases the buffers of the previous one. */
+    bool point_colors = colors != nullptr;
+    if (!m_shader || point_colors != m_point_colors) {
+        if (point_colors)
+            m_shader = new Shader(render_pass(), "scatterplot",
+                                  NANOGUI_SHADER(scatterplot_vertex),
+                                  NANOGUI_SHADER(scatterplot_fragment),
+                                  Shader::BlendMode::AlphaBlend);
+        else
+            m_shader = new Shader(render_pass(), "scatterplot_uniform",
+                                  NANOGUI_SHADER(scatterplot_uniform_vertex),
+                                  NANOGUI_SHADER(scatterplot_fragment),
+                                  Shader::BlendMode::AlphaBlend);
+        m_point_colors = point_colors;
+    }
+
+    /* Upload to the GPU */
+    if (count > 0) {
+        m_shader->set_buffer("position", VariableType::Float32, { count, 2 }, positions);
+        if (point_colors)
+            m_shader->set_buffer("color", VariableType::Float32, { count, 4 }, colors);
+    }
+
+    reset_view();
+}
+
+void ScatterPlot::set_view(const Vector2f &view_min, const Vector2f &view_max) {
+    if (!(view_min.x() < view_max.x() && view_min.y() < view_max.y()))
+        throw std::runtime_error("ScatterPlot::set_view(): invalid view region!");
+    m_view_min = view_min;
+    m_view_max = view_max;
+    set_content_dirty();
+}
+
+void ScatterPlot::reset_view() {
+    /* Leave a small margin so that points on the boundary are fully visible */
+    Vector2f extent = m_bbox_max - m_bbox_min,
+             center = .5f * (m_bbox_min + m_bbox_max);
+    for (size_t i = 0; i < 2; ++i) {
+        if (!(extent[i] > 0.f)) // all points have the same coordinate
+            extent[i] = std::max(std::abs(center[i]) * 1e-3f, 1.f);
+    }
+    m_view_min = center - .525f * extent;
+    m_view_max = center + .525f * extent;
+    set_content_dirty();
+}
+
+Vector2f ScatterPlot::pos_to_point(const Vector2f &pos) const {
+    float border = m_draw_border ? 1.f : 0.f;
+    Vector2f t = (pos - border) / max(Vector2f(m_size) - 2.f * border, Vector2f(1.f));
+    return Vector2f(m_view_min.x() + t.x() * (m_view_max.x() - m_view_min.x()),
+                    m_view_max.y() - t.y() * (m_view_max.y() - m_view_min.y()));
+}
+
+Vector2f ScatterPlot::point_to_pos(const Vector2f &point) const {
+    float border = m_draw_border ? 1.f : 0.f;
+    Vector2f t((point.x() - m_view_min.x()) / (m_view_max.x() - m_view_min.x()),
+               (m_view_max.y() - point.y()) / (m_view_max.y() - m_view_min.y()));
+    return t * (Vector2f(m_size) - 2.f * border) + border;
+}
+
+int ScatterPlot::pick(const Vector2f &pos, float radius) const {
+    if (m_positions.empty())
+        return -1;
+
+    /* Size of a pixel in plot units */
+    float border = m_draw_border ? 1.f : 0.f;
+    Vector2f pixel = (m_view_max - m_view_min) /
+                     max(Vector2f(m_size) - 2.f * border, Vector2f(1.f));
+
+    Vector2f p = pos_to_point(pos),
+             r = pixel * radius;
+
+    if (p.x() + r.x() < m_bbox_min.x() || p.x() - r.x() > m_bbox_max.x() ||
+        p.y() + r.y() < m_bbox_min.y() || p.y() - r.y() > m_bbox_max.y())
+        return -1;
+
+    Vector2f extent = max(m_bbox_max - m_bbox_min, Vector2f(1e-20f)),
+             cell_scale = Vector2f(m_grid_res) / extent;
+
+    auto cell = [&](const Vector2f &q) {
+        return Vector2i(min(max((q - m_bbox_min) * cell_scale, Vector2f(0.f)),
+                            Vector2f(m_grid_res - 1)));
+    };
+
+    Vector2i c0 = cell(p - r), c1 = cell(p + r);
+    float best = radius * radius;
+    int best_index = -1;
+
+    for (int y = c0.y(); y <= c1.y(); ++y) {
+        for (int x = c0.x(); x <= c1.x(); ++x) {
+            size_t c = (size_t) y * (size_t) m_grid_res.x() + (size_t) x;
+            for (uint32_t i = m_grid_start[c]; i < m_grid_start[c + 1]; ++i) {
+                uint32_t index = m_grid_points[i];
+                Vector2f d = (point(index) - p) / pixel;
+                float dist2 = squared_norm(d);
+                if (dist2 <= best) {
+                    best = dist2;
+                    best_index = (int) index;
+                }
+            }
+        }
+    }
+
+    return best_index;
+}
+
+void ScatterPlot::set_hovered(int index) {
+    if (index == m_hovered)
+        return;
+    m_hovered = index;
+    if (m_hover_callback)
+        m_hover_callback(index);
+}
+
+bool ScatterPlot::keyboard_event(int key, int /* scancode */, int action, int /* modifiers */) {
+    if (!m_enabled)
+        return false;
+
+    if (action == GLFW_PRESS && key == GLFW_KEY_R) {
+        reset_view();
+        return true;
+    }
+    return false;
+}
+
+bool ScatterPlot::mouse_drag_event(const Vector2i & /* p */, const Vector2i &rel,
+                                   int /* button */, int /* modifiers */) {
+    if (!m_enabled)
+        return false;
+
+    float border = m_draw_border ? 1.f : 0.f;
+    Vector2f pixel = (m_view_max - m_view_min) /
+                     max(Vector2f(m_size) - 2.f * border, Vector2f(1.f));
+    Vector2f shift(-rel.x() * pixel.x(), rel.y() * pixel.y());
+    m_view_min += shift;
+    m_view_max += shift;
+    set_content_dirty();
+    return true;
+}
+
+bool ScatterPlot::mouse_motion_event(const Vector2i &p, const Vector2i &rel,
+                                     int button, int modifiers) {
+    set_hovered(pick(Vector2f(p - m_pos), std::max(.5f * m_point_size, 4.f)));
+    return Canvas::mouse_motion_event(p, rel, button, modifiers);
+}
+
+bool ScatterPlot::mouse_enter_event(const Vector2i &p, bool enter) {
+    if (!enter)
+        set_hovered(-1);
+    return Canvas::mouse_enter_event(p, enter);
+}
+
+bool ScatterPlot::scroll_event(const Vector2i &p, const Vector2f &rel) {
+    if (!m_enabled)
+        return false;
+
+    /* Zoom around the cursor position */
+    Vector2f center = pos_to_point(Vector2f(p - m_pos));
+    float factor = std::pow(1.1f, -rel.y());
+    m_view_min = center + (m_view_min - center) * factor;
+    m_view_max = center + (m_view_max - center) * factor;
+    set_content_dirty();
+
+    set_hovered(pick(Vector2f(p - m_pos), std::max(.5f * m_point_size, 4.f)));
+    return true;
+}
+
+void ScatterPlot::draw_contents() {
+    if (m_positions.empty())
+        return;
+
+    Vector2f scale = 2.f / (m_view_max - m_view_min),
+             offset = -1.f - m_view_min * scale;
+
+    m_shader->set_uniform("scale", scale);
+    m_shader->set_uniform("offset", offset);
+    m_shader->set_uniform("point_size", m_point_size * screen()->pixel_ratio());
+    m_shader->set_uniform("point_color", m_point_color);
+
+    m_shader->begin();
+    m_shader->draw_array(Shader::PrimitiveType::Point, 0, point_count(), false);
+    m_shader->end();
+}
+
+void ScatterPlot::draw(NVGcontext *ctx) {
+    Canvas::draw(ctx);
+
+    if (m_hovered < 0)
+        return;
+
+    Vector2f p = Vector2f(m_pos) + point_to_pos(point((size_t) m_hovered));
+    nvgBeginPath(ctx);
+    nvgCircle(ctx, p.x(), p.y(), .5f * m_point_size + 2.f);
+    nvgStrokeWidth(ctx, 1.5f);
+    nvgStrokeColor(ctx, m_theme->m_text_color);
+    nvgStroke(ctx);
+}
+
+NAMESPACE_END(nanogui)
@@ -17,7 +17,13 @@
 #include <nanogui/window.h>
 #include <nanogui/popup.h>
 #include <nanogui/metal.h>
+#include <nanogui/textureloader.h>
+#include <nanogui/shader.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
 #include <map>
+#include <mutex>
+#include <set>
 #include <iostream>
 
 #if defined(EMSCRIPTEN)
@@ -68,6 +74,10 @@ NAMESPACE_BEGIN(nanogui)
 
 std::map<GLFWwindow *, Screen *> __nanogui_screens;
 
+/* Screens that are still alive, for redraw requests from other threads */
+static std::mutex live_screens_mutex;
+static std::set<Screen *> live_screens;
+
 #if defined(NANOGUI_GLAD)
 static bool glad_initialized = false;
 #endif
@@ -286,6 +296,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     glfwMakeContextCurrent(m_glfw_window);
+    GLState::current().invalidate();
 #endif
 
     glfwSetInputMode(m_glfw_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -302,7 +313,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
     glfwGetFramebufferSize(m_glfw_window, &m_fbsize[0], &m_fbsize[1]);
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
-    CHK(glViewport(0, 0, m_fbsize[0], m_fbsize[1]));
+    GLState::current().set_viewport(Vector4i(0, 0, m_fbsize[0], m_fbsize[1]));
     CHK(glClearColor(m_background[0], m_background[1],
                      m_background[2], m_background[3]));
     CHK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
@@ -439,6 +450,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
             1,
             Texture::TextureFlags::RenderTarget
         );
+        m_depth_stencil_texture->set_owner("Screen");
     }
 #endif
 }
@@ -517,6 +529,10 @@ void Screen::initialize(GLFWwindow *window, bool shutdown_glfw) {
     m_process_events = true;
     m_redraw = true;
     __nanogui_screens[m_glfw_window] = this;
+    {
+        std::lock_guard<std::mutex> guard(live_screens_mutex);
+        live_screens.insert(this);
+    }
 
     for (size_t i = 0; i < (size_t) Cursor::CursorCount; ++i)
         m_cursors[i] = glfwCreateStandardCursor(GLFW_ARROW_CURSOR + (int) i);
@@ -524,10 +540,26 @@ void Screen::initialize(GLFWwindow *window, bool shutdown_glfw) {
     /// Fixes retina display-related font rendering issue (#185)
     nvgBeginFrame(m_nvg_context, m_size[0], m_size[1], m_pixel_ratio);
     nvgEndFrame(m_nvg_context);
+    nvg_state_changed();
 }
 
 Screen::~Screen() {
     __nanogui_screens.erase(m_glfw_window);
+    {
+        std::lock_guard<std::mutex> guard(live_screens_mutex);
+        live_screens.erase(this);
+    }
+    if (m_texture_loader) {
+        m_texture_loader->shutdown();
+        m_texture_loader = nullptr;
+    }
+    for (auto &kv : m_texture_images)
+        nvgDeleteImage(m_nvg_context, kv.second.image);
+    m_texture_images.clear();
+    m_nvg_gpu_timer = nullptr;
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    m_uniform_ring = nullptr;
+#endif
     for (size_t i = 0; i < (size_t) Cursor::CursorCount; ++i) {
         if (m_cursors[i])
             glfwDestroyCursor(m_cursors[i]);
@@ -587,7 +619,9 @@ void Screen::clear() {
 
 void Screen::draw_setup() {
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /* The state tracker is shared by all screens (and thus contexts) */
     glfwMakeContextCurrent(m_glfw_window);
+    GLState::current().invalidate();
 #elif defined(NANOGUI_USE_METAL)
     void *nswin = glfwGetCocoaWindow(m_glfw_window);
     metal_window_set_size(nswin, m_fbsize);
@@ -613,9 +647,7 @@ void Screen::draw_setup() {
         m_pixel_ratio = (float) m_fbsize[0] / (float) m_size[0];
 #endif
 
-#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
-    CHK(glViewport(0, 0, m_fbsize[0], m_fbsize[1]));
-#endif
+    nvg_state_changed();
 }
 
 void Screen::draw_teardown() {
@@ -634,6 +666,8 @@ void Screen::draw_all() {
         m_redraw = false;
 
         draw_setup();
+        if (m_texture_loader)
+            m_texture_loader->update();
         draw_contents();
         draw_widgets();
         draw_teardown();
@@ -644,10 +678,83 @@ void Screen::draw_contents() {
     clear();
 }
 
+TextureLoader *Screen::texture_loader() {
+    if (!m_texture_loader)
+        m_texture_loader = new TextureLoader(this);
+    return m_texture_loader;
+}
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+UniformRing *Screen::uniform_ring() {
+    if (!m_uniform_ring)
+        m_uniform_ring = new UniformRing();
+    return m_uniform_ring;
+}
+#endif
+
 void Screen::nvg_flush() {
     NVGparams *params = nvgInternalParams(m_nvg_context);
+    if (m_nvg_gpu_timer)
+        m_nvg_gpu_timer->begin();
     params->renderFlush(params->userPtr);
+    if (m_nvg_gpu_timer)
+        m_nvg_gpu_timer->end();
     params->renderViewport(params->userPtr, m_size[0], m_size[1], m_pixel_ratio);
+    nvg_state_changed();
+}
+
+int Screen::nvg_texture_image(Texture *texture) {
+    uintptr_t handle = (uintptr_t) texture->texture_handle();
+    TextureImage &entry = m_texture_images[texture];
+
+    /* Resizing a texture may replace its handle (on Metal) */
+    if (entry.image && (entry.handle != handle || entry.size != texture->size())) {
+        nvgDeleteImage(m_nvg_context, entry.image);
+        entry.image = 0;
+    }
+
+    if (!entry.image) {
+        const Vector2i &size = texture->size();
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        int flags = NVG_IMAGE_NODELETE;
+        if (texture->flags() & Texture::TextureFlags::RenderTarget)
+            flags |= NVG_IMAGE_FLIPY;
+#  if defined(NANOGUI_USE_OPENGL)
+        entry.image = nvglCreateImageFromHandleGL3(m_nvg_context, (GLuint) handle,
+                                                   size.x(), size.y(), flags);
+#  else
+        entry.image = nvglCreateImageFromHandleGLES2(m_nvg_context, (GLuint) handle,
+                                                     size.x(), size.y(), flags);
+#  endif
+#elif defined(NANOGUI_USE_METAL)
+        entry.image = mnvgCreateImageFromHandle(m_nvg_context, texture->texture_handle(), 0);
+#endif
+        if (!entry.image)
+            throw std::runtime_error("Screen::nvg_texture_image(): could not "
+                                     "create a NanoVG image!");
+        entry.texture = texture;
+        entry.handle = handle;
+        entry.size = size;
+    }
+
+    entry.used = true;
+    return entry.image;
+}
+
+void Screen::nvg_state_changed() {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /* NanoVG changes the OpenGL state behind the tracker's back. Establish
+       the state that it expects (and leaves behind), so that every field a
+       render pass modifies is known and restored by RenderPass::end(). */
+    GLState &state = GLState::current();
+    state.invalidate();
+    state.set_viewport(Vector4i(0, 0, m_fbsize[0], m_fbsize[1]));
+    state.set_depth_test(false);
+    state.set_depth_mask(true);
+    state.set_scissor_test(false);
+    state.set_cull_face(false);
+    state.set_blend(true);
+#endif
 }
 
 void Screen::draw_widgets() {
@@ -714,7 +821,23 @@ void Screen::draw_widgets() {
         }
     }
 
+    if (m_nvg_gpu_timer)
+        m_nvg_gpu_timer->begin();
     nvgEndFrame(m_nvg_context);
+    if (m_nvg_gpu_timer)
+        m_nvg_gpu_timer->end();
+    nvg_state_changed();
+
+    /* Release the images of textures that were not drawn in this frame */
+    for (auto it = m_texture_images.begin(); it != m_texture_images.end(); ) {
+        if (it->second.used) {
+            it->second.used = false;
+            ++it;
+        } else {
+            nvgDeleteImage(m_nvg_context, it->second.image);
+            it = m_texture_images.erase(it);
+        }
+    }
 }
 
 bool Screen::keyboard_event(int key, int scancode, int action, int modifiers) {
@@ -745,14 +868,22 @@ bool Screen::resize_event(const Vector2i& size) {
 }
 
 void Screen::redraw() {
-    if (!m_redraw) {
-        m_redraw = true;
+    if (!m_redraw.exchange(true)) {
         #if !defined(EMSCRIPTEN)
             glfwPostEmptyEvent();
         #endif
     }
 }
 
+void Screen::redraw_async(Screen *screen) {
+    if (!screen)
+        return;
+    /* Holding the lock keeps the screen alive until the request is posted */
+    std::lock_guard<std::mutex> guard(live_screens_mutex);
+    if (live_screens.count(screen))
+        screen->redraw();
+}
+
 void Screen::cursor_pos_callback_event(double x, double y) {
     Vector2i p((int) x, (int) y);
 
@@ -781,7 +912,8 @@ void Screen::cursor_pos_callback_event(double x, double y) {
             ret = mouse_motion_event(p, p - m_mouse_pos, m_mouse_state, m_modifiers);
 
         m_mouse_pos = p;
-        m_redraw |= ret;
+        if (ret)
+            m_redraw = true;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
     }
@@ -814,9 +946,10 @@ void Screen::mouse_button_callback_event(int button, int action, int modifiers)
         auto drop_widget = find_widget(m_mouse_pos);
         if (m_drag_active && action == GLFW_RELEASE &&
             drop_widget != m_drag_widget) {
-            m_redraw |= m_drag_widget->mouse_button_event(
-                m_mouse_pos - m_drag_widget->parent()->absolute_position(), button,
-                false, m_modifiers);
+            if (m_drag_widget->mouse_button_event(
+                    m_mouse_pos - m_drag_widget->parent()->absolute_position(),
+                    button, false, m_modifiers))
+                m_redraw = true;
         }
 
         if (drop_widget != nullptr && drop_widget->cursor() != m_cursor) {
@@ -838,8 +971,9 @@ void Screen::mouse_button_callback_event(int button, int action, int modifiers)
             m_drag_widget = nullptr;
         }
 
-        m_redraw |= mouse_button_event(m_mouse_pos, button,
-                                       action == GLFW_PRESS, m_modifiers);
+        if (mouse_button_event(m_mouse_pos, button,
+                               action == GLFW_PRESS, m_modifiers))
+            m_redraw = true;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
     }
@@ -848,7 +982,8 @@ void Screen::mouse_button_callback_event(int button, int action, int modifiers)
 void Screen::key_callback_event(int key, int scancode, int action, int mods) {
     m_last_interaction = glfwGetTime();
     try {
-        m_redraw |= keyboard_event(key, scancode, action, mods);
+        if (keyboard_event(key, scancode, action, mods))
+            m_redraw = true;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
     }
@@ -857,7 +992,8 @@ void Screen::key_callback_event(int key, int scancode, int action, int mods) {
 void Screen::char_callback_event(unsigned int codepoint) {
     m_last_interaction = glfwGetTime();
     try {
-        m_redraw |= keyboard_character_event(codepoint);
+        if (keyboard_character_event(codepoint))
+            m_redraw = true;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
     }
@@ -867,7 +1003,8 @@ void Screen::drop_callback_event(int count, const char **filenames) {
     std::vector<std::string> arg(count);
     for (int i = 0; i < count; ++i)
         arg[i] = filenames[i];
-    m_redraw |= drop_event(arg);
+    if (drop_event(arg))
+        m_redraw = true;
 }
 
 void Screen::scroll_callback_event(double x, double y) {
@@ -881,7 +1018,8 @@ void Screen::scroll_callback_event(double x, double y) {
                     return;
             }
         }
-        m_redraw |= scroll_event(m_mouse_pos, Vector2f(x, y));
+        if (scroll_event(m_mouse_pos, Vector2f(x, y)))
+            m_redraw = true;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
     }
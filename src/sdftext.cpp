@@ -0,0 +1,367 @@
+/*
+    src/sdftext.cpp -- Resolution-independent text rendering using
+    signed distance fields
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/sdftext.h>
+#include <nanogui/shader.h>
+#include <nanogui/texture.h>
+#include <nanogui/opengl.h>
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/// Supersampling factor used when rasterizing glyphs
+static const int sdf_oversampling = 4;
+
+/// Maximum height of the glyph atlas
+static const int sdf_max_atlas_height = 4096;
+
+struct SDFFont::FontInfo {
+    stbtt_fontinfo info;
+    float scale;
+};
+
+/// Decode the next code point from a UTF-8 string (invalid bytes map to U+FFFD)
+static uint32_t utf8_next(const char *&it, const char *end) {
+    uint8_t c = (uint8_t) *it++;
+    int extra = c < 0x80 ? 0 : c < 0xE0 ? 1 : c < 0xF0 ? 2 : 3;
+    uint32_t codepoint = extra == 0 ? c : c & (0x3F >> extra);
+    if (c >= 0x80 && c < 0xC0)
+        return 0xFFFD;
+    for (int i = 0; i < extra; ++i) {
+        if (it == end || ((uint8_t) *it & 0xC0) != 0x80)
+            return 0xFFFD;
+        codepoint = (codepoint << 6) | ((uint8_t) *it++ & 0x3F);
+    }
+    return codepoint;
+}
+
+/**
+ * Exact 1D squared Euclidean distance transform (Felzenszwalb & Huttenlocher).
+ * 'f' is sampled with the given stride and overwritten with the result.
+ */
+static void edt_1d(float *f, int n, int stride, float *d, int *v, float *z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -1e20f;
+    z[1] = 1e20f;
+
+    for (int q = 1; q < n; ++q) {
+        float fq = f[q * stride] + q * q, s;
+        while (true) {
+            int r = v[k];
+            s = (fq - (f[r * stride] + r * r)) / (2 * q - 2 * r);
+            if (s > z[k])
+                break;
+            --k; // z[0] = -inf guarantees termination
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = 1e20f;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q)
+            ++k;
+        int r = v[k];
+        d[q] = (float) ((q - r) * (q - r)) + f[r * stride];
+    }
+    for (int q = 0; q < n; ++q)
+        f[q * stride] = d[q];
+}
+
+/// 2D squared Euclidean distance transform of a w x h grid
+static void edt_2d(float *f, int w, int h) {
+    int n = std::max(w, h);
+    std::unique_ptr<float[]> d(new float[n]), z(new float[n + 1]);
+    std::unique_ptr<int[]> v(new int[n]);
+
+    for (int x = 0; x < w; ++x)
+        edt_1d(f + x, h, w, d.get(), v.get(), z.get());
+    for (int y = 0; y < h; ++y)
+        edt_1d(f + y * w, w, 1, d.get(), v.get(), z.get());
+}
+
+SDFFont::SDFFont(const std::string &font_name, float reference_size, int spread)
+    : m_font(new FontInfo()), m_reference_size(reference_size), m_spread(spread) {
+    std::string_view data = resource(font_name);
+    const unsigned char *ptr = (const unsigned char *) data.data();
+
+    if (!stbtt_InitFont(&m_font->info, ptr, stbtt_GetFontOffsetForIndex(ptr, 0)))
+        throw std::runtime_error("SDFFont::SDFFont(): could not load font \"" +
+                                 font_name + "\"!");
+
+    m_font->scale = stbtt_ScaleForPixelHeight(&m_font->info, reference_size);
+
+    int ascender, descender, line_gap;
+    stbtt_GetFontVMetrics(&m_font->info, &ascender, &descender, &line_gap);
+    m_ascender = ascender * m_font->scale;
+    m_descender = descender * m_font->scale;
+
+    m_atlas_size = Vector2i(512, 256);
+    m_atlas.resize((size_t) m_atlas_size.x() * (size_t) m_atlas_size.y(), 0);
+
+    for (uint32_t c = 32; c < 127; ++c)
+        add_glyph(c);
+}
+
+SDFFont::~SDFFont() { }
+
+const SDFFont::Glyph &SDFFont::glyph(uint32_t codepoint) {
+    auto it = m_glyphs.find(codepoint);
+    if (it != m_glyphs.end())
+        return it->second;
+    return add_glyph(codepoint);
+}
+
+float SDFFont::kerning(const Glyph &g1, const Glyph &g2) const {
+    return stbtt_GetGlyphKernAdvance(&m_font->info, g1.index, g2.index) * m_font->scale;
+}
+
+float SDFFont::text_width(const std::string &text, float size) {
+    const char *it = text.data(), *end = it + text.size();
+    const Glyph *prev = nullptr;
+    float width = 0.f;
+
+    while (it != end) {
+        const Glyph &g = glyph(utf8_next(it, end));
+        if (prev)
+            width += kerning(*prev, g);
+        width += g.advance;
+        prev = &g;
+    }
+
+    return width * size / m_reference_size;
+}
+
+SDFFont::Glyph &SDFFont::add_glyph(uint32_t codepoint) {
+    const stbtt_fontinfo *info = &m_font->info;
+    const int os = sdf_oversampling;
+    float scale_hi = m_font->scale * os;
+
+    Glyph g;
+    g.index = stbtt_FindGlyphIndex(info, (int) codepoint);
+
+    int advance, lsb;
+    stbtt_GetGlyphHMetrics(info, g.index, &advance, &lsb);
+    g.advance = advance * m_font->scale;
+
+    int x0, y0, x1, y1;
+    stbtt_GetGlyphBitmapBox(info, g.index, scale_hi, scale_hi, &x0, &y0, &x1, &y1);
+
+    if (x1 <= x0 || y1 <= y0) { // e.g. whitespace
+        g.atlas_pos = Vector2i(0);
+        g.size = Vector2i(0);
+        g.offset = Vector2f(0.f);
+        return m_glyphs[codepoint] = g;
+    }
+
+    /* Rasterize with supersampling and a margin of 'spread' reference pixels */
+    Vector2i size((x1 - x0 + os - 1) / os + 2 * m_spread,
+                  (y1 - y0 + os - 1) / os + 2 * m_spread);
+    int w_hi = size.x() * os, h_hi = size.y() * os, pad = m_spread * os;
+
+    std::vector<uint8_t> coverage((size_t) w_hi * h_hi, 0);
+    stbtt_MakeGlyphBitmap(info, coverage.data() + pad * w_hi + pad, x1 - x0,
+                          y1 - y0, w_hi, scale_hi, scale_hi, g.index);
+
+    /* Squared distances to the nearest inside/outside texel */
+    std::vector<float> dist_out(coverage.size()), dist_in(coverage.size());
+    for (size_t i = 0; i < coverage.size(); ++i) {
+        bool inside = coverage[i] >= 128;
+        dist_out[i] = inside ? 0.f : 1e20f;
+        dist_in[i]  = inside ? 1e20f : 0.f;
+    }
+    edt_2d(dist_out.data(), w_hi, h_hi);
+    edt_2d(dist_in.data(), w_hi, h_hi);
+
+    /* Find space in the atlas (shelf packing), growing it if needed */
+    if (m_shelf_pos.x() + size.x() > m_atlas_size.x()) {
+        m_shelf_pos = Vector2i(0, m_shelf_pos.y() + m_shelf_height + 1);
+        m_shelf_height = 0;
+    }
+    if (size.x() > m_atlas_size.x())
+        throw std::runtime_error("SDFFont::add_glyph(): glyph is too large!");
+    while (m_shelf_pos.y() + size.y() > m_atlas_size.y()) {
+        if (m_atlas_size.y() * 2 > sdf_max_atlas_height)
+            throw std::runtime_error("SDFFont::add_glyph(): atlas is full!");
+        m_atlas_size.y() *= 2;
+        m_atlas.resize((size_t) m_atlas_size.x() * (size_t) m_atlas_size.y(), 0);
+    }
+    g.atlas_pos = m_shelf_pos;
+    g.size = size;
+    g.offset = Vector2f(x0 - pad, y0 - pad) / (float) os;
+    m_shelf_pos.x() += size.x() + 1;
+    m_shelf_height = std::max(m_shelf_height, size.y());
+
+    /* Downsample the signed distance (measured in reference pixels) and map
+       [-spread, spread] to [1, 0], so that the outline lies at 0.5 */
+    float norm = 1.f / (os * os * os * 2.f * m_spread);
+    for (int y = 0; y < size.y(); ++y) {
+        uint8_t *row = m_atlas.data() + (size_t) (g.atlas_pos.y() + y) * m_atlas_size.x() +
+                       g.atlas_pos.x();
+        for (int x = 0; x < size.x(); ++x) {
+            float sum = 0.f;
+            for (int dy = 0; dy < os; ++dy) {
+                for (int dx = 0; dx < os; ++dx) {
+                    size_t i = (size_t) (y * os + dy) * w_hi + (x * os + dx);
+                    /* Shift by half a texel, since the outline passes between
+                       the nearest inside and outside texels */
+                    sum += dist_out[i] > 0.f ? std::sqrt(dist_out[i]) - .5f
+                                             : .5f - std::sqrt(dist_in[i]);
+                }
+            }
+            float value = .5f - sum * norm;
+            row[x] = (uint8_t) (std::max(0.f, std::min(1.f, value)) * 255.f + .5f);
+        }
+    }
+
+    m_atlas_version++;
+    return m_glyphs[codepoint] = g;
+}
+
+SDFText::SDFText(RenderPass *render_pass, SDFFont *font) : m_font(font) {
+    if (!m_font)
+        m_font = new SDFFont();
+
+    m_shader = new Shader(
+        render_pass,
+        "sdf_text",
+        NANOGUI_SHADER(sdf_text_vertex),
+        NANOGUI_SHADER(sdf_text_fragment),
+        Shader::BlendMode::AlphaBlend
+    );
+}
+
+void SDFText::clear() {
+    m_positions.clear();
+    m_uvs.clear();
+    m_colors.clear();
+    m_params.clear();
+    m_dirty = true;
+}
+
+void SDFText::add(const std::string &text, const Vector2f &pos, float size,
+                  const Color &color, int align, float blur) {
+    float scale = size / m_font->reference_size();
+    Vector2f pen = pos;
+
+    if (align & NVG_ALIGN_CENTER)
+        pen.x() -= .5f * m_font->text_width(text, size);
+    else if (align & NVG_ALIGN_RIGHT)
+        pen.x() -= m_font->text_width(text, size);
+
+    if (align & NVG_ALIGN_TOP)
+        pen.y() += m_font->ascender() * scale;
+    else if (align & NVG_ALIGN_MIDDLE)
+        pen.y() += .5f * (m_font->ascender() + m_font->descender()) * scale;
+    else if (align & NVG_ALIGN_BOTTOM)
+        pen.y() += m_font->descender() * scale;
+
+    /* Distance field values change by 1/(2*spread) per reference pixel.
+       Smooth over one target pixel, plus the requested amount of blur */
+    float units_per_pixel = 1.f / (2.f * m_font->spread() * scale),
+          smoothing = std::min(.5f, (.5f + blur) * units_per_pixel);
+
+    const char *it = text.data(), *end = it + text.size();
+    const SDFFont::Glyph *prev = nullptr;
+
+    while (it != end) {
+        const SDFFont::Glyph &g = m_font->glyph(utf8_next(it, end));
+        if (prev)
+            pen.x() += m_font->kerning(*prev, g) * scale;
+        prev = &g;
+
+        if (g.size.x() > 0) {
+            Vector2f p0 = pen + g.offset * scale,
+                     p1 = p0 + Vector2f(g.size) * scale,
+                     t0 = Vector2f(g.atlas_pos),
+                     t1 = t0 + Vector2f(g.size);
+
+            const float positions[12] = { p0.x(), p0.y(), p1.x(), p0.y(), p0.x(), p1.y(),
+                                          p1.x(), p0.y(), p1.x(), p1.y(), p0.x(), p1.y() };
+            const float uvs[12] = { t0.x(), t0.y(), t1.x(), t0.y(), t0.x(), t1.y(),
+                                    t1.x(), t0.y(), t1.x(), t1.y(), t0.x(), t1.y() };
+
+            m_positions.insert(m_positions.end(), positions, positions + 12);
+            m_uvs.insert(m_uvs.end(), uvs, uvs + 12);
+            for (int i = 0; i < 6; ++i) {
+                m_colors.insert(m_colors.end(), color.v, color.v + 4);
+                m_params.push_back(.5f);
+                m_params.push_back(smoothing);
+            }
+        }
+
+        pen.x() += g.advance * scale;
+    }
+
+    m_dirty = true;
+}
+
+void SDFText::draw(const Matrix4f &mvp) {
+    size_t vertex_count = glyph_count() * 6;
+    if (vertex_count == 0)
+        return;
+
+    if (m_atlas_version != m_font->atlas_version()) {
+        if (!m_atlas) {
+            m_atlas = new Texture(
+                Texture::PixelFormat::R,
+                Texture::ComponentFormat::UInt8,
+                m_font->atlas_size(),
+                Texture::InterpolationMode::Bilinear,
+                Texture::InterpolationMode::Bilinear,
+                Texture::WrapMode::ClampToEdge
+            );
+            m_atlas->set_owner("SDFText");
+        } else if (m_atlas->size() != m_font->atlas_size())
+            m_atlas->resize(m_font->atlas_size());
+
+        m_atlas->upload(m_font->atlas_data());
+        m_shader->set_texture("font", m_atlas);
+        m_atlas_version = m_font->atlas_version();
+    }
+
+    if (m_dirty) {
+        m_shader->set_buffer("position", VariableType::Float32, { vertex_count, 2 },
+                             m_positions.data());
+        m_shader->set_buffer("uv", VariableType::Float32, { vertex_count, 2 },
+                             m_uvs.data());
+        m_shader->set_buffer("color", VariableType::Float32, { vertex_count, 4 },
+                             m_colors.data());
+        m_shader->set_buffer("params", VariableType::Float32, { vertex_count, 2 },
+                             m_params.data());
+        m_dirty = false;
+    }
+
+    m_shader->set_uniform("mvp", mvp);
+    m_shader->set_uniform("atlas_size", Vector2f(m_font->atlas_size()));
+
+    m_shader->begin();
+    m_shader->draw_array(Shader::PrimitiveType::Triangle, 0, vertex_count, false);
+    m_shader->end();
+}
+
+NAMESPACE_END(nanogui)
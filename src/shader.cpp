@@ -1,4 +1,5 @@
 #include <nanogui/shader.h>
+#include <cstdio>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -9,6 +10,8 @@ std::string Shader::Buffer::to_string() const {
         case BufferType::FragmentBuffer: result += "fragment"; break;
         case BufferType::UniformBuffer: result += "uniform"; break;
         case BufferType::IndexBuffer: result += "index"; break;
+        case BufferType::UniformBlock: result += "uniform block"; break;
+        case BufferType::UniformBlockMember: result += "uniform block member"; break;
         default: result += "unknown"; break;
     }
     result += ", dtype=";
@@ -23,4 +26,80 @@ std::string Shader::Buffer::to_string() const {
     return result;
 }
 
+Shader::BindingHandle Shader::binding(const std::string &name) const {
+    auto it = m_binding_index.find(name);
+    if (it == m_binding_index.end())
+        throw std::runtime_error(
+            "Shader::binding(): could not find argument named \"" + name + "\"");
+    return BindingHandle{ it->second };
+}
+
+Shader::Buffer &Shader::add_binding(const std::string &name) {
+    if (!m_binding_index.emplace(name, (uint32_t) m_buffers.size()).second)
+        throw std::runtime_error(
+            "Shader::Shader(): \"" + name +
+            "\": duplicate argument name in shader code!");
+    Buffer &buf = m_buffers.emplace_back();
+    buf.name = name;
+    return buf;
+}
+
+Shader::Buffer &Shader::buffer(BindingHandle binding, const char *caller) {
+    if (binding.index >= m_buffers.size())
+        throw std::runtime_error(std::string("Shader::") + caller +
+                                 "(): invalid binding handle!");
+    return m_buffers[binding.index];
+}
+
+void Shader::set_buffer_usage(BindingHandle binding, BufferUsage usage) {
+    Buffer &buf = buffer(binding, "set_buffer_usage");
+    if (!(buf.type == VertexBuffer || buf.type == IndexBuffer))
+        throw std::runtime_error(
+            "Shader::set_buffer_usage(): argument named \"" + buf.name +
+            "\" is not a vertex or index buffer!");
+    buf.usage = usage;
+}
+
+void Shader::finalize_bindings() {
+    m_indices = binding("indices").index;
+    for (uint32_t i = 0; i < (uint32_t) m_buffers.size(); ++i) {
+        if (m_buffers[i].persistent)
+            m_persistent.push_back(i);
+    }
+}
+
+void Shader::check_bindings() {
+    bool complete = true;
+    for (const Buffer &buf : m_buffers) {
+        /* Members of uniform blocks are zero-initialized */
+        if (buf.buffer || buf.type == IndexBuffer || buf.type == UniformBlockMember)
+            continue;
+        fprintf(stderr,
+                "Shader::begin(): shader \"%s\" has an unbound "
+                "argument \"%s\"!\n",
+                m_name.c_str(), buf.name.c_str());
+        complete = false;
+    }
+    m_bindings_complete = complete;
+}
+
+void Shader::pin_textures() {
+    /* Restoring an evicted texture uploads through texture unit 0 and may
+       trigger evictions, hence this must finish before any unit is bound */
+    unpin_textures();
+    for (uint32_t index : m_persistent) {
+        Buffer &buf = m_buffers[index];
+        if ((buf.type != VertexTexture && buf.type != FragmentTexture) || !buf.texture)
+            continue;
+        buf.texture->pin();
+        m_pinned.push_back(buf.texture);
+    }
+}
+
+void Shader::unpin_textures() {
+    for (Texture *texture : m_pinned)
+        texture->unpin();
+    m_pinned.clear();
+}
+
 NAMESPACE_END(nanogui)
@@ -3,7 +3,23 @@
 #include <nanogui/screen.h>
 #include <nanogui/texture.h>
 #include <nanogui/renderpass.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
+#include "opengl_extensions.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#if defined(_WIN32)
+#  include <direct.h>
+#  include <process.h>
+#else
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 #if !defined(GL_HALF_FLOAT)
 #  define GL_HALF_FLOAT 0x140B
@@ -11,6 +27,242 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+extern std::map<GLFWwindow *, Screen *> __nanogui_screens;
+
+static GLenum gl_buffer_usage(Shader::BufferUsage usage) {
+    switch (usage) {
+        case Shader::BufferUsage::Static:  return GL_STATIC_DRAW;
+        case Shader::BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+        default:                           return GL_STREAM_DRAW;
+    }
+}
+
+#if defined(NANOGUI_USE_OPENGL)
+/// Is glBufferStorage() available? (OpenGL 4.4 or ARB_buffer_storage)
+static bool buffer_storage_supported() {
+    static int supported = -1;
+    if (supported < 0)
+        supported = gl_supports(44, "GL_ARB_buffer_storage");
+    return supported != 0;
+}
+
+/// Block until the GPU has passed a fence, then delete it
+static void wait_fence(void *&fence) {
+    if (!fence)
+        return;
+    GLsync sync = (GLsync) fence;
+    while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+        ;
+    CHK(glDeleteSync(sync));
+    fence = nullptr;
+}
+
+/// Delete a persistently mapped buffer along with its fences
+static void release_mapping(uint32_t &buffer, uint8_t *&data, void **fences, size_t fence_count) {
+    for (size_t i = 0; i < fence_count; ++i) {
+        if (fences[i])
+            CHK(glDeleteSync((GLsync) fences[i]));
+        fences[i] = nullptr;
+    }
+    if (buffer)
+        CHK(glDeleteBuffers(1, &buffer));
+    buffer = 0;
+    data = nullptr;
+}
+#endif
+
+/* Program binaries are available on OpenGL 4.1 (or ARB_get_program_binary)
+   and GLES 3 */
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+#  define NANOGUI_PROGRAM_BINARY
+#endif
+
+static std::string default_program_cache_directory() {
+#if defined(EMSCRIPTEN)
+    return std::string();
+#elif defined(_WIN32)
+    const char *base = std::getenv("LOCALAPPDATA");
+    return base ? std::string(base) + "\\nanogui\\shaders" : std::string();
+#else
+    const char *home = std::getenv("HOME");
+#  if defined(__APPLE__)
+    return home ? std::string(home) + "/Library/Caches/nanogui/shaders" : std::string();
+#  else
+    const char *base = std::getenv("XDG_CACHE_HOME");
+    if (base && base[0] != '\0')
+        return std::string(base) + "/nanogui/shaders";
+    return home ? std::string(home) + "/.cache/nanogui/shaders" : std::string();
+#  endif
+#endif
+}
+
+static std::string program_cache_dir = default_program_cache_directory();
+static Shader::ProgramCacheStats program_cache_stats_;
+
+void Shader::set_program_cache_directory(const std::string &path) {
+    program_cache_dir = path;
+}
+
+const std::string &Shader::program_cache_directory() {
+    return program_cache_dir;
+}
+
+const Shader::ProgramCacheStats &Shader::program_cache_stats() {
+    return program_cache_stats_;
+}
+
+#if defined(NANOGUI_PROGRAM_BINARY)
+/// Header of a cache entry, followed by the driver string and the binary
+struct ProgramCacheHeader {
+    char magic[4];
+    uint32_t format;
+    uint32_t driver_size;
+    uint32_t binary_size;
+};
+
+static bool program_binary_supported() {
+    static int supported = -1;
+    if (supported < 0) {
+#if defined(NANOGUI_USE_OPENGL)
+        supported = gl_supports(41, "GL_ARB_get_program_binary");
+#  if defined(NANOGUI_GLAD)
+        supported = supported && glGetProgramBinary && glProgramBinary;
+#  endif
+#else
+        supported = 1;
+#endif
+        if (supported) {
+            GLint format_count = 0;
+            CHK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count));
+            supported = format_count > 0;
+        }
+    }
+    return supported != 0;
+}
+
+/// Identifies the driver, whose binaries are incompatible with other drivers
+static std::string driver_string() {
+    std::string result;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char *value = (const char *) glGetString(name);
+        result += value ? value : "";
+        result += '\n';
+    }
+    return result;
+}
+
+/// 64-bit FNV-1a hash
+static uint64_t fnv1a(uint64_t hash, const std::string &str) {
+    for (char c : str) {
+        hash ^= (uint8_t) c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void create_directories(const std::string &path) {
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i < path.size() && path[i] != '/' && path[i] != '\\')
+            continue;
+        std::string prefix = path.substr(0, i);
+#if defined(_WIN32)
+        (void) _mkdir(prefix.c_str());
+#else
+        (void) mkdir(prefix.c_str(), 0755);
+#endif
+    }
+}
+
+/// Try to load a program from the cache (returns \c false if it must be compiled)
+static bool load_program_binary(GLuint program, const std::string &filename,
+                                const std::string &driver) {
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return false;
+
+    ProgramCacheHeader header;
+    std::string stored_driver;
+    std::vector<uint8_t> binary;
+    bool valid = fread(&header, sizeof(ProgramCacheHeader), 1, file) == 1 &&
+                 memcmp(header.magic, "NGPB", 4) == 0 &&
+                 header.driver_size == driver.size();
+    if (valid) {
+        stored_driver.resize(header.driver_size);
+        binary.resize(header.binary_size);
+        valid = fread(&stored_driver[0], 1, stored_driver.size(), file) == stored_driver.size() &&
+                fread(binary.data(), 1, binary.size(), file) == binary.size() &&
+                stored_driver == driver;
+    }
+    fclose(file);
+
+    GLint status = GL_FALSE;
+    if (valid) {
+        /* The driver may reject the binary (e.g. after an update that did
+           not change its version string), which is not an error */
+        glProgramBinary(program, (GLenum) header.format, binary.data(),
+                        (GLsizei) binary.size());
+        while (glGetError() != GL_NO_ERROR)
+            ;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+    }
+
+    if (status != GL_TRUE)
+        program_cache_stats_.rejected++;
+    return status == GL_TRUE;
+}
+
+static void store_program_binary(GLuint program, const std::string &filename,
+                                 const std::string &driver) {
+    GLint size = 0;
+    CHK(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size));
+    if (size <= 0)
+        return;
+
+    ProgramCacheHeader header;
+    memcpy(header.magic, "NGPB", 4);
+    std::vector<uint8_t> binary((size_t) size);
+    GLenum format = 0;
+    CHK(glGetProgramBinary(program, size, &size, &format, binary.data()));
+    header.format = (uint32_t) format;
+    header.driver_size = (uint32_t) driver.size();
+    header.binary_size = (uint32_t) size;
+
+    /* Write to a temporary file that is unique to this process and call,
+       and then rename it into place. Concurrent writers of the same entry
+       thus never interleave, and readers never see a partial entry. */
+    static std::atomic<uint32_t> temp_counter { 0 };
+#if defined(_WIN32)
+    int pid = _getpid();
+#else
+    int pid = (int) getpid();
+#endif
+    create_directories(program_cache_dir);
+    std::string temp_filename = filename + "." + std::to_string(pid) + "." +
+                                std::to_string(temp_counter++) + ".tmp";
+    FILE *file = fopen(temp_filename.c_str(), "wb");
+    if (!file)
+        return;
+    bool success = fwrite(&header, sizeof(ProgramCacheHeader), 1, file) == 1 &&
+                   fwrite(driver.data(), 1, driver.size(), file) == driver.size() &&
+                   fwrite(binary.data(), 1, (size_t) size, file) == (size_t) size;
+    success &= fclose(file) == 0;
+
+    if (success) {
+#if defined(_WIN32)
+        /* rename() does not replace existing files on Windows. Readers see
+           a cache miss in the meantime, which is harmless. */
+        std::remove(filename.c_str());
+#endif
+        success = std::rename(temp_filename.c_str(), filename.c_str()) == 0;
+    }
+
+    if (success)
+        program_cache_stats_.stored++;
+    else
+        std::remove(temp_filename.c_str());
+}
+#endif
+
 static GLuint compile_gl_shader(GLenum type,
                                 const std::string &name,
                                 const std::string &shader_string) {
@@ -56,25 +308,62 @@ Shader::Shader(RenderPass *render_pass,
                BlendMode blend_mode)
     : m_render_pass(render_pass), m_name(name), m_blend_mode(blend_mode), m_shader_handle(0) {
 
-    GLuint vertex_shader_handle   = compile_gl_shader(GL_VERTEX_SHADER,   name, vertex_shader),
-           fragment_shader_handle = compile_gl_shader(GL_FRAGMENT_SHADER, name, fragment_shader);
+    std::string cache_filename, driver;
+#if defined(NANOGUI_PROGRAM_BINARY)
+    if (!program_cache_dir.empty() && program_binary_supported()) {
+        driver = driver_string();
+        uint64_t hash = 0xcbf29ce484222325ull;
+        hash = fnv1a(hash, vertex_shader);
+        hash = fnv1a(hash, std::string(1, '\0'));
+        hash = fnv1a(hash, fragment_shader);
+        hash = fnv1a(hash, driver);
+
+        char hash_str[17];
+        snprintf(hash_str, sizeof(hash_str), "%016llx", (unsigned long long) hash);
+        cache_filename = program_cache_dir + "/" + hash_str + ".bin";
+
+        m_shader_handle = glCreateProgram();
+        if (load_program_binary(m_shader_handle, cache_filename, driver)) {
+            program_cache_stats_.hits++;
+        } else {
+            CHK(glDeleteProgram(m_shader_handle));
+            m_shader_handle = 0;
+        }
+    }
+#endif
 
-    m_shader_handle = glCreateProgram();
+    if (!m_shader_handle) {
+        GLuint vertex_shader_handle   = compile_gl_shader(GL_VERTEX_SHADER,   name, vertex_shader),
+               fragment_shader_handle = compile_gl_shader(GL_FRAGMENT_SHADER, name, fragment_shader);
 
-    GLint status;
-    CHK(glAttachShader(m_shader_handle, vertex_shader_handle));
-    CHK(glAttachShader(m_shader_handle, fragment_shader_handle));
-    CHK(glLinkProgram(m_shader_handle));
-    CHK(glDeleteShader(vertex_shader_handle));
-    CHK(glDeleteShader(fragment_shader_handle));
-    CHK(glGetProgramiv(m_shader_handle, GL_LINK_STATUS, &status));
+        m_shader_handle = glCreateProgram();
 
-    if (status != GL_TRUE) {
-        char error_shader[4096];
-        CHK(glGetProgramInfoLog(m_shader_handle, sizeof(error_shader), nullptr, error_shader));
-        m_shader_handle = 0;
-        throw std::runtime_error("Shader::Shader(name=\"" + name +
-                                 "\"): unable to link shader!\n\n" + error_shader);
+        GLint status;
+        CHK(glAttachShader(m_shader_handle, vertex_shader_handle));
+        CHK(glAttachShader(m_shader_handle, fragment_shader_handle));
+#if defined(NANOGUI_PROGRAM_BINARY)
+        if (!cache_filename.empty())
+            CHK(glProgramParameteri(m_shader_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+#endif
+        CHK(glLinkProgram(m_shader_handle));
+        CHK(glDeleteShader(vertex_shader_handle));
+        CHK(glDeleteShader(fragment_shader_handle));
+        CHK(glGetProgramiv(m_shader_handle, GL_LINK_STATUS, &status));
+
+        if (status != GL_TRUE) {
+            char error_shader[4096];
+            CHK(glGetProgramInfoLog(m_shader_handle, sizeof(error_shader), nullptr, error_shader));
+            m_shader_handle = 0;
+            throw std::runtime_error("Shader::Shader(name=\"" + name +
+                                     "\"): unable to link shader!\n\n" + error_shader);
+        }
+
+        if (!cache_filename.empty()) {
+            program_cache_stats_.misses++;
+#if defined(NANOGUI_PROGRAM_BINARY)
+            store_program_binary(m_shader_handle, cache_filename, driver);
+#endif
+        }
     }
 
     GLint attribute_count, uniform_count;
@@ -83,14 +372,11 @@ Shader::Shader(RenderPass *render_pass,
 
     auto register_buffer = [&](BufferType type, const std::string &name,
                                int index, GLenum gl_type) {
-        if (m_buffers.find(name) != m_buffers.end())
-            throw std::runtime_error(
-                "Shader::Shader(): duplicate attribute/uniform name in shader code!");
-        else if (name == "indices")
+        if (name == "indices")
             throw std::runtime_error(
                 "Shader::Shader(): argument name 'indices' is reserved!");
 
-        Buffer &buf = m_buffers[name];
+        Buffer &buf = add_binding(name);
         for (int i = 0; i < 3; ++i)
             buf.shape[i] = 1;
         buf.ndim = 1;
@@ -228,17 +514,78 @@ Shader::Shader(RenderPass *render_pass,
         register_buffer(VertexBuffer, attr_name, index, type);
     }
 
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    GLint block_count = 0;
+    CHK(glGetProgramiv(m_shader_handle, GL_ACTIVE_UNIFORM_BLOCKS, &block_count));
+
+    for (int i = 0; i < block_count; ++i) {
+        char block_name[128];
+        GLint data_size = 0;
+        CHK(glGetActiveUniformBlockName(m_shader_handle, (GLuint) i, sizeof(block_name),
+                                        nullptr, block_name));
+        CHK(glGetActiveUniformBlockiv(m_shader_handle, (GLuint) i,
+                                      GL_UNIFORM_BLOCK_DATA_SIZE, &data_size));
+
+        /* Block 'i' of each program uses binding point 'i', which begin()
+           points to the block's range in the uniform ring */
+        CHK(glUniformBlockBinding(m_shader_handle, (GLuint) i, (GLuint) i));
+
+        Block &block = m_blocks.emplace_back();
+        block.binding = (uint32_t) i;
+        block.data.resize((size_t) data_size, 0);
+
+        Buffer &buf = add_binding(block_name);
+        buf.type = UniformBlock;
+        buf.index = i;
+        buf.dtype = VariableType::UInt8;
+        buf.ndim = 1;
+        buf.shape[0] = (size_t) data_size;
+        buf.shape[1] = buf.shape[2] = 1;
+        buf.size = (size_t) data_size;
+        buf.buffer = block.data.data();
+        buf.persistent = true;
+    }
+
+    if (!m_blocks.empty()) {
+        auto it = __nanogui_screens.find(glfwGetCurrentContext());
+        if (it != __nanogui_screens.end())
+            m_uniform_ring = it->second->uniform_ring();
+        else
+            m_uniform_ring = new UniformRing();
+    }
+#endif
+
     for (int i = 0; i < uniform_count; ++i) {
         char uniform_name[128];
         GLenum type = 0;
         GLint size = 0;
         CHK(glGetActiveUniform(m_shader_handle, i, sizeof(uniform_name), nullptr,
                                &size, &type, uniform_name));
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+        GLuint uniform_index = (GLuint) i;
+        GLint block = -1, offset = 0, matrix_stride = 0;
+        CHK(glGetActiveUniformsiv(m_shader_handle, 1, &uniform_index,
+                                  GL_UNIFORM_BLOCK_INDEX, &block));
+        if (block >= 0) {
+            CHK(glGetActiveUniformsiv(m_shader_handle, 1, &uniform_index,
+                                      GL_UNIFORM_OFFSET, &offset));
+            CHK(glGetActiveUniformsiv(m_shader_handle, 1, &uniform_index,
+                                      GL_UNIFORM_MATRIX_STRIDE, &matrix_stride));
+            register_buffer(UniformBlockMember, uniform_name, -1, type);
+            Buffer &buf = m_buffers.back();
+            buf.block = (uint32_t) block;
+            buf.block_offset = (uint32_t) offset;
+            buf.matrix_stride = (uint32_t) matrix_stride;
+            continue;
+        }
+#endif
+
         GLint index = glGetUniformLocation(m_shader_handle, uniform_name);
         register_buffer(UniformBuffer, uniform_name, index, type);
     }
 
-    Buffer &buf = m_buffers["indices"];
+    Buffer &buf = add_binding("indices");
     buf.index = -1;
     buf.ndim = 1;
     buf.shape[0] = 0;
@@ -246,34 +593,76 @@ Shader::Shader(RenderPass *render_pass,
     buf.type = IndexBuffer;
     buf.dtype = VariableType::UInt32;
 
-#if defined(NANOGUI_USE_OPENGL)
+    /* Texture units are global state that begin() must rebind every time
+       (units are assigned once, in the order of the binding table). The
+       same holds for vertex attributes and the index buffer on GLES 2,
+       which lacks vertex array objects. */
+    int texture_unit = 0;
+    GLState &state = GLState::current();
+    state.use_program(m_shader_handle);
+    for (Buffer &b : m_buffers) {
+        if (b.type == FragmentTexture) {
+            CHK(glUniform1i(b.index, texture_unit++));
+            b.persistent = true;
+        }
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+        if (b.type == VertexBuffer || b.type == IndexBuffer)
+            b.persistent = true;
+#endif
+    }
+    state.use_program(0);
+    finalize_bindings();
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
     CHK(glGenVertexArrays(1, &m_vertex_array_handle));
+#endif
 
+#if defined(NANOGUI_USE_OPENGL)
     m_uses_point_size = vertex_shader.find("gl_PointSize") != std::string::npos;
 #endif
 }
 
 Shader::~Shader() {
+    unpin_textures();
+    for (const Buffer &buf : m_buffers) {
+        if (!(buf.type == VertexBuffer || buf.type == IndexBuffer) || !buf.buffer ||
+            buf.mapping != (uint32_t) -1)
+            continue;
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+        if (buf.divisor > 0) {
+            delete[] (uint8_t *) buf.buffer;
+            continue;
+        }
+#endif
+        GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
+        CHK(glDeleteBuffers(1, &buffer_id));
+    }
+    GLState &state = GLState::current();
+    state.program_deleted(m_shader_handle);
     CHK(glDeleteProgram(m_shader_handle));
 #if defined(NANOGUI_USE_OPENGL)
+    for (Mapping &m : m_mappings)
+        release_mapping(m.buffer, m.data, m.fences, 3);
+#endif
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    state.vertex_array_deleted(m_vertex_array_handle);
     CHK(glDeleteVertexArrays(1, &m_vertex_array_handle));
 #endif
 }
 
-void Shader::set_buffer(const std::string &name,
+void Shader::set_buffer(BindingHandle binding,
                         VariableType dtype,
                         size_t ndim,
                         const size_t *shape,
                         const void *data) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+    Buffer &buf = buffer(binding, "set_buffer");
+    if (buf.type == UniformBlock || buf.type == VertexTexture || buf.type == FragmentTexture)
         throw std::runtime_error(
-            "Shader::set_buffer(): could not find argument named \"" + name + "\"");
-
-    Buffer &buf = m_buffers[name];
+            "Shader::set_buffer(): argument named \"" + buf.name + "\" is not a buffer!");
 
+    bool uniform = buf.type == UniformBuffer || buf.type == UniformBlockMember;
     bool mismatch = ndim != buf.ndim || dtype != buf.dtype;
-    for (size_t i = (buf.type == UniformBuffer ? 0 : 1); i < ndim; ++i)
+    for (size_t i = (uniform ? 0 : 1); i < ndim; ++i)
         mismatch |= shape[i] != buf.shape[i];
 
     if (mismatch) {
@@ -283,7 +672,7 @@ void Shader::set_buffer(const std::string &name,
         for (size_t i = 0; i < 3; ++i)
             arg.shape[i] = i < arg.ndim ? shape[i] : 1;
         arg.dtype = dtype;
-        throw std::runtime_error("Buffer::set_buffer(\"" + name +
+        throw std::runtime_error("Buffer::set_buffer(\"" + buf.name +
                                  "\"): shape/dtype mismatch: expected " + buf.to_string() +
                                  ", got " + arg.to_string());
     }
@@ -294,7 +683,14 @@ void Shader::set_buffer(const std::string &name,
         size *= buf.shape[i];
     }
 
-    if (buf.type == UniformBuffer) {
+    /* GLES 2 lacks instancing: per-instance attributes stay in CPU memory
+       (see draw_array_instanced()) */
+    bool host_buffer = buf.type == UniformBuffer;
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    host_buffer |= buf.type == VertexBuffer && buf.divisor > 0;
+#endif
+
+    if (host_buffer) {
         if (buf.buffer && buf.size != size) {
             delete[] (uint8_t *) buf.buffer;
             buf.buffer = nullptr;
@@ -302,7 +698,42 @@ void Shader::set_buffer(const std::string &name,
         if (!buf.buffer)
             buf.buffer = new uint8_t[size];
         memcpy(buf.buffer, data, size);
-    } else {
+    } else if (buf.type == UniformBlockMember) {
+        /* std140 layout: each component occupies 4 bytes (including
+           booleans), and matrix columns are 'matrix_stride' bytes apart */
+        Block &block = m_blocks[buf.block];
+        uint8_t *dst = block.data.data() + buf.block_offset;
+        size_t rows = buf.ndim == 2 ? buf.shape[1] : buf.shape[0],
+               cols = buf.ndim == 2 ? buf.shape[0] : 1;
+        for (size_t c = 0; c < cols; ++c) {
+            for (size_t r = 0; r < rows; ++r) {
+                uint32_t value;
+                if (dtype == VariableType::Bool)
+                    value = ((const uint8_t *) data)[c * rows + r];
+                else
+                    memcpy(&value, (const uint8_t *) data + (c * rows + r) * 4, 4);
+                memcpy(dst + c * buf.matrix_stride + r * 4, &value, 4);
+            }
+        }
+        buf.buffer = dst;
+        block.dirty = true;
+    }
+#if defined(NANOGUI_USE_OPENGL)
+    else if (buf.usage == BufferUsage::Persistent && buffer_storage_supported()) {
+        upload_mapped(buf, size, data);
+    }
+#endif
+    else {
+#if defined(NANOGUI_USE_OPENGL)
+        /* The usage hint changed from BufferUsage::Persistent */
+        if (buf.mapping != (uint32_t) -1) {
+            Mapping &m = m_mappings[buf.mapping];
+            release_mapping(m.buffer, m.data, m.fences, 3);
+            buf.mapping = (uint32_t) -1;
+            buf.buffer = nullptr;
+        }
+#endif
+        bool reuse = buf.buffer && buf.size == size;
         GLuint buffer_id = 0;
         if (buf.buffer) {
             buffer_id = (GLuint) ((uintptr_t) buf.buffer);
@@ -310,233 +741,424 @@ void Shader::set_buffer(const std::string &name,
             CHK(glGenBuffers(1, &buffer_id));
             buf.buffer = (void *) ((uintptr_t) buffer_id);
         }
-        GLenum buf_type = (name == "indices")
-            ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+        GLenum buf_type = buf.type == IndexBuffer
+            ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER,
+               usage = gl_buffer_usage(buf.usage);
         CHK(glBindBuffer(buf_type, buffer_id));
-        CHK(glBufferData(buf_type, size, data, GL_DYNAMIC_DRAW));
+        if (!reuse) {
+            CHK(glBufferData(buf_type, size, data, usage));
+        } else if (buf.usage == BufferUsage::Static || buf.usage == BufferUsage::Dynamic) {
+            CHK(glBufferSubData(buf_type, 0, size, data));
+        } else {
+            /* Orphan the storage, so that the driver need not wait for
+               draw calls that still read the previous contents */
+            CHK(glBufferData(buf_type, size, nullptr, usage));
+            CHK(glBufferSubData(buf_type, 0, size, data));
+        }
     }
 
     buf.dtype = dtype;
     buf.ndim  = ndim;
     buf.size  = size;
-    buf.dirty = true;
+    if (buf.type != UniformBlockMember)
+        mark_dirty(buf);
+}
+
+void Shader::set_uniform_block(BindingHandle binding, const void *data, size_t size) {
+    Buffer &buf = buffer(binding, "set_uniform_block");
+    if (buf.type != UniformBlock)
+        throw std::runtime_error("Shader::set_uniform_block(): argument named \"" +
+                                 buf.name + "\" is not a uniform block!");
+
+    Block &block = m_blocks[buf.index];
+    if (size != block.data.size())
+        throw std::runtime_error("Shader::set_uniform_block(\"" + buf.name +
+                                 "\"): size mismatch: expected " +
+                                 std::to_string(block.data.size()) + " bytes, got " +
+                                 std::to_string(size));
+
+    memcpy(block.data.data(), data, size);
+    block.dirty = true;
 }
 
-void Shader::set_texture(const std::string &name, Texture *texture) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+void Shader::update_buffer_range(BindingHandle binding, size_t offset,
+                                 size_t count, const void *data) {
+    Buffer &buf = buffer(binding, "update_buffer_range");
+    if (!(buf.type == VertexBuffer || buf.type == IndexBuffer) || !buf.buffer)
         throw std::runtime_error(
-            "Shader::set_texture(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+            "Shader::update_buffer_range(): argument named \"" + buf.name +
+            "\" is not an uploaded vertex or index buffer!");
+
+    if (offset + count > buf.shape[0])
+        throw std::runtime_error(
+            "Shader::update_buffer_range(\"" + buf.name + "\"): range [" +
+            std::to_string(offset) + ", " + std::to_string(offset + count) +
+            ") is out of bounds for " + buf.to_string());
+
+    if (count == 0)
+        return;
+
+    size_t entry_size = buf.size / buf.shape[0];
+
+#if defined(NANOGUI_USE_OPENGL)
+    if (buf.mapping != (uint32_t) -1) {
+        memcpy(m_mappings[buf.mapping].data + buffer_offset(buf) + offset * entry_size,
+               data, count * entry_size);
+        return;
+    }
+#elif NANOGUI_GLES_VERSION == 2
+    if (buf.divisor > 0) {
+        memcpy((uint8_t *) buf.buffer + offset * entry_size, data, count * entry_size);
+        return;
+    }
+#endif
+
+    GLenum buf_type = buf.type == IndexBuffer
+        ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    CHK(glBindBuffer(buf_type, (GLuint) ((uintptr_t) buf.buffer)));
+    CHK(glBufferSubData(buf_type, (GLintptr) (offset * entry_size),
+                        (GLsizeiptr) (count * entry_size), data));
+}
+
+void Shader::set_buffer_divisor(BindingHandle binding, uint32_t divisor) {
+    Buffer &buf = buffer(binding, "set_buffer_divisor");
+    if (buf.type != VertexBuffer)
+        throw std::runtime_error("Shader::set_buffer_divisor(): argument named \"" +
+                                 buf.name + "\" is not a vertex buffer!");
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    if (buf.buffer && (buf.divisor > 0) != (divisor > 0))
+        throw std::runtime_error("Shader::set_buffer_divisor(\"" + buf.name +
+                                 "\"): must be called before set_buffer()!");
+#endif
+    buf.divisor = divisor;
+    if (buf.buffer)
+        mark_dirty(buf);
+}
+
+void Shader::set_texture(BindingHandle binding, Texture *texture) {
+    Buffer &buf = buffer(binding, "set_texture");
     if (!(buf.type == VertexTexture || buf.type == FragmentTexture))
         throw std::runtime_error(
-            "Shader::set_texture(): argument named \"" + name + "\" is not a texture!");
+            "Shader::set_texture(): argument named \"" + buf.name + "\" is not a texture!");
 
-    buf.buffer = (void *) ((uintptr_t) texture->texture_handle());
-    buf.dirty  = true;
+    buf.buffer  = (void *) ((uintptr_t) texture->texture_handle());
+    buf.texture = texture;
 }
 
 void Shader::begin() {
+    GLState &state = GLState::current();
+    state.use_program(m_shader_handle);
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    state.bind_vertex_array(m_vertex_array_handle);
+#endif
+
+    if (!m_bindings_complete)
+        check_bindings();
+
+    if (!m_blocks.empty())
+        upload_blocks();
+
+    pin_textures();
+
     int texture_unit = 0;
+    for (uint32_t index : m_persistent) {
+        Buffer &buf = m_buffers[index];
+        bool texture = buf.type == VertexTexture || buf.type == FragmentTexture;
+        if (buf.buffer)
+            apply_binding(buf, texture_unit);
+        if (texture)
+            texture_unit++;
+    }
+
+    for (uint32_t index : m_dirty) {
+        Buffer &buf = m_buffers[index];
+        apply_binding(buf);
+        buf.dirty = false;
+    }
+    m_dirty.clear();
 
-    CHK(glUseProgram(m_shader_handle));
+    /* Blending and point sizes are set (rather than toggled and reverted by
+       end()), so that consecutive draws with the same shader are free */
+    state.set_blend(m_blend_mode == BlendMode::AlphaBlend);
+    if (m_blend_mode == BlendMode::AlphaBlend)
+        state.set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 #if defined(NANOGUI_USE_OPENGL)
-    CHK(glBindVertexArray(m_vertex_array_handle));
+    state.set_program_point_size(m_uses_point_size);
 #endif
+}
 
-    for (auto &[key, buf] : m_buffers) {
-        bool indices = key == "indices";
-        if (!buf.buffer) {
-            if (!indices)
-                fprintf(stderr,
-                        "Shader::begin(): shader \"%s\" has an unbound "
-                        "argument \"%s\"!\n",
-                        m_name.c_str(), key.c_str());
-            continue;
+void Shader::upload_blocks() {
+    /* Orphaning the ring storage invalidates the ranges of all blocks,
+       including the ones of this shader that were just uploaded */
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        uint64_t generation = m_uniform_ring->generation();
+        for (Block &block : m_blocks) {
+            if (!block.dirty && block.generation == m_uniform_ring->generation())
+                continue;
+            block.offset = m_uniform_ring->push(block.data.data(), block.data.size());
+            block.generation = m_uniform_ring->generation();
+            block.dirty = false;
         }
+        if (m_uniform_ring->generation() == generation)
+            break;
+    }
 
-        GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
-        GLenum gl_type = 0;
+    /* Copy all blocks into the ring at once */
+    m_uniform_ring->flush();
+}
 
+size_t Shader::buffer_offset(const Buffer &buf) const {
 #if defined(NANOGUI_USE_OPENGL)
-        if (!buf.dirty && buf.type != VertexTexture && buf.type != FragmentTexture)
-            continue;
+    if (buf.mapping != (uint32_t) -1) {
+        const Mapping &m = m_mappings[buf.mapping];
+        return m.region * m.region_size;
+    }
 #endif
+    (void) buf;
+    return 0;
+}
 
-        bool uniform_error = false;
-        switch (buf.type) {
-            case IndexBuffer:
-                CHK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer_id));
-                break;
+#if defined(NANOGUI_USE_OPENGL)
+void Shader::upload_mapped(Buffer &buf, size_t size, const void *data) {
+    GLenum buf_type = buf.type == IndexBuffer
+        ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
 
-            case VertexBuffer:
-                CHK(glBindBuffer(GL_ARRAY_BUFFER, buffer_id));
-                CHK(glEnableVertexAttribArray(buf.index));
-
-                switch (buf.dtype) {
-                    case VariableType::Int8:    gl_type = GL_BYTE;           break;
-                    case VariableType::UInt8:   gl_type = GL_UNSIGNED_BYTE;  break;
-                    case VariableType::Int16:   gl_type = GL_SHORT;          break;
-                    case VariableType::UInt16:  gl_type = GL_UNSIGNED_SHORT; break;
-                    case VariableType::Int32:   gl_type = GL_INT;            break;
-                    case VariableType::UInt32:  gl_type = GL_UNSIGNED_INT;   break;
-                    case VariableType::Float16: gl_type = GL_HALF_FLOAT;     break;
-                    case VariableType::Float32: gl_type = GL_FLOAT;          break;
-                    default:
-                        throw std::runtime_error(
-                            "Shader::begin(): unsupported vertex buffer type!");
-                }
-
-                if (buf.ndim != 2)
-                    throw std::runtime_error("\"" + m_name + "\": vertex attribute \"" + key +
-                                             "\" has an invalid shapeension (expected ndim=2, got " +
-                                             std::to_string(buf.ndim) + ")");
-
-                CHK(glVertexAttribPointer(buf.index, (GLint) buf.shape[1],
-                                          gl_type, GL_FALSE, 0, nullptr));
-                break;
+    /* The usage hint changed to BufferUsage::Persistent */
+    if (buf.buffer && buf.mapping == (uint32_t) -1) {
+        GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
+        CHK(glDeleteBuffers(1, &buffer_id));
+        buf.buffer = nullptr;
+    }
+
+    if (buf.mapping == (uint32_t) -1) {
+        buf.mapping = (uint32_t) m_mappings.size();
+        m_mappings.emplace_back();
+    }
+
+    Mapping &m = m_mappings[buf.mapping];
+    if (m.data && m.region_size < size)
+        release_mapping(m.buffer, m.data, m.fences, 3);
+
+    if (!m.data) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        m.region_size = std::max(size, (size_t) 1);
+        m.region = 0;
+        CHK(glGenBuffers(1, &m.buffer));
+        CHK(glBindBuffer(buf_type, m.buffer));
+        CHK(glBufferStorage(buf_type, (GLsizeiptr) (m.region_size * 3), nullptr, flags));
+        m.data = (uint8_t *) glMapBufferRange(buf_type, 0, (GLsizeiptr) (m.region_size * 3),
+                                              flags);
+        if (!m.data) {
+            release_mapping(m.buffer, m.data, m.fences, 3);
+            throw std::runtime_error("Shader::set_buffer(\"" + buf.name +
+                                     "\"): could not map the buffer!");
+        }
+    } else {
+        /* Advance to the next copy, waiting for draw calls that read it */
+        m.region = (m.region + 1) % 3;
+        wait_fence(m.fences[m.region]);
+    }
 
-            case VertexTexture:
-            case FragmentTexture:
-                CHK(glActiveTexture(GL_TEXTURE0 + texture_unit));
-                CHK(glBindTexture(GL_TEXTURE_2D, (GLuint) ((uintptr_t) buf.buffer)));
-                if (buf.dirty)
-                    CHK(glUniform1i(buf.index, texture_unit));
-                texture_unit++;
+    memcpy(m.data + m.region * m.region_size, data, size);
+    buf.buffer = (void *) ((uintptr_t) m.buffer);
+}
+#endif
+
+void Shader::apply_binding(Buffer &buf, int texture_unit) {
+    GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
+    GLenum gl_type = 0;
+
+    bool uniform_error = false;
+    switch (buf.type) {
+        case IndexBuffer:
+            CHK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer_id));
+            break;
+
+        case VertexBuffer:
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+            /* Set per instance by draw_array_instanced() */
+            if (buf.divisor > 0) {
+                CHK(glDisableVertexAttribArray(buf.index));
                 break;
+            }
+#endif
+            CHK(glBindBuffer(GL_ARRAY_BUFFER, buffer_id));
+            CHK(glEnableVertexAttribArray(buf.index));
+
+            switch (buf.dtype) {
+                case VariableType::Int8:    gl_type = GL_BYTE;           break;
+                case VariableType::UInt8:   gl_type = GL_UNSIGNED_BYTE;  break;
+                case VariableType::Int16:   gl_type = GL_SHORT;          break;
+                case VariableType::UInt16:  gl_type = GL_UNSIGNED_SHORT; break;
+                case VariableType::Int32:   gl_type = GL_INT;            break;
+                case VariableType::UInt32:  gl_type = GL_UNSIGNED_INT;   break;
+                case VariableType::Float16: gl_type = GL_HALF_FLOAT;     break;
+                case VariableType::Float32: gl_type = GL_FLOAT;          break;
+                default:
+                    throw std::runtime_error(
+                        "Shader::begin(): unsupported vertex buffer type!");
+            }
+
+            if (buf.ndim != 2)
+                throw std::runtime_error("\"" + m_name + "\": vertex attribute \"" + buf.name +
+                                         "\" has an invalid shapeension (expected ndim=2, got " +
+                                         std::to_string(buf.ndim) + ")");
 
-            case UniformBuffer:
-                if (buf.ndim > 2)
-                    throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + key +
-                                             "\" has an invalid shapeension (expected ndim=0/1/2, got " +
-                                             std::to_string(buf.ndim) + ")");
-                switch (buf.dtype) {
-                    case VariableType::Float32:
+            CHK(glVertexAttribPointer(buf.index, (GLint) buf.shape[1],
+                                      gl_type, GL_FALSE, 0,
+                                      (const void *) buffer_offset(buf)));
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+            CHK(glVertexAttribDivisor(buf.index, buf.divisor));
+#endif
+            break;
+
+        case VertexTexture:
+        case FragmentTexture:
+            GLState::current().bind_texture(texture_unit, GL_TEXTURE_2D, buffer_id);
+            break;
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+        case UniformBlock: {
+                const Block &block = m_blocks[buf.index];
+                CHK(glBindBufferRange(GL_UNIFORM_BUFFER, block.binding,
+                                      m_uniform_ring->buffer_handle(),
+                                      (GLintptr) block.offset,
+                                      (GLsizeiptr) block.data.size()));
+            }
+            break;
+#endif
+
+        case UniformBuffer:
+            if (buf.ndim > 2)
+                throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + buf.name +
+                                         "\" has an invalid shapeension (expected ndim=0/1/2, got " +
+                                         std::to_string(buf.ndim) + ")");
+            switch (buf.dtype) {
+                case VariableType::Float32:
+                    if (buf.ndim < 2) {
+                        const float *v = (const float *) buf.buffer;
+                        switch (buf.shape[0]) {
+                            case 1: CHK(glUniform1f(buf.index, v[0])); break;
+                            case 2: CHK(glUniform2f(buf.index, v[0], v[1])); break;
+                            case 3: CHK(glUniform3f(buf.index, v[0], v[1], v[2])); break;
+                            case 4: CHK(glUniform4f(buf.index, v[0], v[1], v[2], v[3])); break;
+                            default: uniform_error = true; break;
+                        }
+                    } else if (buf.ndim == 2 && buf.shape[0] == buf.shape[1]) {
+                        const float *v = (const float *) buf.buffer;
+                        switch (buf.shape[0]) {
+                            case 2: CHK(glUniformMatrix2fv(buf.index, 1, GL_FALSE, v)); break;
+                            case 3: CHK(glUniformMatrix3fv(buf.index, 1, GL_FALSE, v)); break;
+                            case 4: CHK(glUniformMatrix4fv(buf.index, 1, GL_FALSE, v)); break;
+                            default: uniform_error = true; break;
+                        }
+                    } else {
+                        uniform_error = true;
+                    }
+                    break;
+
+#if defined(NANOGUI_USE_GLES)
+                case VariableType::UInt32:
+#endif
+                case VariableType::Int32: {
+                        const int32_t *v = (const int32_t *) buf.buffer;
                         if (buf.ndim < 2) {
-                            const float *v = (const float *) buf.buffer;
                             switch (buf.shape[0]) {
-                                case 1: CHK(glUniform1f(buf.index, v[0])); break;
-                                case 2: CHK(glUniform2f(buf.index, v[0], v[1])); break;
-                                case 3: CHK(glUniform3f(buf.index, v[0], v[1], v[2])); break;
-                                case 4: CHK(glUniform4f(buf.index, v[0], v[1], v[2], v[3])); break;
-                                default: uniform_error = true; break;
-                            }
-                        } else if (buf.ndim == 2 && buf.shape[0] == buf.shape[1]) {
-                            const float *v = (const float *) buf.buffer;
-                            switch (buf.shape[0]) {
-                                case 2: CHK(glUniformMatrix2fv(buf.index, 1, GL_FALSE, v)); break;
-                                case 3: CHK(glUniformMatrix3fv(buf.index, 1, GL_FALSE, v)); break;
-                                case 4: CHK(glUniformMatrix4fv(buf.index, 1, GL_FALSE, v)); break;
+                                case 1: CHK(glUniform1i(buf.index, v[0])); break;
+                                case 2: CHK(glUniform2i(buf.index, v[0], v[1])); break;
+                                case 3: CHK(glUniform3i(buf.index, v[0], v[1], v[2])); break;
+                                case 4: CHK(glUniform4i(buf.index, v[0], v[1], v[2], v[3])); break;
                                 default: uniform_error = true; break;
                             }
                         } else {
                             uniform_error = true;
                         }
-                        break;
-
-#if defined(NANOGUI_USE_GLES)
-                    case VariableType::UInt32:
-#endif
-                    case VariableType::Int32: {
-                            const int32_t *v = (const int32_t *) buf.buffer;
-                            if (buf.ndim < 2) {
-                                switch (buf.shape[0]) {
-                                    case 1: CHK(glUniform1i(buf.index, v[0])); break;
-                                    case 2: CHK(glUniform2i(buf.index, v[0], v[1])); break;
-                                    case 3: CHK(glUniform3i(buf.index, v[0], v[1], v[2])); break;
-                                    case 4: CHK(glUniform4i(buf.index, v[0], v[1], v[2], v[3])); break;
-                                    default: uniform_error = true; break;
-                                }
-                            } else {
-                                uniform_error = true;
-                            }
-                        }
-                        break;
+                    }
+                    break;
 
 #if defined(NANOGUI_USE_OPENGL)
-                    case VariableType::UInt32: {
-                            const uint32_t *v = (const uint32_t *) buf.buffer;
-                            if (buf.ndim < 2) {
-                                switch (buf.shape[0]) {
-                                    case 1: CHK(glUniform1ui(buf.index, v[0])); break;
-                                    case 2: CHK(glUniform2ui(buf.index, v[0], v[1])); break;
-                                    case 3: CHK(glUniform3ui(buf.index, v[0], v[1], v[2])); break;
-                                    case 4: CHK(glUniform4ui(buf.index, v[0], v[1], v[2], v[3])); break;
-                                    default: uniform_error = true; break;
-                                }
-                            } else {
-                                uniform_error = true;
+                case VariableType::UInt32: {
+                        const uint32_t *v = (const uint32_t *) buf.buffer;
+                        if (buf.ndim < 2) {
+                            switch (buf.shape[0]) {
+                                case 1: CHK(glUniform1ui(buf.index, v[0])); break;
+                                case 2: CHK(glUniform2ui(buf.index, v[0], v[1])); break;
+                                case 3: CHK(glUniform3ui(buf.index, v[0], v[1], v[2])); break;
+                                case 4: CHK(glUniform4ui(buf.index, v[0], v[1], v[2], v[3])); break;
+                                default: uniform_error = true; break;
                             }
+                        } else {
+                            uniform_error = true;
                         }
-                        break;
-#endif
-
-                    case VariableType::Bool: {
-                            const uint8_t *v = (const uint8_t *) buf.buffer;
-                            if (buf.ndim < 2) {
-                                switch (buf.shape[0]) {
-                                    case 1: CHK(glUniform1i(buf.index, v[0])); break;
-                                    case 2: CHK(glUniform2i(buf.index, v[0], v[1])); break;
-                                    case 3: CHK(glUniform3i(buf.index, v[0], v[1], v[2])); break;
-                                    case 4: CHK(glUniform4i(buf.index, v[0], v[1], v[2], v[3])); break;
-                                    default: uniform_error = true; break;
-                                }
-                            } else {
-                                uniform_error = true;
+                    }
+                    break;
+#endif
+
+                case VariableType::Bool: {
+                        const uint8_t *v = (const uint8_t *) buf.buffer;
+                        if (buf.ndim < 2) {
+                            switch (buf.shape[0]) {
+                                case 1: CHK(glUniform1i(buf.index, v[0])); break;
+                                case 2: CHK(glUniform2i(buf.index, v[0], v[1])); break;
+                                case 3: CHK(glUniform3i(buf.index, v[0], v[1], v[2])); break;
+                                case 4: CHK(glUniform4i(buf.index, v[0], v[1], v[2], v[3])); break;
+                                default: uniform_error = true; break;
                             }
+                        } else {
+                            uniform_error = true;
                         }
-                        break;
-
-                    default:
-                        uniform_error = true;
-                        break;
-                }
+                    }
+                    break;
 
-                if (uniform_error)
-                    throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + key +
-                                             "\" has an unsupported dtype/shape configuration: " + buf.to_string());
-                break;
-
-            default:
-                throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + key +
-                                         "\" has an unsupported dtype/shape configuration:" + buf.to_string());
-        }
+                default:
+                    uniform_error = true;
+                    break;
+            }
 
-        buf.dirty = false;
-    }
+            if (uniform_error)
+                throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + buf.name +
+                                         "\" has an unsupported dtype/shape configuration: " + buf.to_string());
+            break;
 
-    if (m_blend_mode == BlendMode::AlphaBlend) {
-        CHK(glEnable(GL_BLEND));
-        CHK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        default:
+            throw std::runtime_error("\"" + m_name + "\": uniform attribute \"" + buf.name +
+                                     "\" has an unsupported dtype/shape configuration:" + buf.to_string());
     }
-
-#if defined(NANOGUI_USE_OPENGL)
-    if (m_uses_point_size)
-        CHK(glEnable(GL_PROGRAM_POINT_SIZE));
-#endif
 }
 
 void Shader::end() {
-    if (m_blend_mode == BlendMode::AlphaBlend)
-        CHK(glDisable(GL_BLEND));
 #if defined(NANOGUI_USE_OPENGL)
-    if (m_uses_point_size)
-        CHK(glDisable(GL_PROGRAM_POINT_SIZE));
-    CHK(glBindVertexArray(0));
+    /* Fence the copies of persistently mapped buffers used by this shader */
+    for (Mapping &m : m_mappings) {
+        if (!m.data)
+            continue;
+        if (m.fences[m.region])
+            CHK(glDeleteSync((GLsync) m.fences[m.region]));
+        m.fences[m.region] = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /* Unbind the vertex array, since set_buffer() modifies the index buffer
+       binding. The program stays bound until another shader replaces it. */
+    GLState::current().bind_vertex_array(0);
 #else
-    for (const auto &[key, buf] : m_buffers) {
+    for (const Buffer &buf : m_buffers) {
         if (buf.type != VertexBuffer)
             continue;
         CHK(glDisableVertexAttribArray(buf.index));
     }
 #endif
-    CHK(glUseProgram(0));
+
+    unpin_textures();
 }
 
-void Shader::draw_array(PrimitiveType primitive_type,
-                        size_t offset, size_t count,
-                        bool indexed) {
+void Shader::draw_array_instanced(PrimitiveType primitive_type,
+                                  size_t offset, size_t count,
+                                  size_t instance_count,
+                                  bool indexed) {
     GLenum primitive_type_gl;
     switch (primitive_type) {
         case PrimitiveType::Point:         primitive_type_gl = GL_POINTS;         break;
@@ -547,11 +1169,172 @@ void Shader::draw_array(PrimitiveType primitive_type,
         default: throw std::runtime_error("Shader::draw_array(): invalid primitive type!");
     }
 
-    if (!indexed)
-        CHK(glDrawArrays(primitive_type_gl, (GLint) offset, (GLsizei) count));
-    else
-        CHK(glDrawElements(primitive_type_gl, (GLsizei) count, GL_UNSIGNED_INT,
-                           (const void *) (offset * sizeof(uint32_t))));
+    const void *index_offset =
+        (const void *) (offset * sizeof(uint32_t) + buffer_offset(m_buffers[m_indices]));
+
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    /* Draw the instances one by one, and pass per-instance attributes as
+       constant vertex attributes */
+    for (size_t i = 0; i < instance_count; ++i) {
+        for (const Buffer &buf : m_buffers) {
+            if (buf.type != VertexBuffer || buf.divisor == 0 || !buf.buffer)
+                continue;
+            size_t entry = std::min(i / buf.divisor, buf.shape[0] - 1);
+            const float *v = (const float *) buf.buffer + entry * buf.shape[1];
+            switch (buf.shape[1]) {
+                case 1: CHK(glVertexAttrib1fv(buf.index, v)); break;
+                case 2: CHK(glVertexAttrib2fv(buf.index, v)); break;
+                case 3: CHK(glVertexAttrib3fv(buf.index, v)); break;
+                case 4: CHK(glVertexAttrib4fv(buf.index, v)); break;
+                default: break;
+            }
+        }
+
+        if (!indexed)
+            CHK(glDrawArrays(primitive_type_gl, (GLint) offset, (GLsizei) count));
+        else
+            CHK(glDrawElements(primitive_type_gl, (GLsizei) count, GL_UNSIGNED_INT,
+                               index_offset));
+    }
+#else
+    if (instance_count == 0)
+        return;
+
+    if (instance_count == 1) {
+        if (!indexed)
+            CHK(glDrawArrays(primitive_type_gl, (GLint) offset, (GLsizei) count));
+        else
+            CHK(glDrawElements(primitive_type_gl, (GLsizei) count, GL_UNSIGNED_INT,
+                               index_offset));
+    } else {
+        if (!indexed)
+            CHK(glDrawArraysInstanced(primitive_type_gl, (GLint) offset, (GLsizei) count,
+                                      (GLsizei) instance_count));
+        else
+            CHK(glDrawElementsInstanced(primitive_type_gl, (GLsizei) count, GL_UNSIGNED_INT,
+                                        index_offset, (GLsizei) instance_count));
+    }
+#endif
+}
+
+UniformRing::UniformRing(size_t size) : m_size(size) {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    GLint alignment = 0;
+    CHK(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    if (alignment > 0)
+        m_alignment = (size_t) alignment;
+
+    CHK(glGenBuffers(1, &m_buffer_handle));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer_handle));
+#if defined(NANOGUI_USE_OPENGL)
+    if (buffer_storage_supported()) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        CHK(glBufferStorage(GL_UNIFORM_BUFFER, (GLsizeiptr) m_size, nullptr, flags));
+        m_data = (uint8_t *) glMapBufferRange(GL_UNIFORM_BUFFER, 0, (GLsizeiptr) m_size, flags);
+        if (!m_data) {
+            CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+            release_mapping(m_buffer_handle, m_data, m_fences, 3);
+            throw std::runtime_error("UniformRing::UniformRing(): could not map "
+                                     "the uniform buffer!");
+        }
+    } else
+#endif
+    CHK(glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr) m_size, nullptr, GL_STREAM_DRAW));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+#else
+    throw std::runtime_error("UniformRing::UniformRing(): uniform buffers require "
+                             "OpenGL or GLES 3!");
+#endif
+}
+
+UniformRing::~UniformRing() {
+#if defined(NANOGUI_USE_OPENGL)
+    if (m_data) {
+        release_mapping(m_buffer_handle, m_data, m_fences, 3);
+        return;
+    }
+#endif
+    CHK(glDeleteBuffers(1, &m_buffer_handle));
+}
+
+size_t UniformRing::push(const void *data, size_t size) {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    size_t offset = (m_offset + m_alignment - 1) / m_alignment * m_alignment;
+
+#if defined(NANOGUI_USE_OPENGL)
+    if (m_data) {
+        size_t region_size = m_size / 3 / m_alignment * m_alignment;
+        if (size > region_size)
+            throw std::runtime_error("UniformRing::push(): data exceeds a third of the ring!");
+
+        if (offset + size > (m_region + 1) * region_size) {
+            /* Fence the current third, and move on to the next one once the
+               GPU has finished reading it */
+            m_fences[m_region] = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_region = (m_region + 1) % 3;
+            wait_fence(m_fences[m_region]);
+            offset = m_region * region_size;
+            m_generation++;
+        }
+
+        memcpy(m_data + offset, data, size);
+        m_offset = offset + size;
+        return offset;
+    }
+#endif
+
+    if (size > m_size)
+        throw std::runtime_error("UniformRing::push(): data exceeds the size of the ring!");
+
+    if (offset + size > m_size) {
+        /* Orphan the storage: draw calls that are still pending keep using
+           the previous one. Staged data is dropped, since the generation
+           change invalidates its offsets. */
+        CHK(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer_handle));
+        CHK(glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr) m_size, nullptr, GL_STREAM_DRAW));
+        CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+        m_staging.clear();
+        offset = 0;
+        m_generation++;
+    }
+
+    if (m_staging.empty())
+        m_flush_offset = offset;
+    m_staging.resize(offset + size - m_flush_offset);
+    memcpy(m_staging.data() + (offset - m_flush_offset), data, size);
+
+    m_offset = offset + size;
+    return offset;
+#else
+    (void) data; (void) size;
+    throw std::runtime_error("UniformRing::push(): uniform buffers require "
+                             "OpenGL or GLES 3!");
+#endif
+}
+
+void UniformRing::flush() {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /* Persistently mapped storage is coherent, hence there is nothing to do */
+    if (m_staging.empty())
+        return;
+
+    /* Ranges are never reused before the storage is orphaned, hence there
+       is no need to synchronize with the GPU */
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer_handle));
+    void *ptr = glMapBufferRange(GL_UNIFORM_BUFFER, (GLintptr) m_flush_offset,
+                                 (GLsizeiptr) m_staging.size(),
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                 GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!ptr) {
+        CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+        m_staging.clear();
+        throw std::runtime_error("UniformRing::flush(): could not map the uniform buffer!");
+    }
+    memcpy(ptr, m_staging.data(), m_staging.size());
+    CHK(glUnmapBuffer(GL_UNIFORM_BUFFER));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    m_staging.clear();
+#endif
 }
 
 NAMESPACE_END(nanogui)
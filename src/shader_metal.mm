@@ -140,15 +140,11 @@ Shader::Shader(RenderPass *render_pass,
 
     for (MTLArgument *arg in [reflection vertexArguments]) {
         std::string name = [arg.name UTF8String];
-        if (m_buffers.find(name) != m_buffers.end())
-            throw std::runtime_error(
-                "Shader::Shader(): \"" + name +
-                "\": duplicate argument name in shader code!");
-        else if (name == "indices")
+        if (name == "indices")
             throw std::runtime_error(
                 "Shader::Shader(): argument name 'indices' is reserved!");
 
-        Buffer &buf = m_buffers[name];
+        Buffer &buf = add_binding(name);
         buf.index = arg.index;
         if (arg.type == MTLArgumentTypeBuffer)
             buf.type = VertexBuffer;
@@ -163,15 +159,11 @@ Shader::Shader(RenderPass *render_pass,
 
     for (MTLArgument *arg in [reflection fragmentArguments]) {
         std::string name = [arg.name UTF8String];
-        if (m_buffers.find(name) != m_buffers.end())
-            throw std::runtime_error(
-                "Shader::Shader(): \"" + name +
-                "\": duplicate argument name in shader code!");
-        else if (name == "indices")
+        if (name == "indices")
             throw std::runtime_error(
                 "Shader::Shader(): argument name 'indices' is reserved!");
 
-        Buffer &buf = m_buffers[name];
+        Buffer &buf = add_binding(name);
         buf.index = arg.index;
         if (arg.type == MTLArgumentTypeBuffer)
             buf.type = FragmentBuffer;
@@ -184,13 +176,34 @@ Shader::Shader(RenderPass *render_pass,
                                      "\": unsupported argument type!");
     }
 
-    Buffer &buf = m_buffers["indices"];
+    Buffer &buf = add_binding("indices");
     buf.index = -1;
     buf.type = IndexBuffer;
+
+    /* The state of a command encoder is overwritten by other shaders, hence
+       begin() reapplies all parameters. Samplers are resolved now so that
+       set_texture() can update them without a string lookup. */
+    for (Buffer &b : m_buffers) {
+        b.persistent = true;
+        if (b.type != VertexTexture && b.type != FragmentTexture)
+            continue;
+
+        std::string sampler_name;
+        if (b.name.length() > 8 && b.name.compare(b.name.length() - 8, 8, "_texture") == 0)
+            sampler_name = b.name.substr(0, b.name.length() - 8) + "_sampler";
+        else
+            sampler_name = b.name + "_sampler";
+
+        auto it = m_binding_index.find(sampler_name);
+        if (it != m_binding_index.end())
+            b.sampler = it->second;
+    }
+    finalize_bindings();
 }
 
 Shader::~Shader() {
-    for (const auto &[key, buf] : m_buffers) {
+    unpin_textures();
+    for (const Buffer &buf : m_buffers) {
         if (!buf.buffer)
             continue;
         if (buf.type == VertexBuffer ||
@@ -213,21 +226,17 @@ Shader::~Shader() {
     (void) (__bridge_transfer id<MTLRenderPipelineState>) m_pipeline_state;
 }
 
-void Shader::set_buffer(const std::string &name,
+void Shader::set_buffer(BindingHandle binding,
                         VariableType dtype,
                         size_t ndim,
                         const size_t *shape,
                         const void *data) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
-        throw std::runtime_error(
-            "Shader::set_buffer(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+    Buffer &buf = buffer(binding, "set_buffer");
     if (!(buf.type == VertexBuffer ||
           buf.type == FragmentBuffer ||
           buf.type == IndexBuffer))
         throw std::runtime_error(
-            "Shader::set_buffer(): argument named \"" + name + "\" is not a buffer!");
+            "Shader::set_buffer(): argument named \"" + buf.name + "\" is not a buffer!");
 
     for (size_t i = 0; i < 3; ++i)
         buf.shape[i] = i < ndim ? shape[i] : 1;
@@ -241,10 +250,22 @@ void Shader::set_buffer(const std::string &name,
         buf.buffer = nullptr;
     }
 
-    if (size <= NANOGUI_BUFFER_THRESHOLD && name != "indices") {
+    if (size <= NANOGUI_BUFFER_THRESHOLD && buf.type != IndexBuffer) {
         if (!buf.buffer)
             buf.buffer = new uint8_t[size];
         memcpy(buf.buffer, data, size);
+    } else if (buf.usage != BufferUsage::Static) {
+        /* Frequently updated buffers live in shared memory, which avoids the
+           blit below. A new buffer is allocated per upload, while command
+           buffers that are in flight retain the previous one */
+        id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+        if (buf.buffer)
+            (void) (__bridge_transfer id<MTLBuffer>) buf.buffer;
+        id<MTLBuffer> mtl_buffer =
+            [device newBufferWithBytes: data
+                                length: size
+                               options: MTLResourceStorageModeShared];
+        buf.buffer = (__bridge_retained void *) mtl_buffer;
     } else {
         /* Procedure recommended by Apple: create a temporary shared buffer and
            blit into a private GPU-only buffer */
@@ -287,15 +308,75 @@ void Shader::set_buffer(const std::string &name,
     buf.size  = size;
 }
 
-void Shader::set_texture(const std::string &name, Texture *texture) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+void Shader::set_uniform_block(BindingHandle binding, const void *data, size_t size) {
+    /* Uniform blocks are plain buffer arguments in the Metal shading language */
+    size_t shape[3] = { size, 1, 1 };
+    set_buffer(binding, VariableType::UInt8, 1, shape, data);
+}
+
+void Shader::update_buffer_range(BindingHandle binding, size_t offset,
+                                 size_t count, const void *data) {
+    Buffer &buf = buffer(binding, "update_buffer_range");
+    if (!(buf.type == VertexBuffer || buf.type == IndexBuffer) || !buf.buffer)
+        throw std::runtime_error(
+            "Shader::update_buffer_range(): argument named \"" + buf.name +
+            "\" is not an uploaded vertex or index buffer!");
+
+    if (offset + count > buf.shape[0])
         throw std::runtime_error(
-            "Shader::set_texture(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+            "Shader::update_buffer_range(\"" + buf.name + "\"): range [" +
+            std::to_string(offset) + ", " + std::to_string(offset + count) +
+            ") is out of bounds for " + buf.to_string());
+
+    if (count == 0)
+        return;
+
+    size_t entry_size = buf.size / buf.shape[0];
+
+    if (buf.size <= NANOGUI_BUFFER_THRESHOLD && buf.type != IndexBuffer) {
+        memcpy((uint8_t *) buf.buffer + offset * entry_size, data,
+               count * entry_size);
+        return;
+    }
+
+    id<MTLBuffer> mtl_buffer = (__bridge id<MTLBuffer>) buf.buffer;
+    if (mtl_buffer.storageMode == MTLStorageModeShared) {
+        memcpy((uint8_t *) mtl_buffer.contents + offset * entry_size, data,
+               count * entry_size);
+        return;
+    }
+
+    /* Same procedure as in set_buffer(), but only the modified range is
+       staged and copied */
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+
+    id<MTLBuffer> temp_buffer =
+        [device newBufferWithBytes: data
+                            length: count * entry_size
+                           options: MTLResourceStorageModeShared];
+
+    id<MTLCommandQueue> command_queue =
+        (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> blit_encoder =
+        [command_buffer blitCommandEncoder];
+
+    [blit_encoder copyFromBuffer: temp_buffer
+                    sourceOffset: 0
+                        toBuffer: mtl_buffer
+               destinationOffset: offset * entry_size
+                            size: count * entry_size];
+
+    [blit_encoder endEncoding];
+    [command_buffer commit];
+    [command_buffer waitUntilCompleted];
+}
+
+void Shader::set_texture(BindingHandle binding, Texture *texture) {
+    Buffer &buf = buffer(binding, "set_texture");
     if (!(buf.type == VertexTexture || buf.type == FragmentTexture))
         throw std::runtime_error(
-            "Shader::set_texture(): argument named \"" + name + "\" is not a texture!");
+            "Shader::set_texture(): argument named \"" + buf.name + "\" is not a texture!");
 
     if (buf.buffer) {
         (void) (__bridge_transfer id<MTLTexture>) buf.buffer;
@@ -304,19 +385,14 @@ void Shader::set_texture(const std::string &name, Texture *texture) {
 
     buf.buffer = (__bridge_retained void *) ((__bridge id<MTLTexture>)
                                                  texture->texture_handle());
+    buf.texture = texture;
 
-    std::string sampler_name;
-    if (name.length() > 8 && name.compare(name.length() - 8, 8, "_texture") == 0)
-        sampler_name = name.substr(0, name.length()-8) + "_sampler";
-    else
-        sampler_name = name + "_sampler";
-
-    if (m_buffers.find(sampler_name) != m_buffers.end()) {
+    if (buf.sampler != (uint32_t) -1) {
         /* Also set the sampler state */
-        Buffer &buf2 = m_buffers[sampler_name];
+        Buffer &buf2 = m_buffers[buf.sampler];
 
         if (buf2.buffer) {
-            (void) (__bridge_transfer id<MTLTexture>) buf2.buffer;
+            (void) (__bridge_transfer id<MTLSamplerState>) buf2.buffer;
             buf2.buffer = nullptr;
         }
 
@@ -334,16 +410,16 @@ void Shader::begin() {
 
     [command_enc setRenderPipelineState: pipeline_state];
 
-    for (const auto &[key, buf] : m_buffers) {
+    if (!m_bindings_complete)
+        check_bindings();
+
+    pin_textures();
+
+    for (uint32_t index : m_persistent) {
+        Buffer &buf = m_buffers[index];
         bool indices = buf.type == IndexBuffer;
-        if (!buf.buffer) {
-            if (!indices)
-                fprintf(stderr,
-                        "Shader::begin(): shader \"%s\" has an unbound "
-                        "argument \"%s\"!\n",
-                        m_name.c_str(), key.c_str());
+        if (!buf.buffer)
             continue;
-        }
 
         switch (buf.type) {
             case VertexTexture: {
@@ -399,12 +475,22 @@ void Shader::begin() {
 }
 
 void Shader::end() {
-    /* No-op */
+    unpin_textures();
+}
+
+void Shader::set_buffer_divisor(BindingHandle binding, uint32_t divisor) {
+    Buffer &buf = buffer(binding, "set_buffer_divisor");
+    if (buf.type != VertexBuffer)
+        throw std::runtime_error("Shader::set_buffer_divisor(): argument named \"" +
+                                 buf.name + "\" is not a vertex buffer!");
+    /* Shaders index per-instance buffers via [[instance_id]] */
+    buf.divisor = divisor;
 }
 
-void Shader::draw_array(PrimitiveType primitive_type,
-                        size_t offset, size_t count,
-                        bool indexed) {
+void Shader::draw_array_instanced(PrimitiveType primitive_type,
+                                  size_t offset, size_t count,
+                                  size_t instance_count,
+                                  bool indexed) {
     MTLPrimitiveType primitive_type_mtl;
     switch (primitive_type) {
         case PrimitiveType::Point:         primitive_type_mtl = MTLPrimitiveTypePoint;         break;
@@ -418,18 +504,23 @@ void Shader::draw_array(PrimitiveType primitive_type,
     id<MTLRenderCommandEncoder> command_enc =
         (__bridge id<MTLRenderCommandEncoder>) m_render_pass->command_encoder();
 
+    if (instance_count == 0)
+        return;
+
     if (!indexed) {
         [command_enc drawPrimitives: primitive_type_mtl
                         vertexStart: offset
-                        vertexCount: count];
+                        vertexCount: count
+                      instanceCount: instance_count];
     } else {
         id<MTLBuffer> index_buffer =
-            (__bridge id<MTLBuffer>) m_buffers["indices"].buffer;
+            (__bridge id<MTLBuffer>) m_buffers[m_indices].buffer;
         [command_enc drawIndexedPrimitives: primitive_type_mtl
                                 indexCount: count
                                  indexType: MTLIndexTypeUInt32
                                indexBuffer: index_buffer
-                         indexBufferOffset: offset * 4];
+                         indexBufferOffset: offset * 4
+                             instanceCount: instance_count];
     }
 }
 
@@ -0,0 +1,203 @@
+/*
+    src/spectrogram.cpp -- Scrolling heat map for displaying a stream of
+    spectra or other one-dimensional signals over time
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/spectrogram.h>
+#include <nanogui/renderpass.h>
+#include <nanogui/shader.h>
+#include <nanogui/texture.h>
+#include <algorithm>
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+Spectrogram::Spectrogram(Widget *parent, size_t bins, size_t history)
+    : Canvas(parent, 1, false, false, true), m_bins(bins), m_history(history) {
+    m_shader = new Shader(
+        render_pass(),
+        "spectrogram",
+        NANOGUI_SHADER(spectrogram_vertex),
+        NANOGUI_SHADER(spectrogram_fragment)
+    );
+
+    const float positions[] = {
+        0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
+        1.f, 0.f, 1.f, 1.f, 0.f, 1.f
+    };
+
+    m_shader->set_buffer("position", VariableType::Float32, { 6, 2 }, positions);
+    m_render_pass->set_cull_mode(RenderPass::CullMode::Disabled);
+
+    set_colormap(Colormap::Viridis);
+    init_texture();
+}
+
+void Spectrogram::init_texture() {
+    if (m_bins == 0 || m_history == 0)
+        throw std::runtime_error("Spectrogram: bins and history must be nonzero!");
+
+    /* One row per column, so that consecutive columns form a contiguous
+       rectangle that can be uploaded at once. The texture repeats so that
+       bilinear filtering blends the newest and oldest row of the ring at
+       the seam. GLES 2 cannot repeat non-power-of-two textures, hence it
+       samples the nearest row instead. */
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    Texture::InterpolationMode interpolation_mode = Texture::InterpolationMode::Nearest;
+    Texture::WrapMode wrap_mode = Texture::WrapMode::ClampToEdge;
+#else
+    Texture::InterpolationMode interpolation_mode = Texture::InterpolationMode::Bilinear;
+    Texture::WrapMode wrap_mode = Texture::WrapMode::Repeat;
+#endif
+    m_texture = new Texture(
+        Texture::PixelFormat::R,
+        Texture::ComponentFormat::UInt8,
+        Vector2i((int) m_bins, (int) m_history),
+        interpolation_mode,
+        interpolation_mode,
+        wrap_mode
+    );
+    m_texture->set_owner("Spectrogram");
+
+    m_data.assign(m_bins * m_history, 0);
+    m_texture->upload(m_data.data());
+    m_shader->set_texture("spectrum", m_texture);
+    m_total = m_uploaded = 0;
+    set_content_dirty();
+}
+
+void Spectrogram::set_shape(size_t bins, size_t history) {
+    m_bins = bins;
+    m_history = history;
+    init_texture();
+}
+
+void Spectrogram::clear() {
+    std::fill(m_data.begin(), m_data.end(), 0);
+    m_texture->upload(m_data.data());
+    m_total = m_uploaded = 0;
+    set_content_dirty();
+}
+
+void Spectrogram::push_columns(const float *values, size_t count) {
+    float scale = m_range_max != m_range_min ? 255.f / (m_range_max - m_range_min) : 0.f;
+
+    /* Only the last 'm_history' columns can be visible */
+    if (count > m_history) {
+        values += (count - m_history) * m_bins;
+        m_total += count - m_history;
+        count = m_history;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t *row = m_data.data() + (size_t) (m_total % m_history) * m_bins;
+        for (size_t j = 0; j < m_bins; ++j) {
+            float value = (values[j] - m_range_min) * scale;
+            row[j] = (uint8_t) std::max(0.f, std::min(255.f, value + .5f));
+        }
+        values += m_bins;
+        m_total++;
+    }
+
+    if (count > 0)
+        set_content_dirty();
+}
+
+void Spectrogram::set_colormap(Colormap colormap) {
+    static const uint8_t viridis[9][3] = {
+        {  68,   1,  84 }, {  71,  44, 122 }, {  59,  81, 139 },
+        {  44, 113, 142 }, {  33, 144, 141 }, {  39, 173, 129 },
+        {  92, 200,  99 }, { 170, 220,  50 }, { 253, 231,  37 }
+    };
+
+    static const uint8_t inferno[9][3] = {
+        {   0,   0,   4 }, {  31,  12,  72 }, {  85,  15, 109 },
+        { 136,  34, 106 }, { 186,  54,  85 }, { 227,  89,  51 },
+        { 249, 140,  10 }, { 249, 201,  50 }, { 252, 255, 164 }
+    };
+
+    std::vector<Color> colors;
+    switch (colormap) {
+        case Colormap::Grayscale:
+            colors = { Color(0, 255), Color(255, 255) };
+            break;
+
+        case Colormap::Viridis:
+        case Colormap::Inferno: {
+                const uint8_t (*stops)[3] = colormap == Colormap::Viridis ? viridis : inferno;
+                for (size_t i = 0; i < 9; ++i)
+                    colors.push_back(Color((int) stops[i][0], (int) stops[i][1],
+                                           (int) stops[i][2], 255));
+            }
+            break;
+
+        default:
+            throw std::runtime_error("Spectrogram::set_colormap(): invalid color map!");
+    }
+
+    set_colormap(colors);
+}
+
+void Spectrogram::set_colormap(const std::vector<Color> &colors) {
+    if (colors.size() < 2)
+        throw std::runtime_error("Spectrogram::set_colormap(): need at least two colors!");
+
+    const size_t size = 256;
+    uint8_t lut[size * 4];
+    for (size_t i = 0; i < size; ++i) {
+        float t = i * (colors.size() - 1) / (float) (size - 1);
+        size_t index = std::min((size_t) t, colors.size() - 2);
+        float w = t - index;
+        Color c = colors[index] * (1.f - w) + colors[index + 1] * w;
+        for (size_t k = 0; k < 4; ++k)
+            lut[i * 4 + k] = (uint8_t) std::max(0.f, std::min(255.f, c[k] * 255.f + .5f));
+    }
+
+    if (!m_colormap) {
+        m_colormap = new Texture(
+            Texture::PixelFormat::RGBA,
+            Texture::ComponentFormat::UInt8,
+            Vector2i((int) size, 1),
+            Texture::InterpolationMode::Bilinear,
+            Texture::InterpolationMode::Bilinear,
+            Texture::WrapMode::ClampToEdge
+        );
+        m_colormap->set_owner("Spectrogram");
+    }
+
+    m_colormap->upload(lut);
+    m_shader->set_texture("colormap", m_colormap);
+    set_content_dirty();
+}
+
+void Spectrogram::draw_contents() {
+    /* Upload the columns that were pushed since the last frame: at most two
+       rectangles, since the ring buffer may have wrapped around */
+    uint64_t begin = std::max(m_uploaded, m_total >= m_history ? m_total - m_history : 0);
+    while (begin < m_total) {
+        size_t row = (size_t) (begin % m_history),
+               count = (size_t) std::min<uint64_t>(m_total - begin, m_history - row);
+        m_texture->upload_sub_region(m_data.data() + row * m_bins,
+                                     Vector2i(0, (int) row),
+                                     Vector2i((int) m_bins, (int) count));
+        begin += count;
+    }
+    m_uploaded = m_total;
+
+    m_shader->set_uniform("scroll", (float) (m_total % m_history) / (float) m_history);
+    m_shader->set_uniform("history", (float) m_history);
+    m_shader->set_uniform("bins", (float) m_bins);
+
+    m_shader->begin();
+    m_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
+    m_shader->end();
+}
+
+NAMESPACE_END(nanogui)
@@ -1,6 +1,12 @@
 #include <nanogui/texture.h>
+#include <nanogui/screen.h>
 #include <stb_image.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <atomic>
 #include <memory>
+#include <unordered_set>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -24,36 +30,212 @@ Texture::Texture(PixelFormat pixel_format,
     init();
 }
 
-Texture::Texture(const std::string &filename,
+/// Return the number of bytes per 4x4 block of a compression scheme
+static size_t compression_block_bytes(Texture::Compression compression) {
+    switch (compression) {
+        case Texture::Compression::BC1:
+        case Texture::Compression::BC4:
+        case Texture::Compression::ETC2_RGB:
+            return 8;
+
+        case Texture::Compression::BC3:
+        case Texture::Compression::BC5:
+        case Texture::Compression::BC7:
+        case Texture::Compression::ETC2_RGBA:
+            return 16;
+
+        default:
+            throw std::runtime_error("Texture: invalid compression scheme!");
+    }
+}
+
+/// Return the pixel format of the decompressed data
+static Texture::PixelFormat compression_pixel_format(Texture::Compression compression) {
+    switch (compression) {
+        case Texture::Compression::BC4:      return Texture::PixelFormat::R;
+        case Texture::Compression::BC5:      return Texture::PixelFormat::RA;
+        case Texture::Compression::ETC2_RGB: return Texture::PixelFormat::RGB;
+        default:                             return Texture::PixelFormat::RGBA;
+    }
+}
+
+Texture::Texture(Compression compression,
+                 const Vector2i &size,
+                 uint32_t mip_levels,
                  InterpolationMode min_interpolation_mode,
                  InterpolationMode mag_interpolation_mode,
                  WrapMode wrap_mode)
+    : m_pixel_format(compression_pixel_format(compression)),
+      m_component_format(ComponentFormat::UInt8),
+      m_min_interpolation_mode(min_interpolation_mode),
+      m_mag_interpolation_mode(mag_interpolation_mode),
+      m_wrap_mode(wrap_mode),
+      m_samples(1),
+      m_flags(TextureFlags::ShaderRead),
+      m_size(size),
+      m_compression(compression),
+      m_mip_levels(mip_levels) {
+    if (compression == Compression::None)
+        throw std::runtime_error("Texture::Texture(): use the other constructor "
+                                 "for uncompressed textures!");
+    if (mip_levels == 0 || mip_levels > 32 || (mip_levels > 1 &&
+        (std::max(size.x(), size.y()) >> (mip_levels - 1)) == 0))
+        throw std::runtime_error("Texture::Texture(): invalid number of MIP levels!");
+    init();
+}
+
+/* KTX (version 1) container format. The header consists of a 12-byte
+   identifier followed by 13 32-bit fields */
+static const uint8_t ktx_identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+enum KTXField {
+    KTXEndianness, KTXGLType, KTXGLTypeSize, KTXGLFormat, KTXGLInternalFormat,
+    KTXGLBaseInternalFormat, KTXPixelWidth, KTXPixelHeight, KTXPixelDepth,
+    KTXArrayElements, KTXFaces, KTXMipmapLevels, KTXKeyValueBytes, KTXFieldCount
+};
+
+bool Texture::is_ktx(const uint8_t *data, size_t size) {
+    return size >= sizeof(ktx_identifier) &&
+           memcmp(data, ktx_identifier, sizeof(ktx_identifier)) == 0;
+}
+
+void Texture::load_ktx(const std::string &filename, const std::vector<uint8_t> &data) {
+    auto error = [&](const char *reason) {
+        return std::runtime_error("Texture::Texture(): could not load KTX file \"" +
+                                 filename + "\": " + reason);
+    };
+
+    const size_t header_size = sizeof(ktx_identifier) + KTXFieldCount * sizeof(uint32_t);
+    if (data.size() < header_size)
+        throw error("truncated header");
+
+    bool swap = false;
+    auto read_u32 = [&](size_t offset) {
+        uint32_t value;
+        memcpy(&value, data.data() + offset, sizeof(uint32_t));
+        if (swap)
+            value = (value >> 24) | ((value >> 8) & 0xFF00u) |
+                    ((value << 8) & 0xFF0000u) | (value << 24);
+        return value;
+    };
+
+    uint32_t header[KTXFieldCount];
+    for (int i = 0; i < KTXFieldCount; ++i) {
+        header[i] = read_u32(sizeof(ktx_identifier) + i * sizeof(uint32_t));
+        if (i == KTXEndianness && header[i] == 0x01020304u) {
+            swap = true;
+            header[i] = 0x04030201u;
+        }
+    }
+
+    if (header[KTXEndianness] != 0x04030201u)
+        throw error("invalid endianness tag");
+    if (header[KTXGLType] != 0)
+        throw error("only compressed formats are supported");
+    if (header[KTXPixelDepth] > 1 || header[KTXArrayElements] > 0 || header[KTXFaces] != 1)
+        throw error("only 2D textures are supported");
+
+    switch (header[KTXGLInternalFormat]) {
+        case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+        case 0x83F1: m_compression = Compression::BC1;       break;
+        case 0x83F3: m_compression = Compression::BC3;       break;
+        case 0x8DBB: m_compression = Compression::BC4;       break;
+        case 0x8DBD: m_compression = Compression::BC5;       break;
+        case 0x8E8C: m_compression = Compression::BC7;       break;
+        case 0x9274: m_compression = Compression::ETC2_RGB;  break;
+        case 0x9278: m_compression = Compression::ETC2_RGBA; break;
+        default: throw error("unsupported internal format");
+    }
+
+    if (!compression_supported(m_compression))
+        throw error("compression scheme is not supported by the hardware");
+
+    m_pixel_format = compression_pixel_format(m_compression);
+    m_size = Vector2i((int) header[KTXPixelWidth], (int) header[KTXPixelHeight]);
+    m_mip_levels = std::max(header[KTXMipmapLevels], 1u);
+    if (m_size.x() <= 0 || m_size.y() <= 0 || m_mip_levels > 32)
+        throw error("invalid image size");
+
+    /* Validate all levels before allocating the texture */
+    std::vector<std::pair<size_t, size_t>> levels;
+    size_t offset = header_size + header[KTXKeyValueBytes];
+    for (uint32_t level = 0; level < m_mip_levels; ++level) {
+        if (offset + sizeof(uint32_t) > data.size())
+            throw error("truncated image data");
+        size_t size = read_u32(offset);
+        offset += sizeof(uint32_t);
+        if (size != compressed_size(level) || offset + size > data.size())
+            throw error("invalid image size");
+        levels.emplace_back(offset, size);
+        offset += (size + 3) & ~(size_t) 3;
+    }
+
+    init();
+    for (uint32_t level = 0; level < m_mip_levels; ++level)
+        upload_compressed(data.data() + levels[level].first, levels[level].second, level);
+}
+
+Texture::Texture(InterpolationMode min_interpolation_mode,
+                 InterpolationMode mag_interpolation_mode,
+                 WrapMode wrap_mode)
     : m_component_format(ComponentFormat::UInt8),
       m_min_interpolation_mode(min_interpolation_mode),
       m_mag_interpolation_mode(mag_interpolation_mode),
       m_wrap_mode(wrap_mode),
       m_samples(1),
-      m_flags(TextureFlags::ShaderRead) {
+      m_flags(TextureFlags::ShaderRead),
+      m_size(0) { }
+
+Texture::Texture(const std::string &filename,
+                 InterpolationMode min_interpolation_mode,
+                 InterpolationMode mag_interpolation_mode,
+                 WrapMode wrap_mode)
+    : Texture(min_interpolation_mode, mag_interpolation_mode, wrap_mode) {
+    std::ifstream is(filename, std::ios::binary);
+    uint8_t identifier[sizeof(ktx_identifier)];
+    if (is.read((char *) identifier, sizeof(identifier)) &&
+        is_ktx(identifier, sizeof(identifier))) {
+        is.seekg(0, std::ios::end);
+        std::vector<uint8_t> data((size_t) is.tellg());
+        is.seekg(0, std::ios::beg);
+        if (!is.read((char *) data.data(), (std::streamsize) data.size()))
+            throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
+        load_ktx(filename, data);
+        return;
+    }
+    is.close();
+
     int n = 0;
+    Vector2i size;
     using Holder = std::unique_ptr<uint8_t[], void(*)(void*)>;
-    Holder texture_data(stbi_load(filename.c_str(), &m_size.x(), &m_size.y(), &n, 0),
+    Holder texture_data(stbi_load(filename.c_str(), &size.x(), &size.y(), &n, 0),
                         stbi_image_free);
     if (!texture_data)
         throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
 
-    switch (n) {
+    load_image(filename, texture_data.get(), size, n);
+}
+
+void Texture::load_image(const std::string &filename, const uint8_t *data,
+                         const Vector2i &size, int channels) {
+    switch (channels) {
         case 1: m_pixel_format = PixelFormat::R;    break;
         case 2: m_pixel_format = PixelFormat::RA;   break;
         case 3: m_pixel_format = PixelFormat::RGB;  break;
         case 4: m_pixel_format = PixelFormat::RGBA; break;
         default:
-            throw std::runtime_error("Texture::Texture(): unsupported channel count!");
+            throw std::runtime_error("Texture::Texture(): unsupported channel count in \"" +
+                                     filename + "\"!");
     }
+    m_size = size;
+    m_filename = filename;
     PixelFormat pixel_format = m_pixel_format;
     init();
     if (m_pixel_format != pixel_format)
         throw std::runtime_error("Texture::Texture(): pixel format not supported by the hardware!");
-    upload((const uint8_t *) texture_data.get());
+    upload(data);
 }
 
 size_t Texture::bytes_per_pixel() const {
@@ -74,6 +256,198 @@ size_t Texture::bytes_per_pixel() const {
     return result * channels();
 }
 
+/* Registry of all textures for memory accounting (see Texture::memory_usage()) */
+static struct TextureRegistry {
+    std::mutex mutex;
+    std::unordered_set<Texture *> textures;
+    size_t usage = 0;
+    size_t budget = 0;
+} texture_registry;
+
+/// Incremented whenever a texture is used (to find the least recently used ones)
+static std::atomic<uint64_t> texture_clock { 0 };
+
+uint32_t Texture::allocated_mip_levels() const {
+    if (m_compression != Compression::None)
+        return m_mip_levels;
+    else if (m_min_interpolation_mode != InterpolationMode::Trilinear)
+        return 1;
+    uint32_t levels = 1;
+    while ((std::max(m_size.x(), m_size.y()) >> levels) > 0)
+        levels++;
+    return levels;
+}
+
+size_t Texture::memory_usage() const {
+    uint32_t levels = allocated_mip_levels();
+    size_t result = 0;
+    if (m_compression != Compression::None) {
+        for (uint32_t i = 0; i < levels; ++i)
+            result += compressed_size(i);
+    } else {
+        size_t pixel_bytes = bytes_per_pixel() * m_samples;
+        for (uint32_t i = 0; i < levels; ++i)
+            result += pixel_bytes * (size_t) std::max(m_size.x() >> i, 1) *
+                      (size_t) std::max(m_size.y() >> i, 1);
+    }
+    return result;
+}
+
+void Texture::set_owner(const std::string &owner) {
+    std::lock_guard<std::mutex> guard(texture_registry.mutex);
+    m_owner = owner;
+}
+
+void Texture::set_evictable(bool evictable, const std::function<void(Texture *)> &restore) {
+    if (evictable) {
+        if (m_flags != (uint8_t) TextureFlags::ShaderRead || m_samples != 1)
+            throw std::runtime_error("Texture::set_evictable(): only supported for "
+                                     "single-sampled textures read by shaders!");
+        else if (!restore && (m_filename.empty() || m_compression != Compression::None))
+            throw std::runtime_error("Texture::set_evictable(): a restore function must be "
+                                     "specified for textures not loaded from an image file!");
+    } else {
+        make_resident();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        m_evictable = evictable;
+        m_restore = evictable ? restore : std::function<void(Texture *)>();
+    }
+
+    if (evictable)
+        enforce_memory_budget(this);
+}
+
+void Texture::make_resident() {
+    m_last_use = ++texture_clock;
+    if (!m_evicted)
+        return;
+
+    restore_storage();
+    m_evicted = false;
+    track_memory();
+
+    if (m_restore) {
+        m_restore(this);
+    } else {
+        int n = 0;
+        Vector2i size;
+        using Holder = std::unique_ptr<uint8_t[], void(*)(void*)>;
+        Holder texture_data(stbi_load(m_filename.c_str(), &size.x(), &size.y(), &n, 0),
+                            stbi_image_free);
+        if (!texture_data || size != m_size || n != (int) channels())
+            throw std::runtime_error("Texture::make_resident(): could not reload \"" +
+                                     m_filename + "\"!");
+        upload(texture_data.get());
+    }
+}
+
+void Texture::pin() {
+    {
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        m_pins++;
+    }
+    make_resident();
+}
+
+void Texture::unpin() {
+    bool enforce;
+    {
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        if (m_pins == 0)
+            throw std::runtime_error("Texture::unpin(): texture is not pinned!");
+        enforce = --m_pins == 0;
+    }
+    if (enforce)
+        enforce_memory_budget(nullptr);
+}
+
+void Texture::track_memory() {
+    size_t bytes = m_evicted ? 0 : memory_usage();
+    {
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        texture_registry.textures.insert(this);
+        texture_registry.usage = texture_registry.usage - m_tracked_bytes + bytes;
+        m_tracked_bytes = bytes;
+    }
+    m_last_use = ++texture_clock;
+    enforce_memory_budget(this);
+}
+
+void Texture::untrack_memory() {
+    std::lock_guard<std::mutex> guard(texture_registry.mutex);
+    texture_registry.textures.erase(this);
+    texture_registry.usage -= m_tracked_bytes;
+    m_tracked_bytes = 0;
+}
+
+void Texture::enforce_memory_budget(Texture *keep) {
+    while (true) {
+        Texture *victim = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(texture_registry.mutex);
+            if (texture_registry.budget == 0 ||
+                texture_registry.usage <= texture_registry.budget)
+                return;
+
+            for (Texture *texture : texture_registry.textures) {
+                if (texture == keep || !texture->m_evictable || texture->m_pins > 0 ||
+                    texture->m_tracked_bytes == 0)
+                    continue;
+                if (!victim || texture->m_last_use < victim->m_last_use)
+                    victim = texture;
+            }
+        }
+
+        if (!victim)
+            return;
+
+        victim->release_storage();
+        victim->m_evicted = true;
+
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        texture_registry.usage -= victim->m_tracked_bytes;
+        victim->m_tracked_bytes = 0;
+    }
+}
+
+size_t Texture::total_memory_usage() {
+    std::lock_guard<std::mutex> guard(texture_registry.mutex);
+    return texture_registry.usage;
+}
+
+std::map<std::string, size_t> Texture::memory_usage_by_owner() {
+    std::map<std::string, size_t> result;
+    std::lock_guard<std::mutex> guard(texture_registry.mutex);
+    for (Texture *texture : texture_registry.textures) {
+        if (texture->m_tracked_bytes > 0)
+            result[texture->m_owner] += texture->m_tracked_bytes;
+    }
+    return result;
+}
+
+size_t Texture::memory_budget() {
+    std::lock_guard<std::mutex> guard(texture_registry.mutex);
+    return texture_registry.budget;
+}
+
+void Texture::set_memory_budget(size_t budget) {
+    {
+        std::lock_guard<std::mutex> guard(texture_registry.mutex);
+        texture_registry.budget = budget;
+    }
+    enforce_memory_budget(nullptr);
+}
+
+size_t Texture::compressed_size(uint32_t level) const {
+    size_t block_bytes = compression_block_bytes(m_compression);
+    size_t width  = (size_t) std::max(m_size.x() >> level, 1),
+           height = (size_t) std::max(m_size.y() >> level, 1);
+    return ((width + 3) / 4) * ((height + 3) / 4) * block_bytes;
+}
+
 size_t Texture::channels() const {
     size_t result = 1;
     switch (m_pixel_format) {
@@ -91,4 +465,156 @@ size_t Texture::channels() const {
     return result;
 }
 
+void Texture::download(uint8_t *data) {
+    ref<TextureDownload> download = new TextureDownload(this);
+    download->start();
+    download->read(data);
+}
+
+ref<TextureDownload> Texture::download_async() {
+    ref<TextureDownload> download = new TextureDownload(this);
+    download->start();
+    return download;
+}
+
+TextureDownload::TextureDownload(Texture *texture) : m_texture(texture) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    throw std::runtime_error("TextureDownload: not supported on GLES 2!");
+#endif
+    if (!texture || texture->samples() != 1)
+        throw std::runtime_error("TextureDownload: only implemented for samples=1!");
+    if (texture->compression() != Texture::Compression::None)
+        throw std::runtime_error("TextureDownload: compressed textures are not supported!");
+    if (!texture->texture_handle())
+        throw std::runtime_error("TextureDownload: no texture handle!");
+#if defined(NANOGUI_USE_GLES)
+    /* GLES reads back through a framebuffer, and luminance (R/RA) and depth
+       textures are neither color-renderable nor valid glReadPixels() formats */
+    Texture::PixelFormat pixel_format = texture->pixel_format();
+    if (pixel_format == Texture::PixelFormat::R || pixel_format == Texture::PixelFormat::RA)
+        throw std::runtime_error("TextureDownload: R and RA textures cannot be read back on GLES!");
+    if (pixel_format == Texture::PixelFormat::Depth ||
+        pixel_format == Texture::PixelFormat::DepthStencil)
+        throw std::runtime_error("TextureDownload: depth textures cannot be read back on GLES!");
+#endif
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    m_flipped = texture->flags() & (uint8_t) Texture::TextureFlags::RenderTarget;
+#endif
+}
+
+void TextureDownload::read(uint8_t *out) {
+    const uint8_t *row = data();
+    ptrdiff_t stride = row_stride();
+    size_t row_bytes = m_texture->bytes_per_pixel() * (size_t) m_size.x();
+
+    if (!m_flipped) {
+        memcpy(out, row, row_bytes * (size_t) m_size.y());
+        return;
+    }
+
+    for (int y = 0; y < m_size.y(); ++y, row += stride, out += row_bytes)
+        memcpy(out, row, row_bytes);
+}
+
+TextureStream::TextureStream(Texture *texture, size_t buffer_count)
+    : m_texture(texture), m_slots(buffer_count) {
+    if (!texture || texture->samples() != 1 ||
+        texture->compression() != Texture::Compression::None ||
+        !(texture->flags() & (uint8_t) Texture::TextureFlags::ShaderRead))
+        throw std::runtime_error("TextureStream::TextureStream(): the texture must "
+                                 "be uncompressed, single-sampled and readable by shaders!");
+    if (buffer_count < 2)
+        throw std::runtime_error("TextureStream::TextureStream(): at least two "
+                                 "buffers are required!");
+
+    m_frame_size = texture->bytes_per_pixel() * (size_t) texture->size().x() *
+                   (size_t) texture->size().y();
+    init();
+}
+
+size_t TextureStream::slot_index(const uint8_t *data) const {
+    /* Only look at buffers owned by the producer: the others may be
+       (un)mapped by the render thread concurrently */
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].state == SlotState::Writing && m_slots[i].data == data)
+            return i;
+    }
+    throw std::runtime_error("TextureStream: unknown buffer!");
+}
+
+uint8_t *TextureStream::map_next() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (Slot &slot : m_slots) {
+        if (slot.state == SlotState::Free) {
+            slot.state = SlotState::Writing;
+            return slot.data;
+        }
+    }
+    return nullptr;
+}
+
+void TextureStream::commit(uint8_t *data) {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        Slot &slot = m_slots[slot_index(data)];
+        slot.state = SlotState::Ready;
+        slot.frame = ++m_frames_committed;
+    }
+
+    if (m_armed.load(std::memory_order_relaxed) &&
+        m_armed.exchange(false, std::memory_order_acq_rel)) {
+        Screen::redraw_async(m_screen.load(std::memory_order_relaxed));
+    }
+}
+
+void TextureStream::discard(uint8_t *data) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_slots[slot_index(data)].state = SlotState::Free;
+}
+
+bool TextureStream::update() {
+    /* Only the render thread moves buffers into and out of the 'InFlight'
+       state, hence the backend calls below don't need to hold the lock */
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        bool in_flight;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            in_flight = m_slots[i].state == SlotState::InFlight;
+        }
+        if (in_flight && recycle(i)) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_slots[i].state = SlotState::Free;
+        }
+    }
+
+    /* Pick the newest committed frame, older ones are superseded */
+    size_t newest = (size_t) -1;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto drop = [&](size_t i) {
+            m_slots[i].state = SlotState::Free;
+            m_frames_dropped++;
+        };
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].state != SlotState::Ready)
+                continue;
+            if (newest == (size_t) -1) {
+                newest = i;
+            } else if (m_slots[i].frame > m_slots[newest].frame) {
+                drop(newest);
+                newest = i;
+            } else {
+                drop(i);
+            }
+        }
+        if (newest == (size_t) -1)
+            return false;
+        m_slots[newest].state = SlotState::InFlight;
+        m_frames_uploaded++;
+    }
+
+    upload(newest);
+    return true;
+}
+
 NAMESPACE_END(nanogui)
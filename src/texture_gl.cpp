@@ -1,6 +1,10 @@
 #include <nanogui/texture.h>
 #include <nanogui/opengl.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
+#include "opengl_extensions.h"
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #if !defined(GL_HALF_FLOAT)
@@ -48,6 +52,22 @@
 #  define GL_DEPTH_COMPONENT32F 0x8CAC
 #endif
 
+#if !defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+#  define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#  define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#if !defined(GL_COMPRESSED_RED_RGTC1)
+#  define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#  define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+#if !defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+#  define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#if !defined(GL_COMPRESSED_RGB8_ETC2)
+#  define GL_COMPRESSED_RGB8_ETC2 0x9274
+#  define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
 NAMESPACE_BEGIN(nanogui)
 
 static void gl_map_texture_format(Texture::PixelFormat &pixel_format,
@@ -105,12 +125,18 @@ void Texture::init() {
 
     if (m_flags & (uint8_t) TextureFlags::ShaderRead) {
         CHK(glGenTextures(1, &m_texture_handle));
-        CHK(glBindTexture(tex_mode, m_texture_handle));
+        GLState::current().bind_texture(0, tex_mode, m_texture_handle);
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_MIN_FILTER, interpolation_mode_gl[0]));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_MAG_FILTER, interpolation_mode_gl[1]));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_S, wrap_mode_gl));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_T, wrap_mode_gl));
 
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+        /* Compressed MIP chains are uploaded explicitly and may be partial */
+        if (m_compression != Compression::None)
+            CHK(glTexParameteri(tex_mode, GL_TEXTURE_MAX_LEVEL, (GLint) m_mip_levels - 1));
+#endif
+
         if (m_flags & (uint8_t) TextureFlags::RenderTarget)
             upload(nullptr);
     } else if (m_flags & (uint8_t) TextureFlags::RenderTarget) {
@@ -131,9 +157,14 @@ void Texture::init() {
         throw std::runtime_error(
             "Texture::Texture(): flags must either specify ShaderRead, RenderTarget, or both!");
     }
+
+    track_memory();
 }
 
 Texture::~Texture() {
+    untrack_memory();
+    if (m_texture_handle)
+        GLState::current().texture_deleted(m_texture_handle);
     CHK(glDeleteTextures(1, &m_texture_handle));
     CHK(glDeleteRenderbuffers(1, &m_renderbuffer_handle));
 }
@@ -141,6 +172,16 @@ Texture::~Texture() {
 void Texture::upload(const uint8_t *data) {
     if (m_samples > 1 && data != nullptr)
         throw std::runtime_error("Texture::upload(): only implemented for samples=1!");
+    else if (m_compression != Compression::None)
+        throw std::runtime_error("Texture::upload(): use upload_compressed() for compressed textures!");
+    else if (m_evicted && data)
+        make_resident();
+
+    /* Overwrite the existing storage instead of reallocating it */
+    if (data && m_texture_handle != 0 && m_storage_size == m_size) {
+        upload_sub_region(data, Vector2i(0), m_size);
+        return;
+    }
 
     GLenum pixel_format_gl,
            component_format_gl,
@@ -154,7 +195,7 @@ void Texture::upload(const uint8_t *data) {
 
     if (m_texture_handle != 0) {
         GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-        CHK(glBindTexture(tex_mode, m_texture_handle));
+        GLState::current().bind_texture(0, tex_mode, m_texture_handle);
 
         if (data)
             CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
@@ -180,6 +221,8 @@ void Texture::upload(const uint8_t *data) {
         if (m_min_interpolation_mode == InterpolationMode::Trilinear ||
             m_mag_interpolation_mode == InterpolationMode::Trilinear)
             CHK(glGenerateMipmap(tex_mode));
+
+        m_storage_size = m_size;
     } else {
 #if defined(NANOGUI_USE_OPENGL)
         CHK(glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer_handle));
@@ -196,15 +239,27 @@ void Texture::upload(const uint8_t *data) {
     }
 }
 
-void Texture::download(uint8_t *data) {
-#if defined(NANOGUI_USE_GLES)
-    (void) data;
-    throw std::runtime_error("Texture::download(): not supported on GLES 2!");
-#else
+void Texture::upload_sub_region(const uint8_t *data, const Vector2i &origin,
+                                const Vector2i &size, size_t row_stride) {
     if (m_texture_handle == 0)
-        throw std::runtime_error("Texture::download(): no texture handle!");
+        throw std::runtime_error("Texture::upload_sub_region(): no texture handle!");
     else if (m_samples > 1)
-        throw std::runtime_error("Texture::download(): only implemented for samples=1!");
+        throw std::runtime_error("Texture::upload_sub_region(): only implemented for samples=1!");
+    else if (m_compression != Compression::None)
+        throw std::runtime_error("Texture::upload_sub_region(): not supported for compressed textures!");
+    else if (origin.x() < 0 || origin.y() < 0 || size.x() < 0 || size.y() < 0 ||
+             origin.x() + size.x() > m_size.x() || origin.y() + size.y() > m_size.y())
+        throw std::runtime_error("Texture::upload_sub_region(): region is out of bounds!");
+    else if (row_stride != 0 && row_stride < (size_t) size.x())
+        throw std::runtime_error("Texture::upload_sub_region(): row stride is too small!");
+    if (size.x() == 0 || size.y() == 0)
+        return;
+    else if (m_evicted)
+        make_resident();
+
+    /* The first upload allocates the storage */
+    if (m_storage_size != m_size)
+        upload(nullptr);
 
     GLenum pixel_format_gl,
            component_format_gl,
@@ -216,31 +271,352 @@ void Texture::download(uint8_t *data) {
                           component_format_gl,
                           internal_format_gl);
 
-    (void) internal_format_gl;
-    CHK(glBindTexture(GL_TEXTURE_2D, m_texture_handle));
-    CHK(glGetTexImage(GL_TEXTURE_2D, 0, pixel_format_gl, component_format_gl, data));
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
 
-    if (m_flags & (uint8_t) TextureFlags::RenderTarget) {
-        size_t stride = bytes_per_pixel() * m_size.x();
-        std::unique_ptr<uint8_t[]> temp(new uint8_t[stride]);
+    if (row_stride == 0)
+        row_stride = (size_t) size.x();
 
-        uint8_t *low = (uint8_t *) data,
-                *high = low + (m_size.y() - 1) * stride;
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint) row_stride));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
 
-        for (; low < high; low += stride, high -= stride) {
-            memcpy(temp.get(), low, stride);
-            memcpy(low, high, stride);
-            memcpy(high, temp.get(), stride);
-        }
+    CHK(glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint) origin.x(), (GLint) origin.y(),
+                        (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                        component_format_gl, data));
+
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+#else
+    /* GLES 2 lacks GL_UNPACK_ROW_LENGTH: upload strided data row by row */
+    if (row_stride == (size_t) size.x()) {
+        CHK(glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint) origin.x(), (GLint) origin.y(),
+                            (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                            component_format_gl, data));
+    } else {
+        size_t row_bytes = row_stride * bytes_per_pixel();
+        for (int y = 0; y < size.y(); ++y)
+            CHK(glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint) origin.x(), (GLint) (origin.y() + y),
+                                (GLsizei) size.x(), 1, pixel_format_gl,
+                                component_format_gl, data + y * row_bytes));
+    }
+#endif
+
+    if (m_min_interpolation_mode == InterpolationMode::Trilinear ||
+        m_mag_interpolation_mode == InterpolationMode::Trilinear)
+        CHK(glGenerateMipmap(GL_TEXTURE_2D));
+}
+
+static GLenum gl_compressed_format(Texture::Compression compression) {
+    using Compression = Texture::Compression;
+    switch (compression) {
+        case Compression::BC1:       return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case Compression::BC3:       return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case Compression::BC4:       return GL_COMPRESSED_RED_RGTC1;
+        case Compression::BC5:       return GL_COMPRESSED_RG_RGTC2;
+        case Compression::BC7:       return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case Compression::ETC2_RGB:  return GL_COMPRESSED_RGB8_ETC2;
+        case Compression::ETC2_RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: throw std::runtime_error("Texture: invalid compression scheme!");
+    }
+}
+
+bool Texture::compression_supported(Compression compression) {
+#if defined(NANOGUI_USE_OPENGL)
+    switch (compression) {
+        case Compression::BC1:
+        case Compression::BC3:
+            return gl_has_extension("GL_EXT_texture_compression_s3tc");
+        case Compression::BC4:
+        case Compression::BC5:
+            return true; // core since OpenGL 3.0
+        case Compression::BC7:
+            return gl_supports(42, "GL_ARB_texture_compression_bptc");
+        case Compression::ETC2_RGB:
+        case Compression::ETC2_RGBA:
+            return gl_supports(43, "GL_ARB_ES3_compatibility");
+        default:
+            return false;
+    }
+#else
+    switch (compression) {
+        case Compression::BC1:
+        case Compression::BC3:
+            return gl_has_extension("GL_EXT_texture_compression_s3tc");
+        case Compression::BC4:
+        case Compression::BC5:
+            return gl_has_extension("GL_EXT_texture_compression_rgtc");
+        case Compression::BC7:
+            return gl_has_extension("GL_EXT_texture_compression_bptc");
+        case Compression::ETC2_RGB:
+        case Compression::ETC2_RGBA:
+            return NANOGUI_GLES_VERSION >= 3; // core since GLES 3.0
+        default:
+            return false;
     }
 #endif
 }
 
+void Texture::upload_compressed(const uint8_t *data, size_t size, uint32_t level) {
+    if (m_compression == Compression::None)
+        throw std::runtime_error("Texture::upload_compressed(): texture is not compressed!");
+    else if (level >= m_mip_levels)
+        throw std::runtime_error("Texture::upload_compressed(): invalid MIP level!");
+    else if (size != compressed_size(level))
+        throw std::runtime_error("Texture::upload_compressed(): data size does not "
+                                 "match the MIP level!");
+    else if (m_evicted)
+        make_resident();
+
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+#endif
+    CHK(glCompressedTexImage2D(GL_TEXTURE_2D, (GLint) level, gl_compressed_format(m_compression),
+                               (GLsizei) std::max(m_size.x() >> level, 1),
+                               (GLsizei) std::max(m_size.y() >> level, 1), 0,
+                               (GLsizei) size, data));
+}
+
 void Texture::resize(const Vector2i &size) {
     if (m_size == size)
         return;
+    else if (m_compression != Compression::None)
+        throw std::runtime_error("Texture::resize(): not supported for compressed textures!");
     m_size = size;
+    m_evicted = false;
     upload(nullptr);
+    track_memory();
+}
+
+void Texture::release_storage() {
+    /* Respecify all levels as empty images, which frees the storage while
+       keeping the handle (that shaders refer to) valid */
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    for (uint32_t i = 0, levels = allocated_mip_levels(); i < levels; ++i)
+        CHK(glTexImage2D(GL_TEXTURE_2D, (GLint) i, GL_RGBA, 0, 0, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, nullptr));
+    m_storage_size = Vector2i(0);
+}
+
+void Texture::restore_storage() {
+    /* Compressed textures are reallocated level by level by upload_compressed() */
+    if (m_compression == Compression::None)
+        upload(nullptr);
+}
+
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+/// Map a pixel unpack buffer for writing, discarding its previous contents
+static uint8_t *gl_map_unpack_buffer(GLuint buffer, size_t size) {
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer));
+    void *ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) size,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    if (!ptr)
+        throw std::runtime_error("TextureStream: could not map pixel unpack buffer!");
+    return (uint8_t *) ptr;
+}
+#endif
+
+void TextureStream::init() {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /* Allocate the texture storage first, since glTexImage2D() would
+       otherwise read from a bound pixel unpack buffer */
+    if (m_texture->m_storage_size != m_texture->size())
+        m_texture->upload(nullptr);
+
+    for (Slot &slot : m_slots) {
+        CHK(glGenBuffers(1, &slot.buffer));
+        CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+        CHK(glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) m_frame_size,
+                         nullptr, GL_STREAM_DRAW));
+        slot.data = gl_map_unpack_buffer(slot.buffer, m_frame_size);
+    }
+#else
+    for (Slot &slot : m_slots) {
+        slot.storage.reset(new uint8_t[m_frame_size]);
+        slot.data = slot.storage.get();
+    }
+#endif
+}
+
+TextureStream::~TextureStream() {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    for (Slot &slot : m_slots) {
+        if (slot.fence)
+            CHK(glDeleteSync((GLsync) slot.fence));
+        if (slot.data) {
+            CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+            CHK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+        }
+        CHK(glDeleteBuffers(1, &slot.buffer));
+    }
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+#endif
+}
+
+void TextureStream::upload(size_t index) {
+    Slot &slot = m_slots[index];
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    /* Unmap and copy from the buffer (the 'data' argument is an offset),
+       which returns without waiting for the transfer to finish */
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+    CHK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    slot.data = nullptr;
+    m_texture->upload_sub_region(nullptr, Vector2i(0), m_texture->size());
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    slot.fence = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+    m_texture->upload_sub_region(slot.data, Vector2i(0), m_texture->size());
+#endif
+}
+
+bool TextureStream::recycle(size_t index) {
+    Slot &slot = m_slots[index];
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (slot.fence) {
+        GLenum rv = glClientWaitSync((GLsync) slot.fence, 0, 0);
+        if (rv == GL_TIMEOUT_EXPIRED)
+            return false;
+        CHK(glDeleteSync((GLsync) slot.fence));
+        slot.fence = nullptr;
+    }
+    slot.data = gl_map_unpack_buffer(slot.buffer, m_frame_size);
+#else
+    (void) slot;
+#endif
+    return true;
+}
+
+TextureDownload::~TextureDownload() {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (m_fence)
+        CHK(glDeleteSync((GLsync) m_fence));
+    if (m_mapped) {
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer));
+        CHK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    }
+    CHK(glDeleteBuffers(1, &m_buffer));
+#endif
+}
+
+void TextureDownload::start() {
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (m_fence) {
+        CHK(glDeleteSync((GLsync) m_fence));
+        m_fence = nullptr;
+    }
+
+    if (!m_buffer)
+        CHK(glGenBuffers(1, &m_buffer));
+    CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer));
+
+    if (m_mapped) {
+        CHK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        m_mapped = nullptr;
+    }
+
+    m_size = m_texture->size();
+    size_t size = m_texture->bytes_per_pixel() * (size_t) m_size.x() * (size_t) m_size.y();
+    if (size != m_buffer_size) {
+        CHK(glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_READ));
+        m_buffer_size = size;
+    }
+
+    Texture::PixelFormat pixel_format = m_texture->pixel_format();
+    Texture::ComponentFormat component_format = m_texture->component_format();
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(pixel_format,
+                          component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+    (void) internal_format_gl;
+
+    /* With a pack buffer bound, the 'data' argument is an offset and the
+       copy happens asynchronously */
+    CHK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+#if defined(NANOGUI_USE_OPENGL)
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture->texture_handle());
+    CHK(glGetTexImage(GL_TEXTURE_2D, 0, pixel_format_gl, component_format_gl, nullptr));
+#else
+    /* GLES lacks glGetTexImage(): read from a temporary framebuffer */
+    GLState &state = GLState::current();
+    uint32_t framebuffer_prev = state.framebuffer();
+    GLuint framebuffer = 0;
+    CHK(glGenFramebuffers(1, &framebuffer));
+    state.bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+    CHK(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                               m_texture->texture_handle(), 0));
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status == GL_FRAMEBUFFER_COMPLETE)
+        CHK(glReadPixels(0, 0, (GLsizei) m_size.x(), (GLsizei) m_size.y(),
+                         pixel_format_gl, component_format_gl, nullptr));
+    state.bind_framebuffer(GL_FRAMEBUFFER, framebuffer_prev);
+    state.framebuffer_deleted(framebuffer);
+    CHK(glDeleteFramebuffers(1, &framebuffer));
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        throw std::runtime_error("TextureDownload::start(): the texture format "
+                                 "is not color-renderable on this device!");
+    }
+#endif
+    CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    m_fence = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    CHK(glFlush());
+    m_started = true;
+#endif
+}
+
+bool TextureDownload::ready() {
+    if (!m_started)
+        throw std::runtime_error("TextureDownload::ready(): start() was not called!");
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (m_fence) {
+        if (glClientWaitSync((GLsync) m_fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            return false;
+        CHK(glDeleteSync((GLsync) m_fence));
+        m_fence = nullptr;
+    }
+#endif
+    return true;
+}
+
+void TextureDownload::wait() {
+    if (!m_started)
+        throw std::runtime_error("TextureDownload::wait(): start() was not called!");
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (m_fence) {
+        while (glClientWaitSync((GLsync) m_fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                1000000000ull) == GL_TIMEOUT_EXPIRED)
+            ;
+        CHK(glDeleteSync((GLsync) m_fence));
+        m_fence = nullptr;
+    }
+#endif
+}
+
+const uint8_t *TextureDownload::data() {
+    wait();
+#if defined(NANOGUI_USE_OPENGL) || NANOGUI_GLES_VERSION >= 3
+    if (!m_mapped) {
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer));
+        m_mapped = (uint8_t *) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                (GLsizeiptr) m_buffer_size,
+                                                GL_MAP_READ_BIT);
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        if (!m_mapped)
+            throw std::runtime_error("TextureDownload::data(): could not map pixel pack buffer!");
+    }
+#endif
+    if (!m_flipped || m_size.y() == 0)
+        return m_mapped;
+    return m_mapped + (size_t) (m_size.y() - 1) * (size_t) -row_stride();
 }
 
 static void gl_map_texture_format(Texture::PixelFormat &pixel_format,
@@ -43,11 +43,17 @@ void Texture::init() {
 }
 
 Texture::~Texture() {
+    untrack_memory();
     (void) (__bridge_transfer id<MTLTexture>) m_texture_handle;
     (void) (__bridge_transfer id<MTLSamplerState>) m_sampler_state_handle;
 }
 
 void Texture::upload(const uint8_t *data) {
+    if (m_compression != Compression::None)
+        throw std::runtime_error("Texture::upload(): use upload_compressed() for compressed textures!");
+    else if (m_evicted)
+        make_resident();
+
     id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
 
     MTLTextureDescriptor *texture_desc =
@@ -86,48 +92,183 @@ void Texture::upload(const uint8_t *data) {
     [command_buffer waitUntilCompleted];
 }
 
-void Texture::download(uint8_t *data) {
-    id<MTLCommandQueue> command_queue =
-        (__bridge id<MTLCommandQueue>) metal_command_queue();
+void Texture::upload_sub_region(const uint8_t *data, const Vector2i &origin,
+                                const Vector2i &size, size_t row_stride) {
+    if (m_compression != Compression::None)
+        throw std::runtime_error("Texture::upload_sub_region(): not supported for compressed textures!");
+    if (origin.x() < 0 || origin.y() < 0 || size.x() < 0 || size.y() < 0 ||
+        origin.x() + size.x() > m_size.x() || origin.y() + size.y() > m_size.y())
+        throw std::runtime_error("Texture::upload_sub_region(): region is out of bounds!");
+    else if (row_stride != 0 && row_stride < (size_t) size.x())
+        throw std::runtime_error("Texture::upload_sub_region(): row stride is too small!");
+    else if (m_evicted)
+        make_resident();
+    if (size.x() == 0 || size.y() == 0)
+        return;
+
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+
+    MTLTextureDescriptor *texture_desc =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: texture.pixelFormat
+                                                           width: (NSUInteger) size.x()
+                                                          height: (NSUInteger) size.y()
+                                                       mipmapped: NO];
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
     id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
-    id<MTLBlitCommandEncoder> command_encoder =
-        [command_buffer blitCommandEncoder];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> temp_texture = [device newTextureWithDescriptor:texture_desc];
+
+    [temp_texture replaceRegion: MTLRegionMake2D(0, 0, (NSUInteger) size.x(), (NSUInteger) size.y())
+                  mipmapLevel: 0
+                  withBytes: data
+                  bytesPerRow: (NSUInteger) (bytes_per_pixel() *
+                                             (row_stride ? row_stride : (size_t) size.x()))];
+
+    [command_encoder
+                 copyFromTexture: temp_texture
+                     sourceSlice: 0
+                     sourceLevel: 0
+                    sourceOrigin: MTLOriginMake(0, 0, 0)
+                      sourceSize: MTLSizeMake((NSUInteger) size.x(), (NSUInteger) size.y(), 1)
+                       toTexture: texture
+                destinationSlice: 0
+                destinationLevel: 0
+               destinationOrigin: MTLOriginMake((NSUInteger) origin.x(), (NSUInteger) origin.y(), 0)];
+
+    if (m_min_interpolation_mode == InterpolationMode::Trilinear)
+        [command_encoder generateMipmapsForTexture: texture];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    [command_buffer waitUntilCompleted];
+}
 
-    size_t row_bytes = bytes_per_pixel() * m_size.x(),
-           img_bytes = row_bytes * m_size.y();
+static MTLPixelFormat metal_compressed_format(Texture::Compression compression) {
+    using Compression = Texture::Compression;
+    switch (compression) {
+#if TARGET_OS_OSX
+        case Compression::BC1: return MTLPixelFormatBC1_RGBA;
+        case Compression::BC3: return MTLPixelFormatBC3_RGBA;
+        case Compression::BC4: return MTLPixelFormatBC4_RUnorm;
+        case Compression::BC5: return MTLPixelFormatBC5_RGUnorm;
+        case Compression::BC7: return MTLPixelFormatBC7_RGBAUnorm;
+#endif
+        case Compression::ETC2_RGB:
+            if (@available(macOS 11.0, *))
+                return MTLPixelFormatETC2_RGB8;
+            break;
+        case Compression::ETC2_RGBA:
+            if (@available(macOS 11.0, *))
+                return MTLPixelFormatEAC_RGBA8;
+            break;
+        default:
+            break;
+    }
+    throw std::runtime_error("Texture: compression scheme is not supported by Metal!");
+}
 
+bool Texture::compression_supported(Compression compression) {
     id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    switch (compression) {
+        case Compression::BC1:
+        case Compression::BC3:
+        case Compression::BC4:
+        case Compression::BC5:
+        case Compression::BC7:
+#if TARGET_OS_OSX
+            return true;
+#else
+            return false;
+#endif
+        case Compression::ETC2_RGB:
+        case Compression::ETC2_RGBA:
+            if (@available(macOS 11.0, iOS 13.0, *))
+                return [device supportsFamily: MTLGPUFamilyApple1];
+            return false;
+        default:
+            return false;
+    }
+}
+
+void Texture::upload_compressed(const uint8_t *data, size_t size, uint32_t level) {
+    if (m_compression == Compression::None)
+        throw std::runtime_error("Texture::upload_compressed(): texture is not compressed!");
+    else if (level >= m_mip_levels)
+        throw std::runtime_error("Texture::upload_compressed(): invalid MIP level!");
+    else if (size != compressed_size(level))
+        throw std::runtime_error("Texture::upload_compressed(): data size does not "
+                                 "match the MIP level!");
+    else if (m_evicted)
+        make_resident();
+
     id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
-    id<MTLBuffer> buffer =
-        [device newBufferWithLength: img_bytes
-                            options: MTLResourceStorageModeShared];
+    NSUInteger width  = (NSUInteger) std::max(m_size.x() >> level, 1),
+               height = (NSUInteger) std::max(m_size.y() >> level, 1);
+
+    MTLTextureDescriptor *texture_desc =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: texture.pixelFormat
+                                                           width: width
+                                                          height: height
+                                                       mipmapped: NO];
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> temp_texture = [device newTextureWithDescriptor:texture_desc];
+
+    /* Rows of 4x4 blocks */
+    [temp_texture replaceRegion: MTLRegionMake2D(0, 0, width, height)
+                  mipmapLevel: 0
+                  withBytes: data
+                  bytesPerRow: (NSUInteger) (size / ((height + 3) / 4))];
 
     [command_encoder
-                 copyFromTexture: texture
+                 copyFromTexture: temp_texture
                      sourceSlice: 0
                      sourceLevel: 0
                     sourceOrigin: MTLOriginMake(0, 0, 0)
-                      sourceSize: MTLSizeMake(texture.width, texture.height, 1)
-                        toBuffer: buffer
-               destinationOffset: 0
-          destinationBytesPerRow: row_bytes
-        destinationBytesPerImage: img_bytes];
+                      sourceSize: MTLSizeMake(width, height, 1)
+                       toTexture: texture
+                destinationSlice: 0
+                destinationLevel: level
+               destinationOrigin: MTLOriginMake(0, 0, 0)];
 
     [command_encoder endEncoding];
     [command_buffer commit];
     [command_buffer waitUntilCompleted];
-    memcpy(data, buffer.contents, img_bytes);
 }
 
 void Texture::resize(const Vector2i &size) {
     if (m_size == size)
         return;
+    else if (m_compression != Compression::None && m_texture_handle)
+        throw std::runtime_error("Texture::resize(): not supported for compressed textures!");
     m_size = size;
+    m_evicted = false;
     if (m_texture_handle) {
         (void) (__bridge_transfer id<MTLTexture>) m_texture_handle;
         m_texture_handle = nullptr;
     }
 
+    if (m_compression != Compression::None) {
+        id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+        MTLTextureDescriptor *texture_desc =
+            [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: metal_compressed_format(m_compression)
+                                                               width: (NSUInteger) m_size.x()
+                                                              height: (NSUInteger) m_size.y()
+                                                           mipmapped: NO];
+        texture_desc.mipmapLevelCount = m_mip_levels;
+        texture_desc.storageMode = MTLStorageModePrivate;
+        texture_desc.usage = MTLTextureUsageShaderRead;
+        id<MTLTexture> texture = [device newTextureWithDescriptor:texture_desc];
+        m_texture_handle = (__bridge_retained void *) texture;
+        track_memory();
+        return;
+    }
+
     if (m_component_format == ComponentFormat::UInt32)
         m_component_format = ComponentFormat::UInt16;
     else if (m_component_format == ComponentFormat::Int32)
@@ -260,6 +401,168 @@ void Texture::resize(const Vector2i &size) {
 
     id<MTLTexture> texture = [device newTextureWithDescriptor:texture_desc];
     m_texture_handle = (__bridge_retained void *) texture;
+    track_memory();
+}
+
+void Texture::release_storage() {
+    /* Discard the contents, which frees the storage while keeping the
+       handle (that shaders refer to) valid */
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+    [texture setPurgeableState: MTLPurgeableStateEmpty];
+}
+
+void Texture::restore_storage() {
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+    [texture setPurgeableState: MTLPurgeableStateNonVolatile];
+}
+
+void TextureStream::init() {
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    for (Slot &slot : m_slots) {
+        id<MTLBuffer> buffer =
+            [device newBufferWithLength: m_frame_size
+                                options: MTLResourceStorageModeShared];
+        slot.buffer = (__bridge_retained void *) buffer;
+        slot.data = (uint8_t *) buffer.contents;
+    }
+}
+
+TextureStream::~TextureStream() {
+    for (Slot &slot : m_slots) {
+        if (slot.command_buffer) {
+            id<MTLCommandBuffer> command_buffer =
+                (__bridge_transfer id<MTLCommandBuffer>) slot.command_buffer;
+            [command_buffer waitUntilCompleted];
+        }
+        (void) (__bridge_transfer id<MTLBuffer>) slot.buffer;
+    }
+}
+
+void TextureStream::upload(size_t index) {
+    Slot &slot = m_slots[index];
+    Vector2i size = m_texture->size();
+    size_t row_bytes = m_texture->bytes_per_pixel() * (size_t) size.x();
+
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture->texture_handle();
+
+    [command_encoder
+                  copyFromBuffer: (__bridge id<MTLBuffer>) slot.buffer
+                    sourceOffset: 0
+               sourceBytesPerRow: row_bytes
+             sourceBytesPerImage: m_frame_size
+                      sourceSize: MTLSizeMake((NSUInteger) size.x(), (NSUInteger) size.y(), 1)
+                       toTexture: texture
+                destinationSlice: 0
+                destinationLevel: 0
+               destinationOrigin: MTLOriginMake(0, 0, 0)];
+
+    if (m_texture->min_interpolation_mode() == Texture::InterpolationMode::Trilinear)
+        [command_encoder generateMipmapsForTexture: texture];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    slot.command_buffer = (__bridge_retained void *) command_buffer;
+}
+
+bool TextureStream::recycle(size_t index) {
+    Slot &slot = m_slots[index];
+    if (slot.command_buffer) {
+        id<MTLCommandBuffer> command_buffer =
+            (__bridge id<MTLCommandBuffer>) slot.command_buffer;
+        if (command_buffer.status < MTLCommandBufferStatusCompleted)
+            return false;
+        (void) (__bridge_transfer id<MTLCommandBuffer>) slot.command_buffer;
+        slot.command_buffer = nullptr;
+    }
+    return true;
+}
+
+TextureDownload::~TextureDownload() {
+    if (m_command_buffer) {
+        id<MTLCommandBuffer> command_buffer =
+            (__bridge_transfer id<MTLCommandBuffer>) m_command_buffer;
+        [command_buffer waitUntilCompleted];
+    }
+    (void) (__bridge_transfer id<MTLBuffer>) m_buffer;
+}
+
+void TextureDownload::start() {
+    if (m_command_buffer) {
+        id<MTLCommandBuffer> command_buffer =
+            (__bridge_transfer id<MTLCommandBuffer>) m_command_buffer;
+        [command_buffer waitUntilCompleted];
+        m_command_buffer = nullptr;
+    }
+
+    m_size = m_texture->size();
+    size_t row_bytes = m_texture->bytes_per_pixel() * (size_t) m_size.x(),
+           img_bytes = row_bytes * (size_t) m_size.y();
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    if (img_bytes != m_buffer_size) {
+        (void) (__bridge_transfer id<MTLBuffer>) m_buffer;
+        id<MTLBuffer> buffer =
+            [device newBufferWithLength: img_bytes
+                                options: MTLResourceStorageModeShared];
+        m_buffer = (__bridge_retained void *) buffer;
+        m_buffer_size = img_bytes;
+    }
+
+    id<MTLCommandQueue> command_queue =
+        (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder =
+        [command_buffer blitCommandEncoder];
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture->texture_handle();
+
+    [command_encoder
+                 copyFromTexture: texture
+                     sourceSlice: 0
+                     sourceLevel: 0
+                    sourceOrigin: MTLOriginMake(0, 0, 0)
+                      sourceSize: MTLSizeMake(texture.width, texture.height, 1)
+                        toBuffer: (__bridge id<MTLBuffer>) m_buffer
+               destinationOffset: 0
+          destinationBytesPerRow: row_bytes
+        destinationBytesPerImage: img_bytes];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    m_command_buffer = (__bridge_retained void *) command_buffer;
+    m_started = true;
+}
+
+bool TextureDownload::ready() {
+    if (!m_started)
+        throw std::runtime_error("TextureDownload::ready(): start() was not called!");
+    if (m_command_buffer) {
+        id<MTLCommandBuffer> command_buffer =
+            (__bridge id<MTLCommandBuffer>) m_command_buffer;
+        if (command_buffer.status < MTLCommandBufferStatusCompleted)
+            return false;
+        (void) (__bridge_transfer id<MTLCommandBuffer>) m_command_buffer;
+        m_command_buffer = nullptr;
+    }
+    return true;
+}
+
+void TextureDownload::wait() {
+    if (!m_started)
+        throw std::runtime_error("TextureDownload::wait(): start() was not called!");
+    if (m_command_buffer) {
+        id<MTLCommandBuffer> command_buffer =
+            (__bridge_transfer id<MTLCommandBuffer>) m_command_buffer;
+        [command_buffer waitUntilCompleted];
+        m_command_buffer = nullptr;
+    }
+}
+
+const uint8_t *TextureDownload::data() {
+    wait();
+    return (const uint8_t *) ((__bridge id<MTLBuffer>) m_buffer).contents;
 }
 
 NAMESPACE_END(nanogui)
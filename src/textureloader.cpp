@@ -0,0 +1,241 @@
+/*
+    src/textureloader.cpp -- Asynchronous loading of textures and
+    NanoVG images on worker threads
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textureloader.h>
+#include <nanogui/screen.h>
+#include <nanogui/opengl.h>
+#include <nanogui/glstate.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+NAMESPACE_BEGIN(nanogui)
+
+void AsyncTexture::set_callback(const std::function<void(AsyncTexture *)> &callback) {
+    m_callback = callback;
+    if (m_state != State::Pending && m_callback)
+        m_callback(this);
+}
+
+TextureLoader::TextureLoader(Screen *screen, size_t thread_count, double upload_budget)
+    : m_screen(screen), m_upload_budget(upload_budget) {
+    const uint8_t transparent[4] = { 0, 0, 0, 0 };
+    m_placeholder = new Texture(Texture::PixelFormat::RGBA, Texture::ComponentFormat::UInt8,
+                                Vector2i(1), InterpolationMode::Nearest,
+                                InterpolationMode::Nearest);
+    m_placeholder->set_owner("TextureLoader");
+    m_placeholder->upload(transparent);
+
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    m_workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+        m_workers.emplace_back([this]() { worker(); });
+}
+
+TextureLoader::~TextureLoader() {
+    shutdown();
+}
+
+void TextureLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (std::thread &worker : m_workers)
+        worker.join();
+    m_workers.clear();
+    m_queue.clear();
+    m_decoded.clear();
+}
+
+ref<AsyncTexture> TextureLoader::load(const std::string &filename,
+                                      InterpolationMode min_interpolation_mode,
+                                      InterpolationMode mag_interpolation_mode,
+                                      WrapMode wrap_mode) {
+    ref<AsyncTexture> handle = new AsyncTexture(filename, m_placeholder);
+    handle->m_min_interpolation_mode = min_interpolation_mode;
+    handle->m_mag_interpolation_mode = mag_interpolation_mode;
+    handle->m_wrap_mode = wrap_mode;
+    enqueue(handle);
+    return handle;
+}
+
+ref<AsyncTexture> TextureLoader::load_nvg_image(NVGcontext *ctx, const std::string &filename,
+                                                int image_flags) {
+    ref<AsyncTexture> handle = new AsyncTexture(filename, nullptr);
+    handle->m_nvg_context = ctx;
+    handle->m_nvg_image_flags = image_flags;
+    enqueue(handle);
+    return handle;
+}
+
+std::vector<std::pair<ref<AsyncTexture>, std::string>>
+TextureLoader::load_image_directory(NVGcontext *ctx, const std::string &path) {
+    std::vector<std::pair<ref<AsyncTexture>, std::string>> result;
+    for (const std::string &full_name : image_directory_files(path))
+        result.emplace_back(load_nvg_image(ctx, full_name),
+                            full_name.substr(0, full_name.length() - 4));
+    return result;
+}
+
+void TextureLoader::enqueue(AsyncTexture *handle) {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_stop)
+            throw std::runtime_error("TextureLoader: the loader was shut down!");
+        Job job;
+        job.handle = handle;
+        m_queue.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+size_t TextureLoader::pending_count() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_queue.size() + m_in_progress + m_decoded.size();
+}
+
+void TextureLoader::worker() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_stop)
+                return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_in_progress++;
+        }
+
+        AsyncTexture *handle = job.handle.get();
+        bool nvg = handle->m_nvg_context != nullptr;
+
+        /* Skip images whose handle was released in the meantime */
+        if (handle->ref_count() > 1) {
+            std::ifstream is(handle->m_filename, std::ios::binary | std::ios::ate);
+            std::vector<uint8_t> data;
+            if (is) {
+                data.resize((size_t) is.tellg());
+                is.seekg(0, std::ios::beg);
+                if (!is.read((char *) data.data(), (std::streamsize) data.size()))
+                    data.clear();
+            }
+
+            if (data.empty()) {
+                job.error = "could not read file";
+            } else if (Texture::is_ktx(data.data(), data.size())) {
+                if (nvg)
+                    job.error = "KTX containers cannot be used as NanoVG images";
+                else
+                    job.ktx = std::move(data);
+            } else {
+                job.pixels = decltype(job.pixels)(
+                    stbi_load_from_memory(data.data(), (int) data.size(), &job.size.x(),
+                                          &job.size.y(), &job.channels, nvg ? 4 : 0),
+                    stbi_image_free);
+                if (!job.pixels)
+                    job.error = stbi_failure_reason();
+                else if (nvg)
+                    job.channels = 4;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_decoded.push_back(std::move(job));
+            m_in_progress--;
+        }
+
+        Screen::redraw_async(m_screen);
+    }
+}
+
+bool TextureLoader::update() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    bool finished = false;
+
+    while (true) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if (m_decoded.empty())
+                break;
+            job = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+
+        AsyncTexture *handle = job.handle.get();
+        if (handle->ref_count() == 1)
+            continue;
+
+        if (job.error.empty()) {
+            try {
+                if (handle->m_nvg_context) {
+                    handle->m_nvg_image = nvgCreateImageRGBA(
+                        handle->m_nvg_context, job.size.x(), job.size.y(),
+                        handle->m_nvg_image_flags, job.pixels.get());
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+                    /* NanoVG binds the image on the active texture unit */
+                    GLState::current().invalidate_textures();
+#endif
+                    if (handle->m_nvg_image == 0)
+                        job.error = "could not create NanoVG image";
+                } else {
+                    ref<Texture> texture = new Texture(handle->m_min_interpolation_mode,
+                                                       handle->m_mag_interpolation_mode,
+                                                       handle->m_wrap_mode);
+                    texture->set_owner("TextureLoader");
+                    if (!job.ktx.empty())
+                        texture->load_ktx(handle->m_filename, job.ktx);
+                    else
+                        texture->load_image(handle->m_filename, job.pixels.get(),
+                                            job.size, job.channels);
+                    handle->m_texture = texture;
+                }
+            } catch (const std::exception &e) {
+                job.error = e.what();
+            }
+        }
+
+        if (job.error.empty()) {
+            handle->m_state = AsyncTexture::State::Ready;
+        } else {
+            handle->m_state = AsyncTexture::State::Failed;
+            handle->m_error = "Could not load \"" + handle->m_filename + "\": " + job.error;
+        }
+
+        if (handle->m_callback)
+            handle->m_callback(handle);
+        finished = true;
+
+        if (std::chrono::duration<double, std::milli>(Clock::now() - start).count() >=
+            m_upload_budget)
+            break;
+    }
+
+    /* Continue at the next frame if the budget was exhausted */
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_decoded.empty() && m_screen)
+            m_screen->redraw();
+    }
+
+    return finished;
+}
+
+NAMESPACE_END(nanogui)
@@ -14,7 +14,7 @@
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/icons.h>
-#include <nanogui_resources.h>
+#include <nanogui/resources.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -78,14 +78,17 @@ Theme::Theme(NVGcontext *ctx) {
     m_text_box_up_icon                  = FA_CHEVRON_UP;
     m_text_box_down_icon                = FA_CHEVRON_DOWN;
 
-    m_font_sans_regular = nvgCreateFontMem(ctx, "sans", (uint8_t *) roboto_regular_ttf,
-                                           roboto_regular_ttf_size, 0);
-    m_font_sans_bold = nvgCreateFontMem(ctx, "sans-bold", (uint8_t *) roboto_bold_ttf,
-                                        roboto_bold_ttf_size, 0);
-    m_font_icons = nvgCreateFontMem(ctx, "icons", (uint8_t *) fontawesome_solid_ttf,
-                                    fontawesome_solid_ttf_size, 0);
-    m_font_mono_regular = nvgCreateFontMem(ctx, "mono", (uint8_t *) inconsolata_regular_ttf,
-                                           inconsolata_regular_ttf_size, 0);
+    /* Font data is owned by the resource bundle (and lives until shutdown) */
+    auto create_font = [ctx](const char *name, const char *filename) {
+        std::string_view data = resource(filename);
+        return nvgCreateFontMem(ctx, name, (uint8_t *) data.data(),
+                                (int) data.size(), 0);
+    };
+
+    m_font_sans_regular = create_font("sans", "Roboto-Regular.ttf");
+    m_font_sans_bold = create_font("sans-bold", "Roboto-Bold.ttf");
+    m_font_icons = create_font("icons", "FontAwesome-Solid.ttf");
+    m_font_mono_regular = create_font("mono", "Inconsolata-Regular.ttf");
 
     if (m_font_sans_regular == -1 || m_font_sans_bold == -1 ||
         m_font_icons == -1 || m_font_mono_regular == -1)
@@ -0,0 +1,252 @@
+/*
+    src/tilecache.cpp -- Multi-resolution tiled images that are decoded
+    on demand by worker threads and cached on the GPU
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tilecache.h>
+#include <nanogui/screen.h>
+#include <algorithm>
+#include <cstdio>
+
+NAMESPACE_BEGIN(nanogui)
+
+TileSource::TileSource(const Vector2i &size, uint32_t tile_size,
+                       PixelFormat pixel_format, ComponentFormat component_format)
+    : m_size(size), m_tile_size(tile_size), m_pixel_format(pixel_format),
+      m_component_format(component_format) {
+    if (size.x() <= 0 || size.y() <= 0)
+        throw std::runtime_error("TileSource::TileSource(): invalid image size!");
+    else if (tile_size == 0)
+        throw std::runtime_error("TileSource::TileSource(): invalid tile size!");
+    else if (pixel_format == PixelFormat::Depth || pixel_format == PixelFormat::DepthStencil)
+        throw std::runtime_error("TileSource::TileSource(): unsupported pixel format!");
+
+    m_level_count = 1;
+    while (level_size(m_level_count - 1).x() > (int) tile_size ||
+           level_size(m_level_count - 1).y() > (int) tile_size)
+        m_level_count++;
+}
+
+size_t TileSource::channels() const {
+    switch (m_pixel_format) {
+        case PixelFormat::R:    return 1;
+        case PixelFormat::RA:   return 2;
+        case PixelFormat::RGB:  return 3;
+        case PixelFormat::RGBA: return 4;
+        case PixelFormat::BGR:  return 3;
+        case PixelFormat::BGRA: return 4;
+        default: throw std::runtime_error("TileSource::channels(): invalid "
+                                          "pixel format!");
+    }
+}
+
+size_t TileSource::bytes_per_pixel() const {
+    size_t result = 0;
+    switch (m_component_format) {
+        case ComponentFormat::UInt8:   result = 1; break;
+        case ComponentFormat::Int8:    result = 1; break;
+        case ComponentFormat::UInt16:  result = 2; break;
+        case ComponentFormat::Int16:   result = 2; break;
+        case ComponentFormat::UInt32:  result = 4; break;
+        case ComponentFormat::Int32:   result = 4; break;
+        case ComponentFormat::Float16: result = 2; break;
+        case ComponentFormat::Float32: result = 4; break;
+        default: throw std::runtime_error("TileSource::bytes_per_pixel(): "
+                                          "invalid component format!");
+    }
+    return result * channels();
+}
+
+TileCache::TileCache(TileSource *source, size_t memory_budget, size_t thread_count)
+    : m_source(source), m_memory_budget(memory_budget) {
+    if (!source)
+        throw std::runtime_error("TileCache::TileCache(): tile source is missing!");
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    m_workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+        m_workers.emplace_back([this]() { worker(); });
+}
+
+TileCache::~TileCache() {
+    shutdown();
+}
+
+void TileCache::shutdown() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stop = true;
+        for (const Request &request : m_queue)
+            m_pending.erase(request.key);
+        m_queue.clear();
+    }
+    m_cv.notify_all();
+    for (std::thread &worker : m_workers)
+        worker.join();
+    m_workers.clear();
+}
+
+void TileCache::worker() {
+    size_t bytes_per_pixel = m_source->bytes_per_pixel();
+
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_stop)
+                return;
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        Vector2i extent = m_source->tile_extent(request.level, request.index);
+        Decoded decoded;
+        decoded.request = request;
+        decoded.data.reset(new uint8_t[(size_t) extent.x() * (size_t) extent.y() * bytes_per_pixel]);
+
+        bool success = true;
+        try {
+            m_source->load_tile(request.level, request.index, decoded.data.get());
+        } catch (const std::exception &e) {
+            fprintf(stderr, "TileCache: could not load tile (level %u, index %i, %i): %s\n",
+                    request.level, request.index.x(), request.index.y(), e.what());
+            success = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if (success) {
+                m_decoded.push_back(std::move(decoded));
+            } else {
+                /* Don't decode (and report) the tile again at every frame */
+                m_pending.erase(request.key);
+                m_failed.insert(request.key);
+            }
+        }
+
+        if (success && m_armed.load(std::memory_order_relaxed) &&
+            m_armed.exchange(false, std::memory_order_acq_rel)) {
+            Screen::redraw_async(m_screen.load(std::memory_order_relaxed));
+        }
+    }
+}
+
+size_t TileCache::pending_count() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_pending.size();
+}
+
+Texture *TileCache::tile(uint32_t level, const Vector2i &index) {
+    auto it = m_tiles.find(key(level, index));
+    if (it == m_tiles.end())
+        return nullptr;
+    Tile &tile = it->second;
+    m_lru.splice(m_lru.begin(), m_lru, tile.lru);
+    tile.frame = m_frame;
+    return tile.texture.get();
+}
+
+void TileCache::request(uint32_t level, const Vector2i &index) {
+    uint64_t k = key(level, index);
+    if (m_tiles.find(k) != m_tiles.end())
+        return;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_stop || m_failed.count(k) || !m_pending.insert(k).second)
+            return;
+        m_queue.push_back(Request{ k, level, index });
+    }
+    m_cv.notify_one();
+}
+
+size_t TileCache::failed_count() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_failed.size();
+}
+
+void TileCache::clear_failures() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_failed.clear();
+}
+
+void TileCache::clear_requests() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (const Request &request : m_queue)
+        m_pending.erase(request.key);
+    m_queue.clear();
+}
+
+void TileCache::request_notification(Screen *screen) {
+    m_screen.store(screen, std::memory_order_relaxed);
+    m_armed.store(screen != nullptr, std::memory_order_release);
+}
+
+bool TileCache::update() {
+    std::vector<Decoded> decoded;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    /* Tiles used since the previous call are protected from eviction */
+    size_t protect = m_frame++;
+    size_t bytes_per_pixel = m_source->bytes_per_pixel();
+
+    for (Decoded &d : decoded) {
+        Vector2i extent = m_source->tile_extent(d.request.level, d.request.index);
+        size_t bytes = (size_t) extent.x() * (size_t) extent.y() * bytes_per_pixel;
+
+        /* Evict least recently used tiles, keeping a texture of the same
+           size for reuse (this avoids a reallocation) */
+        ref<Texture> texture;
+        while (m_memory_usage + (texture ? 0 : bytes) > m_memory_budget && !m_lru.empty()) {
+            auto it = m_tiles.find(m_lru.back());
+            if (it->second.frame >= protect)
+                break;
+            Texture *evicted = it->second.texture.get();
+            if (!texture && evicted->size() == extent)
+                texture = evicted;
+            else
+                m_memory_usage -= evicted->bytes_per_pixel() *
+                                  (size_t) evicted->size().x() * (size_t) evicted->size().y();
+            m_tiles.erase(it);
+            m_lru.pop_back();
+        }
+
+        if (!texture) {
+            texture = new Texture(m_source->pixel_format(), m_source->component_format(),
+                                  extent, Texture::InterpolationMode::Bilinear,
+                                  Texture::InterpolationMode::Nearest);
+            texture->set_owner("TileCache");
+            if (texture->pixel_format() != m_source->pixel_format() ||
+                texture->component_format() != m_source->component_format())
+                throw std::runtime_error("TileCache::update(): pixel format of the tile "
+                                         "source is not supported by the hardware!");
+            m_memory_usage += bytes;
+        }
+
+        texture->upload(d.data.get());
+
+        m_lru.push_front(d.request.key);
+        m_tiles[d.request.key] = Tile{ texture, m_lru.begin(), m_frame };
+    }
+
+    if (!decoded.empty()) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (const Decoded &d : decoded)
+            m_pending.erase(d.request.key);
+    }
+
+    return !decoded.empty();
+}
+
+NAMESPACE_END(nanogui)